@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+
+# Copyright © 2019-2023
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import sys
+import argparse
+import csv
+import struct
+
+# must match sim/simx/itrace.h
+ITRACE_MAGIC   = 0x54495856
+ITRACE_VERSION = 1
+HEADER_FORMAT  = '<IHHHHI'
+RECORD_FORMAT  = '<QQQQIHBB'
+
+KIND_INSTR = 0
+KIND_LOAD  = 1
+KIND_STORE = 2
+
+def parse_args():
+    parser = argparse.ArgumentParser(description='SimX binary instruction trace decoder.')
+    parser.add_argument('-o', '--csv', default=None, help='Output CSV file (default: text to stdout)')
+    parser.add_argument('-s', '--sort', action='store_true', help='Sort instructions by UUID')
+    parser.add_argument('trace', help='Binary trace file (VORTEX_ITRACE)')
+    return parser.parse_args()
+
+def read_trace(path):
+    with open(path, 'rb') as f:
+        header_size = struct.calcsize(HEADER_FORMAT)
+        magic, version, record_size, xlen, num_threads, _ = struct.unpack(HEADER_FORMAT, f.read(header_size))
+        if magic != ITRACE_MAGIC:
+            sys.exit("Error: invalid trace file: " + path)
+        if version != ITRACE_VERSION or record_size != struct.calcsize(RECORD_FORMAT):
+            sys.exit("Error: unsupported trace version {} (record size {})".format(version, record_size))
+        instrs = []
+        while True:
+            data = f.read(record_size)
+            if len(data) < record_size:
+                break
+            uuid, cycle, addr, tmask, code, cid, wid, kind = struct.unpack(RECORD_FORMAT, data)
+            if kind == KIND_INSTR:
+                instrs.append({
+                    'uuid': uuid, 'cycle': cycle, 'cid': cid, 'wid': wid,
+                    'PC': addr, 'tmask': tmask, 'code': code, 'mem': []
+                })
+            elif instrs:
+                # memory records follow their instruction
+                instrs[-1]['mem'].append((kind, tmask, addr, code))
+        return xlen, num_threads, instrs
+
+def format_tmask(tmask, num_threads):
+    return ''.join(str((tmask >> t) & 1) for t in range(num_threads))
+
+def format_mem(mem):
+    items = []
+    for kind, tid, addr, size in mem:
+        items.append("{}{}:0x{:x}/{}".format('S' if kind == KIND_STORE else 'L', tid, addr, size))
+    return ' '.join(items)
+
+def main():
+    args = parse_args()
+    xlen, num_threads, instrs = read_trace(args.trace)
+    if args.sort:
+        instrs.sort(key=lambda instr: instr['uuid'])
+    if args.csv:
+        with open(args.csv, 'w', newline='') as f:
+            writer = csv.writer(f)
+            writer.writerow(['uuid', 'cycle', 'cid', 'wid', 'PC', 'tmask', 'code', 'mem'])
+            for instr in instrs:
+                writer.writerow([instr['uuid'], instr['cycle'], instr['cid'], instr['wid'],
+                                 "0x{:x}".format(instr['PC']),
+                                 format_tmask(instr['tmask'], num_threads),
+                                 "0x{:08x}".format(instr['code']),
+                                 format_mem(instr['mem'])])
+    else:
+        for instr in instrs:
+            line = "#{} cycle={} cid={} wid={} PC=0x{:x} tmask={} code=0x{:08x}".format(
+                instr['uuid'], instr['cycle'], instr['cid'], instr['wid'], instr['PC'],
+                format_tmask(instr['tmask'], num_threads), instr['code'])
+            if instr['mem']:
+                line += " mem={" + format_mem(instr['mem']) + "}"
+            print(line)
+
+if __name__ == "__main__":
+    main()
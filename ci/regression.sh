@@ -103,6 +103,23 @@ regression()
     ./ci/blackbox.sh --driver=opae --app=dogfood --args="-n1 -tbar"
     ./ci/blackbox.sh --driver=xrt --app=dogfood --args="-n1 -tbar"
 
+    # test DMA chains, completion groups and barrier signals
+    ./ci/blackbox.sh --driver=simx --app=dma_chain --warps=4
+
+    # test the DMA stage pipeline, unbuffered and double-buffered
+    ./ci/blackbox.sh --driver=simx --app=sgemm_dma_pipe --args="-s1"
+    ./ci/blackbox.sh --driver=simx --app=sgemm_dma_pipe --args="-s2"
+
+    # test memory trace record and replay: replay must issue every recorded request
+    VORTEX_MEMTRACE=$PWD/sgemm.memtrace ./ci/blackbox.sh --driver=simx --app=sgemm
+    make -C sim/simx > /dev/null
+    ./sim/simx/simx -r sgemm.memtrace > run_replay.log
+    grep -q "PERF: replay requests=[1-9]" run_replay.log
+
+    # test DMA multicast within a socket
+    ./ci/blackbox.sh --driver=simx --app=dma_mcast --cores=2 --perf=1
+    CONFIGS="-DSOCKET_SIZE=2" ./ci/blackbox.sh --driver=simx --app=dma_mcast --cores=4 --perf=1 --args="-s2"
+
     # test temp driver mode for
     ./ci/blackbox.sh --driver=simx --app=vecadd --nohup
 
@@ -422,6 +439,10 @@ vector()
     CONFIGS="-DVLEN=256 -DEXT_V_ENABLE" make -C sim/simx
     VLEN=256 ./tests/riscv/riscv-vector-tests/run-test.sh
 
+    # dual-issue warps through the vector operand collectors
+    CONFIGS="-DVLEN=256 -DEXT_V_ENABLE -DWARP_ISSUE_WIDTH=2" make -C sim/simx
+    VLEN=256 ./tests/riscv/riscv-vector-tests/run-test.sh
+
     echo "vector tests done!"
 }
 
@@ -430,16 +451,35 @@ tensor()
     echo "begin tensor tests..."
 
     make -C tests/regression/sgemm_tcu clean && CONFIGS="-DNUM_THREADS=2 -DITYPE=int8 -DOTYPE=int32" make -C tests/regression/sgemm_tcu
-    CONFIGS="-DNUM_THREADS=2 -DEXT_TCU_ENABLE" ./ci/blackbox.sh --driver=simx --app=sgemm_tcu --debug=3 --log=run_simx.log
+    VORTEX_TCU_FEDP=check CONFIGS="-DNUM_THREADS=2 -DEXT_TCU_ENABLE" ./ci/blackbox.sh --driver=simx --app=sgemm_tcu --debug=3 --log=run_simx.log
 
     make -C tests/regression/sgemm_tcu clean && CONFIGS="-DNUM_THREADS=4 -DITYPE=uint4 -DOTYPE=int32" make -C tests/regression/sgemm_tcu
-    CONFIGS="-DNUM_THREADS=4 -DEXT_TCU_ENABLE" ./ci/blackbox.sh --driver=simx --app=sgemm_tcu
+    VORTEX_TCU_FEDP=check CONFIGS="-DNUM_THREADS=4 -DEXT_TCU_ENABLE" ./ci/blackbox.sh --driver=simx --app=sgemm_tcu
 
     make -C tests/regression/sgemm_tcu clean && CONFIGS="-DNUM_THREADS=8 -DITYPE=fp16 -DOTYPE=fp32" make -C tests/regression/sgemm_tcu
-    CONFIGS="-DNUM_THREADS=8 -DEXT_TCU_ENABLE -DISSUE_WIDTH=2" ./ci/blackbox.sh --driver=simx --app=sgemm_tcu
+    VORTEX_TCU_FEDP=check CONFIGS="-DNUM_THREADS=8 -DEXT_TCU_ENABLE -DISSUE_WIDTH=2" ./ci/blackbox.sh --driver=simx --app=sgemm_tcu
 
     make -C tests/regression/sgemm_tcu clean && CONFIGS="-DNUM_THREADS=16 -DITYPE=bf16 -DOTYPE=bf16" make -C tests/regression/sgemm_tcu
-    CONFIGS="-DNUM_THREADS=16 -DEXT_TCU_ENABLE" ./ci/blackbox.sh --driver=simx --app=sgemm_tcu
+    VORTEX_TCU_FEDP=check CONFIGS="-DNUM_THREADS=16 -DEXT_TCU_ENABLE" ./ci/blackbox.sh --driver=simx --app=sgemm_tcu
+
+    make -C tests/regression/sgemm_tcu clean && CONFIGS="-DNUM_THREADS=8 -DITYPE=fp8 -DOTYPE=fp32" make -C tests/regression/sgemm_tcu
+    VORTEX_TCU_FEDP=check CONFIGS="-DNUM_THREADS=8 -DEXT_TCU_ENABLE" ./ci/blackbox.sh --driver=simx --app=sgemm_tcu
+    VORTEX_TCU_FEDP=check CONFIGS="-DNUM_THREADS=8 -DEXT_TCU_ENABLE" ./ci/blackbox.sh --driver=simx --app=sgemm_tcu --args="-s"
+
+    make -C tests/regression/sgemm_tcu clean && CONFIGS="-DNUM_THREADS=4 -DITYPE=int8 -DOTYPE=int32" make -C tests/regression/sgemm_tcu
+    VORTEX_TCU_FEDP=check CONFIGS="-DNUM_THREADS=4 -DEXT_TCU_ENABLE" ./ci/blackbox.sh --driver=simx --app=sgemm_tcu --args="-s"
+
+    make -C tests/regression/sgemm_tcu clean && CONFIGS="-DNUM_THREADS=16 -DITYPE=bf8 -DOTYPE=fp32" make -C tests/regression/sgemm_tcu
+    VORTEX_TCU_FEDP=check CONFIGS="-DNUM_THREADS=16 -DEXT_TCU_ENABLE" ./ci/blackbox.sh --driver=simx --app=sgemm_tcu --args="-s"
+
+    make -C tests/regression/gemm_tcu clean && CONFIGS="-DNUM_THREADS=4 -DITYPE=fp16 -DOTYPE=fp32" make -C tests/regression/gemm_tcu
+    VORTEX_TCU_FEDP=check CONFIGS="-DNUM_THREADS=4 -DEXT_TCU_ENABLE" ./ci/blackbox.sh --driver=simx --app=gemm_tcu --args="-t gemm"
+    VORTEX_TCU_FEDP=check CONFIGS="-DNUM_THREADS=4 -DEXT_TCU_ENABLE" ./ci/blackbox.sh --driver=simx --app=gemm_tcu --args="-t batched"
+    VORTEX_TCU_FEDP=check CONFIGS="-DNUM_THREADS=4 -DEXT_TCU_ENABLE" ./ci/blackbox.sh --driver=simx --app=gemm_tcu --args="-t conv"
+
+    make -C tests/regression/gemm_tcu clean && CONFIGS="-DNUM_THREADS=8 -DITYPE=int8 -DOTYPE=int32 -DWARPS_M=1 -DWARPS_N=2 -DTILES_K=2" make -C tests/regression/gemm_tcu
+    VORTEX_TCU_FEDP=check CONFIGS="-DNUM_THREADS=8 -DEXT_TCU_ENABLE" ./ci/blackbox.sh --driver=simx --app=gemm_tcu --args="-t gemm"
+    VORTEX_TCU_FEDP=check CONFIGS="-DNUM_THREADS=8 -DEXT_TCU_ENABLE" ./ci/blackbox.sh --driver=simx --app=gemm_tcu --args="-t conv -r 1 -p 0 -c 64"
 
     make -C tests/regression/sgemm_tcu clean && CONFIGS="-DNUM_THREADS=2 -DITYPE=int8 -DOTYPE=int32" make -C tests/regression/sgemm_tcu
     CONFIGS="-DNUM_THREADS=2 -DEXT_TCU_ENABLE" ./ci/blackbox.sh --driver=rtlsim --app=sgemm_tcu --debug=3 --log=run_rtlsim.log
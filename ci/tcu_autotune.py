@@ -0,0 +1,204 @@
+#!/usr/bin/env python3
+
+# Copyright © 2019-2023
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Tile shape autotuner for the tensor GEMM library (kernel/include/vx_tensor_gemm.h).
+# Each candidate (WARPS_M, WARPS_N, TILES_K) is built into tests/regression/gemm_tcu
+# and run on simx; the fastest passing one is cached per problem, format and arch.
+# Run from the build directory.
+
+import os
+import re
+import sys
+import json
+import argparse
+import itertools
+import subprocess
+
+APP = 'gemm_tcu'
+APP_DIR = os.path.join('tests', 'regression', APP)
+
+# input element sizes in bytes, must match sim/common/tensor_cfg.h
+ITYPE_SIZES = {'fp16': 2, 'bf16': 2, 'fp8': 1, 'bf8': 1, 'int8': 1, 'uint8': 1}
+OTYPES = ['fp32', 'fp16', 'bf16', 'int32']
+
+CHOICES = [1, 2, 4]
+
+def parse_args():
+    parser = argparse.ArgumentParser(description='Tensor GEMM tile shape autotuner (simx).')
+    parser.add_argument('-t', '--op', choices=['gemm', 'batched', 'conv'], default='gemm', help='Operation')
+    parser.add_argument('-m', type=int, default=64, help='GEMM M')
+    parser.add_argument('-n', type=int, default=64, help='GEMM N (conv: filters)')
+    parser.add_argument('-k', type=int, default=64, help='GEMM K')
+    parser.add_argument('-b', '--batch', type=int, default=2, help='Batch size (batched, conv)')
+    parser.add_argument('-x', '--in-size', type=int, default=8, help='Conv input height/width')
+    parser.add_argument('-c', '--channels', type=int, default=16, help='Conv input channels')
+    parser.add_argument('-r', '--kernel-size', type=int, default=3, help='Conv kernel height/width')
+    parser.add_argument('-s', '--stride', type=int, default=1, help='Conv stride')
+    parser.add_argument('-p', '--pad', type=int, default=1, help='Conv padding')
+    parser.add_argument('--itype', choices=sorted(ITYPE_SIZES), default='fp16', help='Input format')
+    parser.add_argument('--otype', choices=OTYPES, default='fp32', help='Output format')
+    parser.add_argument('--threads', type=int, default=4, help='Threads per warp')
+    parser.add_argument('--warps', type=int, default=4, help='Warps per core')
+    parser.add_argument('--cores', type=int, default=1, help='Number of cores')
+    parser.add_argument('--configs', default='', help='Extra hardware CONFIGS (e.g. "-DISSUE_WIDTH=2")')
+    parser.add_argument('--cache', default=os.path.expanduser('~/.cache/vortex/tcu_autotune.json'), help='Cache file')
+    parser.add_argument('-f', '--force', action='store_true', help='Re-tune even if the problem is cached')
+    parser.add_argument('-l', '--lookup', action='store_true', help='Only print the cached result')
+    parser.add_argument('-v', '--verbose', action='store_true', help='Show build and run output')
+    return parser.parse_args()
+
+def wmma_tile(threads, itype):
+    # port of wmma_config_t (NR=8, XB=4)
+    tile_cap = threads * 8
+    lg_cap = tile_cap.bit_length() - 1
+    tile_n = 1 << (lg_cap // 2)
+    tile_m = 1 << (lg_cap - lg_cap // 2)
+    tile_k = (tile_cap // max(tile_m, tile_n)) * (4 // ITYPE_SIZES[itype])
+    return tile_m, tile_n, tile_k
+
+def gemm_shape(args):
+    if args.op == 'conv':
+        out_size = (args.in_size + 2 * args.pad - args.kernel_size) // args.stride + 1
+        return args.batch * out_size * out_size, args.n, args.kernel_size * args.kernel_size * args.channels
+    return args.m, args.n, args.k
+
+def candidates(args):
+    M, N, K = gemm_shape(args)
+    tile_m, tile_n, tile_k = wmma_tile(args.threads, args.itype)
+    for wm, wn, kt in itertools.product(CHOICES, CHOICES, CHOICES):
+        if wm * wn > args.warps:
+            continue
+        if M % (wm * tile_m) or N % (wn * tile_n) or K % (kt * tile_k):
+            continue
+        yield wm, wn, kt
+
+def problem_key(args):
+    M, N, K = gemm_shape(args)
+    key = '{}:{}x{}x{}'.format(args.op, M, N, K)
+    if args.op == 'batched':
+        key += ':b{}'.format(args.batch)
+    elif args.op == 'conv':
+        key += ':x{}c{}r{}s{}p{}'.format(args.in_size, args.channels, args.kernel_size, args.stride, args.pad)
+    key += ':{}->{}'.format(args.itype, args.otype)
+    key += ':t{}w{}c{}'.format(args.threads, args.warps, args.cores)
+    if args.configs:
+        key += ':' + ' '.join(args.configs.split())
+    return key
+
+def app_args(args):
+    if args.op == 'conv':
+        return '-t conv -n {} -b {} -x {} -c {} -r {} -s {} -p {}'.format(
+            args.n, args.batch, args.in_size, args.channels, args.kernel_size, args.stride, args.pad)
+    app = '-t {} -m {} -n {} -k {}'.format(args.op, args.m, args.n, args.k)
+    if args.op == 'batched':
+        app += ' -b {}'.format(args.batch)
+    return app
+
+def build_configs(args, wm, wn, kt):
+    return '-DNUM_THREADS={} -DITYPE={} -DOTYPE={} -DWARPS_M={} -DWARPS_N={} -DTILES_K={}'.format(
+        args.threads, args.itype, args.otype, wm, wn, kt)
+
+def run_configs(args):
+    configs = '-DNUM_THREADS={} -DNUM_WARPS={} -DNUM_CORES={} -DEXT_TCU_ENABLE'.format(
+        args.threads, args.warps, args.cores)
+    if args.configs:
+        configs += ' ' + args.configs
+    return configs
+
+def shell(cmd, configs, verbose):
+    env = dict(os.environ, CONFIGS=configs)
+    proc = subprocess.run(cmd, shell=True, env=env, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                          universal_newlines=True)
+    if verbose:
+        print(proc.stdout)
+    return proc.returncode, proc.stdout
+
+def evaluate(args, wm, wn, kt):
+    ret, _ = shell('make -C {0} clean && make -C {0}'.format(APP_DIR), build_configs(args, wm, wn, kt), args.verbose)
+    if ret != 0:
+        return None, 'build failed'
+    # --perf=1 enables the performance counters (PERF: tcu utilization)
+    ret, out = shell('./ci/blackbox.sh --driver=simx --app={} --perf=1 --args="{}"'.format(APP, app_args(args)),
+                     run_configs(args), args.verbose)
+    if ret != 0 or 'PASSED!' not in out:
+        return None, 'run failed'
+    perf = re.search(r'PERF: instrs=(\d+), cycles=(\d+)', out)
+    if perf is None:
+        return None, 'no performance counters'
+    result = {'warps_m': wm, 'warps_n': wn, 'tiles_k': kt,
+              'instrs': int(perf.group(1)), 'cycles': int(perf.group(2))}
+    tcu = re.search(r'PERF: tcu uops=(\d+), utilization=([\d.]+)%', out)
+    if tcu is not None:
+        result['tcu_utilization'] = float(tcu.group(2))
+    return result, None
+
+def load_cache(path):
+    if not os.path.exists(path):
+        return {}
+    with open(path) as f:
+        return json.load(f)
+
+def save_cache(path, cache):
+    dirname = os.path.dirname(path)
+    if dirname:
+        os.makedirs(dirname, exist_ok=True)
+    with open(path, 'w') as f:
+        json.dump(cache, f, indent=2, sort_keys=True)
+
+def print_result(args, result):
+    print('best: WARPS_M={} WARPS_N={} TILES_K={}, cycles={}{}'.format(
+        result['warps_m'], result['warps_n'], result['tiles_k'], result['cycles'],
+        ', tcu utilization={}%'.format(result['tcu_utilization']) if 'tcu_utilization' in result else ''))
+    print('CONFIGS="{}"'.format(build_configs(args, result['warps_m'], result['warps_n'], result['tiles_k'])))
+
+def main():
+    args = parse_args()
+    key = problem_key(args)
+    cache = load_cache(args.cache)
+
+    if key in cache and not args.force:
+        print('cached: ' + key)
+        print_result(args, cache[key])
+        return
+    if args.lookup:
+        sys.exit('Error: no cached result for ' + key)
+
+    if not os.path.isfile(os.path.join('ci', 'blackbox.sh')):
+        sys.exit('Error: must run from the build directory')
+
+    best = None
+    tried = 0
+    for wm, wn, kt in candidates(args):
+        tried += 1
+        result, error = evaluate(args, wm, wn, kt)
+        if result is None:
+            print('WARPS_M={} WARPS_N={} TILES_K={}: {}'.format(wm, wn, kt, error))
+            continue
+        print('WARPS_M={} WARPS_N={} TILES_K={}: cycles={}'.format(wm, wn, kt, result['cycles']))
+        if best is None or result['cycles'] < best['cycles']:
+            best = result
+
+    if tried == 0:
+        sys.exit('Error: no tile shape divides ' + key)
+    if best is None:
+        sys.exit('Error: all candidates failed for ' + key)
+
+    cache[key] = best
+    save_cache(args.cache, cache)
+    print('tuned: ' + key)
+    print_result(args, best)
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,49 @@
+#!/bin/bash
+
+# Copyright © 2019-2023
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Compare the simx warp scheduling policies (SCHEDULE_POLICY / ISSUE_POLICY)
+# on sgemm, bfs and kmeans: prints IPC and L1 data cache read hit ratio per
+# policy as CSV. Run from the build directory.
+
+SCRIPT_DIR=$(dirname "$0")
+
+APPS=${APPS:="sgemm bfs kmeans"}
+WARPS=${WARPS:=8}
+THREADS=${THREADS:=4}
+
+# policy names, indexed by WarpSchedType
+POLICIES=("Priority" "LRR" "GTO" "TwoLevel" "CCWS")
+
+run() {
+    local app=$1 configs=$2
+    local log
+    if ! log=$(CONFIGS="$configs" "$SCRIPT_DIR/blackbox.sh" --driver=simx --app=$app --cores=1 --warps=$WARPS --threads=$THREADS --perf=2 2>&1); then
+        echo "error"
+        return
+    fi
+    local ipc hit
+    ipc=$(echo "$log" | sed -n 's/^PERF: instrs=.*IPC=\([0-9.]*\).*/\1/p' | tail -1)
+    hit=$(echo "$log" | sed -n 's/^PERF: core0: dcache read misses=.*hit ratio=\([0-9]*\)%.*/\1/p' | tail -1)
+    echo "$ipc,$hit"
+}
+
+echo "app,schedule,issue,ipc,dcache_read_hit%"
+for app in $APPS; do
+    # the default pairing (Priority schedule, LRR issue) first
+    echo "$app,${POLICIES[0]},${POLICIES[1]},$(run $app "")"
+    for p in 0 1 2 3 4; do
+        echo "$app,${POLICIES[$p]},${POLICIES[$p]},$(run $app "-DSCHEDULE_POLICY=$p -DISSUE_POLICY=$p")"
+    done
+done
@@ -115,6 +115,11 @@
 #define NUM_BARRIERS UP(NUM_WARPS/2)
 #endif
 
+// DMA completion groups per engine
+#ifndef DMA_NUM_GROUPS
+#define DMA_NUM_GROUPS 8
+#endif
+
 #ifndef SOCKET_SIZE
 #define SOCKET_SIZE MIN(4, NUM_CORES)
 #endif
@@ -453,11 +453,13 @@ package VX_gpu_pkg;
     localparam INST_DMA_SET_SRC  = 4'hB;
     localparam INST_DMA_SET_SIZE = 4'hC;
     localparam INST_DMA_WAIT     = 4'hD;
+    localparam INST_DMA_SET_PARAM = 4'hE;  // 多维描述符参数 (VX_DMA_PARAM_*)
     localparam INST_DMA_BITS     = 4;
 
     // DMA 参数结构
     typedef struct packed {
-        logic [(INST_ARGS_BITS-1)-1:0] __padding;
+        logic [(INST_ARGS_BITS-5)-1:0] __padding;
+        logic [3:0] param;  // SET_PARAM: VX_DMA_PARAM_*
         logic direction;  // 0=G2L, 1=L2G
     } dma_args_t;
 
@@ -513,6 +515,18 @@ package VX_gpu_pkg;
         logic [15:0]           size;
         logic                  direction;  // 0=G2L, 1=L2G
         logic [7:0]  tag;        // DMA ID
+        // 多维描述符: count2 x count1 行, 每行 count0 个元素 (1D 传输由 dma_unit 按 size 生成)
+        logic [`VX_DMA_ELEM_SIZE_BITS-1:0] elem_size;
+        logic [`VX_DMA_COUNT_BITS-1:0] count0;
+        logic [`VX_DMA_COUNT_BITS-1:0] count1;
+        logic [`VX_DMA_COUNT_BITS-1:0] count2;
+        logic [`VX_DMA_COUNT_BITS-1:0] valid0;     // elements beyond valid are skipped, never zero-filled
+        logic [`VX_DMA_COUNT_BITS-1:0] valid1;
+        logic [`VX_DMA_COUNT_BITS-1:0] valid2;
+        logic [`VX_DMA_STRIDE_BITS-1:0] src_stride1;
+        logic [`VX_DMA_STRIDE_BITS-1:0] src_stride2;
+        logic [`VX_DMA_STRIDE_BITS-1:0] dst_stride1;
+        logic [`VX_DMA_STRIDE_BITS-1:0] dst_stride2;
     } req_data_t;
 
     typedef struct packed {
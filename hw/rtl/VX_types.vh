@@ -215,4 +215,27 @@
 `define VX_CSR_NUM_CORES                12'hFC2
 `define VX_CSR_LOCAL_MEM_BASE           12'hFC3
 
+// DMA descriptor parameters
+
+`define VX_DMA_PARAM_ELEM_SIZE          0       // element size in bytes
+`define VX_DMA_PARAM_COUNT0             1       // elements per row
+`define VX_DMA_PARAM_COUNT1             2       // rows per plane
+`define VX_DMA_PARAM_COUNT2             3       // planes
+`define VX_DMA_PARAM_SRC_STRIDE1        4       // source row stride in bytes
+`define VX_DMA_PARAM_SRC_STRIDE2        5       // source plane stride in bytes
+`define VX_DMA_PARAM_DST_STRIDE1        6       // destination row stride in bytes
+`define VX_DMA_PARAM_DST_STRIDE2        7       // destination plane stride in bytes
+`define VX_DMA_PARAM_VALID0             8       // valid elements per row (zero-fill beyond)
+`define VX_DMA_PARAM_VALID1             9       // valid rows per plane
+`define VX_DMA_PARAM_VALID2             10      // valid planes
+`define VX_DMA_PARAM_GROUP              11      // completion group
+`define VX_DMA_PARAM_BARRIER            12      // local barrier signaled on completion
+`define VX_DMA_PARAM_CORE_MASK          13      // socket cores receiving a G2L multicast
+
+// DMA descriptor field widths of the RTL engine (simx checks them too)
+
+`define VX_DMA_ELEM_SIZE_BITS           8
+`define VX_DMA_COUNT_BITS               16      // counts and valid extents
+`define VX_DMA_STRIDE_BITS              32
+
 `endif // VX_TYPES_VH
@@ -543,43 +543,45 @@ module VX_decode import VX_gpu_pkg::*; #(
                 ex_type = EX_SFU;   // DMA 走 SFU 通道
                 is_wstall = 1;      // 触发和等待均需阻塞 warp
 
+                // 编码与 vx_intrinsics.h / simx 保持一致
                 case (funct3)
-                    3'h0: begin // DMA_SET_DST
+                    3'h0: begin // DMA_TRIGGER, imm[0]: 0=G2L, 1=L2G
+                        op_type = INST_OP_BITS'(INST_DMA_TRIGGER);
+                        op_args.dma.direction = u_12[0];
+                        `USED_IREG (rd);              // rd <- dma_id
+                    end
+
+                    3'h1: begin // DMA_SET_DST
                         op_type = INST_OP_BITS'(INST_DMA_SET_DST);
                         op_args.dma.direction = 1'b0; // reserved 无作用
                         `USED_IREG (rs1);             // rs1 = dst_addr
                     end
 
-                    3'h1: begin // DMA_SET_SRC
+                    3'h2: begin // DMA_SET_SRC
                         op_type = INST_OP_BITS'(INST_DMA_SET_SRC);
                         op_args.dma.direction = 1'b0;
                         `USED_IREG (rs1);             // rs1 = src_addr
                     end
 
-                    3'h2: begin // DMA_SET_SIZE
+                    3'h3: begin // DMA_SET_SIZE
                         op_type = INST_OP_BITS'(INST_DMA_SET_SIZE);
                         op_args.dma.direction = 1'b0;
                         `USED_IREG (rs1);             // rs1 = byte size
                     end
 
-                    3'h3: begin // DMA_TRIGGER (G2L)
-                        op_type = INST_OP_BITS'(INST_DMA_TRIGGER);
-                        op_args.dma.direction = 1'b0; // 0 = global->local
-                        `USED_IREG (rd);              // rd <- dma_id
-                    end
-
-                    3'h4: begin // DMA_TRIGGER (L2G)
-                        op_type = INST_OP_BITS'(INST_DMA_TRIGGER);
-                        op_args.dma.direction = 1'b1; // 1 = local->global
-                        `USED_IREG (rd);
-                    end
-
-                    3'h5: begin // DMA_WAIT
+                    3'h4: begin // DMA_WAIT
                         op_type = INST_OP_BITS'(INST_DMA_WAIT);
                         op_args.dma.direction = 1'b0;
                         `USED_IREG (rs1);             // wait(rs1 = dma_id)
                     end
 
+                    3'h5: begin // DMA_SET_PARAM
+                        op_type = INST_OP_BITS'(INST_DMA_SET_PARAM);
+                        op_args.dma.direction = 1'b0;
+                        op_args.dma.param = u_12[3:0]; // imm = VX_DMA_PARAM_*
+                        `USED_IREG (rs1);             // rs1 = value
+                    end
+
                     default:;
                 endcase
             end
@@ -610,6 +612,14 @@ module VX_decode import VX_gpu_pkg::*; #(
 
     wire fetch_fire = fetch_if.valid && fetch_if.ready;
 
+    // descriptor chains (funct3=6) and group waits (WAIT with imm!=0) are only
+    // implemented in simx, the DMA unit would silently drop them
+    wire is_dma_unsupported = (opcode == INST_EXT2)
+                           && ((funct3 == 3'h6) || (funct3 == 3'h4 && u_12 != 0));
+    `RUNTIME_ASSERT(~(fetch_fire && is_dma_unsupported), ("%t: *** %s unsupported DMA instruction: wid=%0d, PC=0x%0h, instr=0x%0h (#%0d)",
+        $time, INSTANCE_ID, fetch_if.data.wid, to_fullPC(fetch_if.data.PC), instr, fetch_if.data.uuid))
+    `UNUSED_VAR (is_dma_unsupported)
+
     assign decode_sched_if.valid  = fetch_fire;
     assign decode_sched_if.wid    = fetch_if.data.wid;
     assign decode_sched_if.unlock = ~is_wstall;
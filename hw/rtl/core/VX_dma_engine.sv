@@ -46,14 +46,21 @@ module VX_dma_engine #(
         CH_DONE     = 2'b11
     } ch_state_e;
 
-    // 每个 channel 内部保存的请求信息
-    typedef struct packed {
-        logic [ADDR_WIDTH-1:0] src_addr;
-        logic [ADDR_WIDTH-1:0] dst_addr;
-        logic [SIZE_WIDTH-1:0] size;
-        logic                  direction;       // 0=G2L, 1=L2G
-        logic [TAG_WIDTH-1:0]  tag;
-    } ch_req_info_t;
+    // 每个 channel 内部保存的请求信息 (多维描述符)
+    typedef dma_req_t ch_req_info_t;
+
+    // 行 (i1, i2) 中需要搬运的有效字节数，超出 valid 的部分跳过 (不做 zero-fill)
+    function automatic logic [SIZE_WIDTH-1:0] row_valid_bytes(
+        input dma_req_t    req,
+        input logic [15:0] i1,
+        input logic [15:0] i2
+    );
+        logic [15:0] cols;
+        cols = (req.valid0 < req.count0) ? req.valid0 : req.count0;
+        if (i1 >= req.valid1 || i2 >= req.valid2)
+            return '0;
+        return SIZE_WIDTH'(cols * req.elem_size);
+    endfunction
 
     // -------------------------------------------------------------
     // Request Queue：接收来自 VX_dma_unit 的请求
@@ -90,8 +97,12 @@ module VX_dma_engine #(
     // 每个 channel 的状态/计数器/请求信息
     ch_state_e             ch_state     [NUM_CHANNELS];
     ch_req_info_t          ch_info      [NUM_CHANNELS];
-    logic [SIZE_WIDTH-1:0] ch_bytes_rem [NUM_CHANNELS];
+    logic [SIZE_WIDTH-1:0] ch_bytes_rem [NUM_CHANNELS];   // 当前行剩余字节
     logic [15:0]           ch_startup_cnt [NUM_CHANNELS];
+    logic [15:0]           ch_i1 [NUM_CHANNELS];          // 当前行号
+    logic [15:0]           ch_i2 [NUM_CHANNELS];          // 当前平面号
+    logic [ADDR_WIDTH-1:0] ch_plane_src [NUM_CHANNELS];   // 当前平面起始地址
+    logic [ADDR_WIDTH-1:0] ch_plane_dst [NUM_CHANNELS];
 
     // Round-robin 分发用指针
     logic [$clog2(NUM_CHANNELS)-1:0] rr_ptr;
@@ -210,6 +221,10 @@ module VX_dma_engine #(
                 ch_info[c]        <= '0;
                 ch_bytes_rem[c]   <= '0;
                 ch_startup_cnt[c] <= '0;
+                ch_i1[c]          <= '0;
+                ch_i2[c]          <= '0;
+                ch_plane_src[c]   <= '0;
+                ch_plane_dst[c]   <= '0;
             end
         end else begin
             // -----------------------------
@@ -218,12 +233,12 @@ module VX_dma_engine #(
             if (dispatch_fire) begin
                 int cid = dispatch_ch_id;
                 // 将当前队列头的请求塞给该 channel
-                ch_info[cid].src_addr   <= req_q_data.src_addr;
-                ch_info[cid].dst_addr   <= req_q_data.dst_addr;
-                ch_info[cid].size       <= req_q_data.size;
-                ch_info[cid].direction  <= req_q_data.direction;
-                ch_info[cid].tag        <= req_q_data.tag;
-                ch_bytes_rem[cid]       <= req_q_data.size;
+                ch_info[cid]            <= req_q_data;
+                ch_bytes_rem[cid]       <= row_valid_bytes(req_q_data, '0, '0);
+                ch_i1[cid]              <= '0;
+                ch_i2[cid]              <= '0;
+                ch_plane_src[cid]       <= req_q_data.src_addr;
+                ch_plane_dst[cid]       <= req_q_data.dst_addr;
                 ch_startup_cnt[cid]     <= STARTUP_LATENCY[15:0];
                 ch_state[cid]           <= CH_STARTUP;
 
@@ -249,28 +264,30 @@ module VX_dma_engine #(
                     end
 
                     CH_TRANSFER: begin
-                        if (ch_bytes_rem[c] == 0) begin
-                            // 已经无剩余（理论上不会进入这种分支）
-                            ch_state[c] <= CH_DONE;
+                        // 一拍传输 BANDWIDTH 字节（简化模型，无背压），
+                        // 行结束后按 stride 跳到下一行/平面；填零行各占一拍
+                        if (ch_bytes_rem[c] > BANDWIDTH[SIZE_WIDTH-1:0]) begin
+                            ch_bytes_rem[c]     <= ch_bytes_rem[c] - BANDWIDTH[SIZE_WIDTH-1:0];
+                            ch_info[c].src_addr <= ch_info[c].src_addr + BANDWIDTH[ADDR_WIDTH-1:0];
+                            ch_info[c].dst_addr <= ch_info[c].dst_addr + BANDWIDTH[ADDR_WIDTH-1:0];
+                        end else if ((ch_i1[c] + 16'd1) < ch_info[c].count1) begin
+                            // 下一行
+                            ch_i1[c]            <= ch_i1[c] + 16'd1;
+                            ch_bytes_rem[c]     <= row_valid_bytes(ch_info[c], ch_i1[c] + 16'd1, ch_i2[c]);
+                            ch_info[c].src_addr <= ch_plane_src[c] + (ch_i1[c] + 16'd1) * ch_info[c].src_stride1;
+                            ch_info[c].dst_addr <= ch_plane_dst[c] + (ch_i1[c] + 16'd1) * ch_info[c].dst_stride1;
+                        end else if ((ch_i2[c] + 16'd1) < ch_info[c].count2) begin
+                            // 下一平面
+                            ch_i1[c]            <= '0;
+                            ch_i2[c]            <= ch_i2[c] + 16'd1;
+                            ch_bytes_rem[c]     <= row_valid_bytes(ch_info[c], '0, ch_i2[c] + 16'd1);
+                            ch_plane_src[c]     <= ch_plane_src[c] + ch_info[c].src_stride2;
+                            ch_plane_dst[c]     <= ch_plane_dst[c] + ch_info[c].dst_stride2;
+                            ch_info[c].src_addr <= ch_plane_src[c] + ch_info[c].src_stride2;
+                            ch_info[c].dst_addr <= ch_plane_dst[c] + ch_info[c].dst_stride2;
                         end else begin
-                            // 一拍传输 BANDWIDTH 字节（简化模型，无背压）
-                            if (ch_bytes_rem[c] <= BANDWIDTH[SIZE_WIDTH-1:0]) begin
-                                ch_bytes_rem[c] <= '0;
-                                ch_state[c]     <= CH_DONE;
-                            end else begin
-                                ch_bytes_rem[c] <= ch_bytes_rem[c] - BANDWIDTH[SIZE_WIDTH-1:0];
-                            end
-
-                            // 同时更新 src/dst 地址
-                            if (ch_info[c].direction == 1'b0) begin
-                                // G2L: src=gmem, dst=lmem
-                                ch_info[c].src_addr <= ch_info[c].src_addr + BANDWIDTH[ADDR_WIDTH-1:0];
-                                ch_info[c].dst_addr <= ch_info[c].dst_addr + BANDWIDTH[ADDR_WIDTH-1:0];
-                            end else begin
-                                // L2G: src=lmem, dst=gmem
-                                ch_info[c].src_addr <= ch_info[c].src_addr + BANDWIDTH[ADDR_WIDTH-1:0];
-                                ch_info[c].dst_addr <= ch_info[c].dst_addr + BANDWIDTH[ADDR_WIDTH-1:0];
-                            end
+                            ch_bytes_rem[c]     <= '0;
+                            ch_state[c]         <= CH_DONE;
                         end
                     end
 
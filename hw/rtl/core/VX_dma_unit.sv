@@ -68,12 +68,14 @@ module VX_dma_unit import VX_gpu_pkg::*; #(
     wire is_dma_set_src  = (execute_if.data.op_type == INST_OP_BITS'(INST_DMA_SET_SRC));
     wire is_dma_set_size = (execute_if.data.op_type == INST_OP_BITS'(INST_DMA_SET_SIZE));
     wire is_dma_wait     = (execute_if.data.op_type == INST_OP_BITS'(INST_DMA_WAIT));
+    wire is_dma_set_param = (execute_if.data.op_type == INST_OP_BITS'(INST_DMA_SET_PARAM));
 
     wire is_dma_inst     = is_dma_trigger
                         || is_dma_set_dst
                         || is_dma_set_src
                         || is_dma_set_size
-                        || is_dma_wait;
+                        || is_dma_wait
+                        || is_dma_set_param;
 
     // 仅 lane0 作为 scalar 寄存器操作数
     wire [`XLEN-1:0] rs1_scalar = rs1_data[0];
@@ -90,6 +92,14 @@ module VX_dma_unit import VX_gpu_pkg::*; #(
     reg [DMA_ID_WIDTH-1:0] warp_dma_id     [NUM_WARPS];
     reg                    warp_pending    [NUM_WARPS];  // 该 warp 是否有未完成 DMA
 
+    // 每 warp 多维描述符 (SET_PARAM)，未设置时按 size 生成 1D 描述符
+    reg [`VX_DMA_ELEM_SIZE_BITS-1:0] warp_elem_size  [NUM_WARPS];
+    reg [`VX_DMA_COUNT_BITS-1:0]     warp_count      [NUM_WARPS][3];
+    reg [`VX_DMA_COUNT_BITS-1:0]     warp_valid      [NUM_WARPS][3];
+    reg [`VX_DMA_STRIDE_BITS-1:0]    warp_src_stride [NUM_WARPS][2];
+    reg [`VX_DMA_STRIDE_BITS-1:0]    warp_dst_stride [NUM_WARPS][2];
+    reg                    warp_has_shape  [NUM_WARPS];
+
     // WAIT 对应的 warp 是否正在等待 / 等待的是哪个 dma_id
     reg                    warp_waiting    [NUM_WARPS];
     reg [DMA_ID_WIDTH-1:0] warp_wait_id    [NUM_WARPS];
@@ -183,6 +193,7 @@ module VX_dma_unit import VX_gpu_pkg::*; #(
     wire dma_set_src_fire  = dma_fire && is_dma_set_src;
     wire dma_set_size_fire = dma_fire && is_dma_set_size;
     wire dma_wait_fire     = dma_fire && is_dma_wait;
+    wire dma_set_param_fire = dma_fire && is_dma_set_param;
 
     // req_valid 直接由 trigger_fire 驱动（这假设 dma_bus_if.req_ready 始终为 1）
     assign dma_bus_if.req_valid               = dma_trigger_fire;
@@ -192,6 +203,19 @@ module VX_dma_unit import VX_gpu_pkg::*; #(
     assign dma_bus_if.req_data.direction        = dma_dir_to_lmem;
     assign dma_bus_if.req_data.tag            = curr_dma_id;
 
+    wire has_shape = warp_has_shape[wid];
+    assign dma_bus_if.req_data.elem_size      = has_shape ? warp_elem_size[wid] : `VX_DMA_ELEM_SIZE_BITS'(1);
+    assign dma_bus_if.req_data.count0         = has_shape ? warp_count[wid][0] : warp_size[wid];
+    assign dma_bus_if.req_data.count1         = has_shape ? warp_count[wid][1] : `VX_DMA_COUNT_BITS'(1);
+    assign dma_bus_if.req_data.count2         = has_shape ? warp_count[wid][2] : `VX_DMA_COUNT_BITS'(1);
+    assign dma_bus_if.req_data.valid0         = warp_valid[wid][0];
+    assign dma_bus_if.req_data.valid1         = warp_valid[wid][1];
+    assign dma_bus_if.req_data.valid2         = warp_valid[wid][2];
+    assign dma_bus_if.req_data.src_stride1    = warp_src_stride[wid][0];
+    assign dma_bus_if.req_data.src_stride2    = warp_src_stride[wid][1];
+    assign dma_bus_if.req_data.dst_stride1    = warp_dst_stride[wid][0];
+    assign dma_bus_if.req_data.dst_stride2    = warp_dst_stride[wid][1];
+
     // 你如果希望更安全一点，也可以在这里加 assert：
     // `ASSERT (dma_trigger_fire -> dma_bus_if.req_ready)
 
@@ -211,6 +235,12 @@ module VX_dma_unit import VX_gpu_pkg::*; #(
                 warp_pending[w]  <= 1'b0;
                 warp_waiting[w]  <= 1'b0;
                 warp_wait_id[w]  <= '0;
+                warp_elem_size[w] <= `VX_DMA_ELEM_SIZE_BITS'(1);
+                warp_count[w]     <= '{default: `VX_DMA_COUNT_BITS'(1)};
+                warp_valid[w]     <= '{default: '1};
+                warp_src_stride[w] <= '{default: '0};
+                warp_dst_stride[w] <= '{default: '0};
+                warp_has_shape[w] <= 1'b0;
             end
 
             warp_stall_r <= '0;
@@ -229,6 +259,27 @@ module VX_dma_unit import VX_gpu_pkg::*; #(
                 warp_size[wid] <= rs1_scalar[SIZE_WIDTH-1:0];
             end
 
+            if (dma_set_param_fire) begin
+                case (execute_if.data.op_args.dma.param)
+                    4'(`VX_DMA_PARAM_ELEM_SIZE):   warp_elem_size[wid]     <= rs1_scalar[`VX_DMA_ELEM_SIZE_BITS-1:0];
+                    4'(`VX_DMA_PARAM_COUNT0):      warp_count[wid][0]      <= rs1_scalar[`VX_DMA_COUNT_BITS-1:0];
+                    4'(`VX_DMA_PARAM_COUNT1):      warp_count[wid][1]      <= rs1_scalar[`VX_DMA_COUNT_BITS-1:0];
+                    4'(`VX_DMA_PARAM_COUNT2):      warp_count[wid][2]      <= rs1_scalar[`VX_DMA_COUNT_BITS-1:0];
+                    4'(`VX_DMA_PARAM_SRC_STRIDE1): warp_src_stride[wid][0] <= rs1_scalar[`VX_DMA_STRIDE_BITS-1:0];
+                    4'(`VX_DMA_PARAM_SRC_STRIDE2): warp_src_stride[wid][1] <= rs1_scalar[`VX_DMA_STRIDE_BITS-1:0];
+                    4'(`VX_DMA_PARAM_DST_STRIDE1): warp_dst_stride[wid][0] <= rs1_scalar[`VX_DMA_STRIDE_BITS-1:0];
+                    4'(`VX_DMA_PARAM_DST_STRIDE2): warp_dst_stride[wid][1] <= rs1_scalar[`VX_DMA_STRIDE_BITS-1:0];
+                    4'(`VX_DMA_PARAM_VALID0):      warp_valid[wid][0]      <= rs1_scalar[`VX_DMA_COUNT_BITS-1:0];
+                    4'(`VX_DMA_PARAM_VALID1):      warp_valid[wid][1]      <= rs1_scalar[`VX_DMA_COUNT_BITS-1:0];
+                    4'(`VX_DMA_PARAM_VALID2):      warp_valid[wid][2]      <= rs1_scalar[`VX_DMA_COUNT_BITS-1:0];
+                    // GROUP, BARRIER and CORE_MASK are not implemented here and do not set a shape
+                    default:;
+                endcase
+                if (execute_if.data.op_args.dma.param <= 4'(`VX_DMA_PARAM_VALID2)) begin
+                    warp_has_shape[wid] <= 1'b1;
+                end
+            end
+
             // ==== TRIGGER：分配 DMA ID + 标记 pending + 发请求 ====
 
             if (dma_trigger_fire) begin
@@ -236,6 +287,14 @@ module VX_dma_unit import VX_gpu_pkg::*; #(
                 warp_dma_id[wid]  <= curr_dma_id;
                 warp_pending[wid] <= 1'b1;
 
+                // 描述符只作用于本次传输
+                warp_elem_size[wid]  <= `VX_DMA_ELEM_SIZE_BITS'(1);
+                warp_count[wid]      <= '{default: `VX_DMA_COUNT_BITS'(1)};
+                warp_valid[wid]      <= '{default: '1};
+                warp_src_stride[wid] <= '{default: '0};
+                warp_dst_stride[wid] <= '{default: '0};
+                warp_has_shape[wid]  <= 1'b0;
+
                 // DMA 触发后，分配器递增
                 next_dma_id <= next_dma_id + 1'b1;
             end
@@ -52,7 +52,8 @@ function automatic logic inst_sfu_is_dma(input logic [INST_OP_BITS-1:0] op_type)
          || op_type == INST_OP_BITS'(INST_DMA_SET_DST)
          || op_type == INST_OP_BITS'(INST_DMA_SET_SRC)
          || op_type == INST_OP_BITS'(INST_DMA_SET_SIZE)
-         || op_type == INST_OP_BITS'(INST_DMA_WAIT));
+         || op_type == INST_OP_BITS'(INST_DMA_WAIT)
+         || op_type == INST_OP_BITS'(INST_DMA_SET_PARAM));
 endfunction
 
     localparam BLOCK_SIZE   = 1;
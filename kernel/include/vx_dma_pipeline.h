@@ -0,0 +1,134 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <VX_config.h>
+#include <vx_intrinsics.h>
+#include <vx_spawn.h>
+
+namespace vortex {
+namespace dma {
+
+// DMA completion groups of a core
+constexpr uint32_t num_groups = DMA_NUM_GROUPS;
+
+// Ring of Stages tiles in local memory filled by the DMA engine.
+//
+// Step i of a loop uses stage (i % Stages). A single thread of the work group
+// (the leader) issues the transfers of a step into the completion group of
+// its stage, so waiting on a step never waits on the prefetches behind it.
+// Stage reuse is ordered with work group barriers: a stage is only refilled
+// after every warp has released it.
+//
+// Completion groups belong to the core, not the work group: work groups that
+// run concurrently on the same core must use disjoint group ranges
+// (group_base), otherwise they also wait on each other's transfers.
+template <typename T, uint32_t Stages>
+class pipeline {
+public:
+  static_assert(Stages >= 1 && Stages <= num_groups, "invalid number of stages");
+
+  static constexpr uint32_t stages = Stages;
+
+  pipeline(T* buffer, uint32_t stage_elems, bool leader, uint32_t group_base = 0)
+    : buffer_(buffer)
+    , stage_elems_(stage_elems)
+    , group_base_(group_base)
+    , leader_(leader)
+  {}
+
+  // local memory of the step's stage
+  T* stage(uint32_t step) const {
+    return buffer_ + (step % Stages) * stage_elems_;
+  }
+
+  // completion group of the step's stage
+  uint32_t group(uint32_t step) const {
+    return group_base_ + (step % Stages);
+  }
+
+  bool leader() const {
+    return leader_;
+  }
+
+  // start loading count contiguous elements at offset elements into the step's stage
+  void load(uint32_t step, uint32_t offset, const T* src, uint32_t count) {
+    if (!leader_)
+      return;
+    // a rejected request (full queue) discards the configuration, so re-issue all of it
+    dma_id_t id;
+    do {
+      vx_dma_set_group(this->group(step));
+      id = vx_dma_g2l(this->stage(step) + offset, (void*)src, count * sizeof(T));
+    } while (id < 0);
+  }
+
+  // start loading a rows x cols tile with leading dimension src_ld into the step's stage,
+  // stored densely (cols elements per row) at offset elements
+  void load_2d(uint32_t step, uint32_t offset, const T* src, uint32_t src_ld, uint32_t rows, uint32_t cols) {
+    if (!leader_)
+      return;
+    dma_id_t id;
+    do {
+      vx_dma_set_group(this->group(step));
+      id = vx_dma_g2l_2d(this->stage(step) + offset, cols * sizeof(T),
+                         src, src_ld * sizeof(T), sizeof(T), cols, rows);
+    } while (id < 0);
+  }
+
+  // wait until the step's stage is resident and visible to all warps of the group
+  void wait(uint32_t step) {
+    if (leader_) {
+      vx_dma_wait_group(this->group(step));
+    }
+    __syncthreads();
+  }
+
+  // all warps are done with the step's stage, it may be refilled
+  void release(uint32_t /*step*/) {
+    __syncthreads();
+  }
+
+private:
+  T*       buffer_;
+  uint32_t stage_elems_;
+  uint32_t group_base_;
+  bool     leader_;
+};
+
+// Software-pipelined loop over num_steps tiles: while step i is computed, the
+// transfers of the next Stages-1 steps are in flight.
+//   load(step):    issue the step's transfers (pipe.load / pipe.load_2d)
+//   compute(step): consume pipe.stage(step)
+// With a single stage, loads and compute are serialized.
+template <typename T, uint32_t Stages, typename Load, typename Compute>
+inline void for_each_tile(pipeline<T, Stages>& pipe, uint32_t num_steps, Load&& load, Compute&& compute) {
+  // prologue: fill all stages but one
+  for (uint32_t step = 0; step + 1 < Stages && step < num_steps; ++step) {
+    load(step);
+  }
+  for (uint32_t step = 0; step < num_steps; ++step) {
+    // prefetch into the stage released at the end of the previous step
+    uint32_t next = step + Stages - 1;
+    if (next < num_steps) {
+      load(next);
+    }
+    pipe.wait(step);
+    compute(step);
+    pipe.release(step);
+  }
+}
+
+} // namespace dma
+} // namespace vortex
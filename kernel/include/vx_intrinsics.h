@@ -322,6 +322,10 @@ inline void __vx_dma_set_size(size_t size) {
     );
 }
 
+// Set a multi-dimensional descriptor parameter, param must be a VX_DMA_PARAM_* constant
+#define __vx_dma_set_param(param, value) \
+    __asm__ volatile (".insn i 0x2B, 0x5, x0, %0, %1" :: "r"(value), "i"(param) : "memory")
+
 // Separate trigger functions for each direction to ensure compile-time constant
 inline dma_id_t __vx_dma_trigger_g2l() {
     dma_id_t dma_id;
@@ -360,6 +364,102 @@ inline dma_id_t vx_dma_l2g(void* global_dst, void* local_src, size_t size) {
     return __vx_dma_trigger_l2g();
 }
 
+// Multi-dimensional DMA descriptor:
+// count[2] x count[1] rows of count[0] elements of elem_size bytes, with byte
+// strides between rows (stride[0]) and planes (stride[1]) on each side.
+// Elements at or beyond valid[d] lie outside the source tile: G2L transfers
+// zero-fill them in local memory (simx only, the RTL engine skips them and
+// leaves local memory unchanged), L2G transfers do not write them.
+// Fields are limited to the RTL widths: VX_DMA_ELEM_SIZE_BITS for elem_size,
+// VX_DMA_COUNT_BITS for counts and valid extents, VX_DMA_STRIDE_BITS for strides.
+typedef struct {
+    uint32_t elem_size;
+    uint32_t count[3];
+    uint32_t valid[3];
+    size_t   src_stride[2];
+    size_t   dst_stride[2];
+} vx_dma_desc_t;
+
+// Initialize a 2D descriptor without padding
+inline void vx_dma_desc_2d(vx_dma_desc_t* desc, uint32_t elem_size, uint32_t cols, uint32_t rows,
+                           size_t src_stride, size_t dst_stride) {
+    desc->elem_size = elem_size;
+    desc->count[0] = cols;
+    desc->count[1] = rows;
+    desc->count[2] = 1;
+    desc->valid[0] = cols;
+    desc->valid[1] = rows;
+    desc->valid[2] = 1;
+    desc->src_stride[0] = src_stride;
+    desc->src_stride[1] = 0;
+    desc->dst_stride[0] = dst_stride;
+    desc->dst_stride[1] = 0;
+}
+
+inline int __vx_dma_desc_fits(const vx_dma_desc_t* desc) {
+    if ((desc->elem_size >> VX_DMA_ELEM_SIZE_BITS) != 0)
+        return 0;
+    for (int d = 0; d < 3; ++d) {
+        if ((desc->count[d] >> VX_DMA_COUNT_BITS) != 0 || (desc->valid[d] >> VX_DMA_COUNT_BITS) != 0)
+            return 0;
+    }
+    for (int d = 0; d < 2; ++d) {
+        if (((uint64_t)desc->src_stride[d] >> VX_DMA_STRIDE_BITS) != 0 || ((uint64_t)desc->dst_stride[d] >> VX_DMA_STRIDE_BITS) != 0)
+            return 0;
+    }
+    return 1;
+}
+
+inline void __vx_dma_set_desc(const vx_dma_desc_t* desc) {
+    if (!__vx_dma_desc_fits(desc)) {
+        // the engine would truncate the descriptor
+        __asm__ volatile ("ebreak");
+    }
+    __vx_dma_set_param(VX_DMA_PARAM_ELEM_SIZE, desc->elem_size);
+    __vx_dma_set_param(VX_DMA_PARAM_COUNT0, desc->count[0]);
+    __vx_dma_set_param(VX_DMA_PARAM_COUNT1, desc->count[1]);
+    __vx_dma_set_param(VX_DMA_PARAM_COUNT2, desc->count[2]);
+    __vx_dma_set_param(VX_DMA_PARAM_VALID0, desc->valid[0]);
+    __vx_dma_set_param(VX_DMA_PARAM_VALID1, desc->valid[1]);
+    __vx_dma_set_param(VX_DMA_PARAM_VALID2, desc->valid[2]);
+    __vx_dma_set_param(VX_DMA_PARAM_SRC_STRIDE1, desc->src_stride[0]);
+    __vx_dma_set_param(VX_DMA_PARAM_SRC_STRIDE2, desc->src_stride[1]);
+    __vx_dma_set_param(VX_DMA_PARAM_DST_STRIDE1, desc->dst_stride[0]);
+    __vx_dma_set_param(VX_DMA_PARAM_DST_STRIDE2, desc->dst_stride[1]);
+}
+
+// N-dimensional G2L copy. Padding beyond the valid extents is zero-filled by
+// simx only: the RTL engine never writes it, so clear the local tile first
+// when a kernel must also run on RTL.
+inline dma_id_t vx_dma_g2l_nd(void* local_dst, const void* global_src, const vx_dma_desc_t* desc) {
+    __vx_dma_set_dst(local_dst);
+    __vx_dma_set_src((void*)global_src);
+    __vx_dma_set_desc(desc);
+    return __vx_dma_trigger_g2l();
+}
+
+inline dma_id_t vx_dma_l2g_nd(void* global_dst, const void* local_src, const vx_dma_desc_t* desc) {
+    __vx_dma_set_dst(global_dst);
+    __vx_dma_set_src((void*)local_src);
+    __vx_dma_set_desc(desc);
+    return __vx_dma_trigger_l2g();
+}
+
+// 2D tile copy of rows x cols elements with a leading dimension (byte stride) on each side
+inline dma_id_t vx_dma_g2l_2d(void* local_dst, size_t dst_stride, const void* global_src, size_t src_stride,
+                              uint32_t elem_size, uint32_t cols, uint32_t rows) {
+    vx_dma_desc_t desc;
+    vx_dma_desc_2d(&desc, elem_size, cols, rows, src_stride, dst_stride);
+    return vx_dma_g2l_nd(local_dst, global_src, &desc);
+}
+
+inline dma_id_t vx_dma_l2g_2d(void* global_dst, size_t dst_stride, const void* local_src, size_t src_stride,
+                              uint32_t elem_size, uint32_t cols, uint32_t rows) {
+    vx_dma_desc_t desc;
+    vx_dma_desc_2d(&desc, elem_size, cols, rows, src_stride, dst_stride);
+    return vx_dma_l2g_nd(global_dst, local_src, &desc);
+}
+
 // DMA wait instruction
 inline void vx_dma_wait(dma_id_t dma_id) {
     __asm__ volatile (
@@ -370,6 +470,78 @@ inline void vx_dma_wait(dma_id_t dma_id) {
     );
 }
 
+// Completion group and barrier of the next transfer or chain.
+// A group collects transfers to wait on together; the barrier is a local
+// barrier that receives one arrival when the transfer completes, so warps can
+// sleep in vx_barrier(bar_id, num_warps + 1) instead of polling. Each
+// signaling transfer adds one arrival (num_warps + n for n transfers) and must
+// be issued in the barrier phase it completes.
+inline void vx_dma_set_group(uint32_t group) {
+    __vx_dma_set_param(VX_DMA_PARAM_GROUP, group);
+}
+
+inline void vx_dma_set_barrier(uint32_t bar_id) {
+    __vx_dma_set_param(VX_DMA_PARAM_BARRIER, bar_id);
+}
+
+// Multicast the next G2L transfer into the local memory of the socket cores
+// in core_mask (bit i: i-th core of the socket); global memory is read once.
+// Receiving cores observe completion through a barrier set with vx_dma_set_barrier().
+inline void vx_dma_set_cores(uint32_t core_mask) {
+    __vx_dma_set_param(VX_DMA_PARAM_CORE_MASK, core_mask);
+}
+
+inline dma_id_t vx_dma_g2l_mcast(void* local_dst, const void* global_src, size_t size, uint32_t core_mask) {
+    __vx_dma_set_dst(local_dst);
+    __vx_dma_set_src((void*)global_src);
+    __vx_dma_set_size(size);
+    vx_dma_set_cores(core_mask);
+    return __vx_dma_trigger_g2l();
+}
+
+// Wait for all transfers and chains of a group
+// (simx only: the RTL DMA unit does not implement groups, RTL simulation asserts on it)
+inline void vx_dma_wait_group(uint32_t group) {
+    __asm__ volatile (
+        ".insn i 0x2B, 0x4, x0, %0, 1"  // opcode=EXT2, funct3=0x4, imm=1 (group)
+        :
+        : "r"(group)
+        : "memory"
+    );
+}
+
+// Linked DMA descriptor, walked by the engine from device memory.
+// Nodes must stay valid until the chain completes.
+typedef struct vx_dma_node_s {
+    struct vx_dma_node_s* next;  // next node (NULL: end of chain)
+    void*         dst;
+    const void*   src;
+    uint32_t      direction;     // 0: G2L, 1: L2G
+    vx_dma_desc_t desc;
+} vx_dma_node_t;
+
+inline void vx_dma_node_init(vx_dma_node_t* node, void* dst, const void* src, uint32_t direction,
+                             const vx_dma_desc_t* desc, vx_dma_node_t* next) {
+    node->next = next;
+    node->dst = dst;
+    node->src = src;
+    node->direction = direction;
+    node->desc = *desc;
+}
+
+// Start a descriptor chain, the returned ID completes with its last node
+// (simx only: the RTL DMA unit does not implement chains, RTL simulation asserts on it)
+inline dma_id_t vx_dma_chain(const vx_dma_node_t* head) {
+    dma_id_t dma_id;
+    __asm__ volatile (
+        ".insn i 0x2B, 0x6, %0, %1, 0"  // opcode=EXT2, funct3=0x6
+        : "=r"(dma_id)
+        : "r"(head)
+        : "memory"
+    );
+    return dma_id;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -130,7 +130,7 @@ struct wmma_context {
 private:
   using cfg = wmma_config_t<NT>;
 
-  enum frag_use_t { matrix_a, matrix_b, accumulator };
+  enum frag_use_t { matrix_a, matrix_a_sp, matrix_b, accumulator };
 
   using vreg_t = float;
 
@@ -142,6 +142,13 @@ private:
     std::array<vreg_t, N> data;
   };
 
+  // 2:4 sparse A: each value register packs the kept elements of two K steps,
+  // 'meta' holds their positions for the whole fragment (one word per lane)
+  template <typename T, uint32_t N>
+  struct fragment_sp_t : fragment_t<matrix_a_sp, T, N> {
+    uint32_t meta;
+  };
+
 public:
 
   using input_t  = typename It::dtype;
@@ -157,7 +164,13 @@ public:
   static constexpr uint32_t tileN = cfg::tileN;
   static constexpr uint32_t tileK = cfg::tileK * i_ratio;
 
+  // 2:4 sparse A needs whole elements per byte and K steps in pairs,
+  // with no group of 4 straddling two pairs
+  static constexpr bool sparse_support = !input_is_subbyte && (cfg::k_steps % 2) == 0
+                                      && ((2 * cfg::tcK * i_ratio) % 4) == 0;
+
   using fragment_a   = fragment_t<matrix_a, input_t, cfg::NRA>;
+  using fragment_a_sp = fragment_sp_t<input_t, cfg::NRA / 2>;
   using fragment_b   = fragment_t<matrix_b, input_t, cfg::NRB>;
   using fragment_acc = fragment_t<accumulator, output_t, cfg::NRC>;
 
@@ -275,6 +288,57 @@ public:
     }
   }
 
+  // Load a 2:4 structured-sparse row-major matrix A: every group of 4 consecutive
+  // K elements has at most 2 non-zeros. 'values' holds the kept elements in index
+  // order (ldm / 2 per row) and 'meta' their positions in the group, one nibble per
+  // group (idx0 in bits [1:0], idx1 in bits [3:2], even groups in the low nibble,
+  // ldm / 8 bytes per row). ldm is the leading dimension of the dense matrix.
+  // Value register r holds the kept elements of K steps 2j and 2j+1 of row block m
+  // (r = m * k_steps / 2 + j), laid out like a dense A register. The metadata word
+  // of each lane holds 8 nibbles, ordered by value register, row, then group.
+  template <typename Frag>
+  static __attribute__((always_inline)) void load_matrix_sync(Frag &dst, const void *values, const void *meta, size_t ldm) {
+    static_assert(Frag::Use == matrix_a_sp, "only sparse matrix_a fragments have metadata");
+    static_assert(sparse_support, "sparse matrix_a is not supported for this input type or warp size");
+    constexpr uint32_t k_pairs  = cfg::k_steps / 2;
+    constexpr uint32_t groups   = (2 * cfg::tcK * i_ratio) / 4; // groups per row of a K pair
+    constexpr uint32_t m_groups = cfg::a_sub_blocks * cfg::tcM * groups;
+    constexpr uint32_t n_groups = Frag::NR * m_groups;
+    static_assert(n_groups <= 8 * NT, "sparse matrix_a metadata must fit in one register");
+    uint32_t m_stride = cfg::a_sub_blocks * cfg::tcM;
+    uint32_t k_stride = cfg::tcK * i_ratio;
+    uint32_t lane = vx_thread_id();
+
+    // kept values: a K pair of the dense row is k_stride compressed elements
+    uint32_t block_idx = (cfg::a_block_size == NT) ? 0 : (lane / cfg::a_block_size);
+    uint32_t lane_in_blk = (cfg::a_block_size == NT) ? lane : (lane % cfg::a_block_size);
+    uint32_t block_row = (lane_in_blk / cfg::tcK) + (block_idx * cfg::tcM);
+    uint32_t block_col = (lane_in_blk % cfg::tcK) * i_ratio;
+    auto base = reinterpret_cast<const input_t*>(values) + block_row * (ldm / 2) + block_col;
+    detail::unroll_for<Frag::NR>([&](auto r) {
+      uint32_t block_m = r / k_pairs;
+      uint32_t block_j = r % k_pairs;
+      auto ptr = base + block_m * m_stride * (ldm / 2) + block_j * k_stride;
+      assert(reinterpret_cast<uintptr_t>(ptr) % alignof(vreg_t) == 0 && "pointer must be aligned to 4 bytes");
+      dst.data[r] = *reinterpret_cast<const vreg_t *>(ptr);
+    });
+
+    // metadata
+    auto meta_base = reinterpret_cast<const uint8_t*>(meta);
+    uint32_t word = 0;
+    for (uint32_t q = 0; q < 8; ++q) {
+      uint32_t g = lane * 8 + q;
+      if (g >= n_groups)
+        break;
+      uint32_t r = g / m_groups;
+      uint32_t row = (r / k_pairs) * m_stride + (g % m_groups) / groups;
+      uint32_t grp = (r % k_pairs) * groups + (g % m_groups) % groups;
+      uint32_t nibble = (meta_base[row * (ldm / 8) + grp / 2] >> ((grp % 2) * 4)) & 0xf;
+      word |= nibble << (q * 4);
+    }
+    dst.meta = word;
+  }
+
   template <mem_layout dst_layout = row_major, typename Frag>
   static __attribute__((always_inline)) void store_matrix_sync(void *dst, const Frag &src, size_t ldm) {
     static_assert(Frag::Use == accumulator, "only accumulator fragment can be stored");
@@ -403,6 +467,104 @@ public:
       fragD.data = {fd0, fd1, fd2, fd3, fd4, fd5, fd6, fd7};
     }
   }
+
+  // 2:4 sparse A: the WMMA_SP variant (funct3 = 1) takes the metadata register
+  // in rs2 and runs one uop per K pair.
+  template <typename FragD, typename FragB, typename FragC>
+  static __attribute__((always_inline)) void mma_sync(FragD &fragD, const fragment_a_sp &fragA, const FragB &fragB, const FragC &fragC) {
+    static_assert(sparse_support, "sparse matrix_a is not supported for this input type or warp size");
+    static_assert(fragment_a_sp::NR == 4, "Unsupported number of registers for sparse FragA");
+    static_assert(FragB::Use == matrix_b, "B must be matrix_b");
+    static_assert(FragC::Use == accumulator, "C must be accumulator");
+    static_assert(FragD::Use == accumulator, "D must be accumulator");
+
+    // fragA values: caller-saved registers (f0-f3)
+    register float fa0 __asm__("f0")  = fragA.data[0];
+    register float fa1 __asm__("f1")  = fragA.data[1];
+    register float fa2 __asm__("f2")  = fragA.data[2];
+    register float fa3 __asm__("f3")  = fragA.data[3];
+
+    if constexpr (FragB::NR == 8) {
+      // fragB: caller-saved registers (f10-f17)
+      register float fb0 __asm__("f10") = fragB.data[0];
+      register float fb1 __asm__("f11") = fragB.data[1];
+      register float fb2 __asm__("f12") = fragB.data[2];
+      register float fb3 __asm__("f13") = fragB.data[3];
+      register float fb4 __asm__("f14") = fragB.data[4];
+      register float fb5 __asm__("f15") = fragB.data[5];
+      register float fb6 __asm__("f16") = fragB.data[6];
+      register float fb7 __asm__("f17") = fragB.data[7];
+
+      // fragC: accumulator registers (f24-f31)
+      register float fc0 __asm__("f24") = fragC.data[0];
+      register float fc1 __asm__("f25") = fragC.data[1];
+      register float fc2 __asm__("f26") = fragC.data[2];
+      register float fc3 __asm__("f27") = fragC.data[3];
+      register float fc4 __asm__("f28") = fragC.data[4];
+      register float fc5 __asm__("f29") = fragC.data[5];
+      register float fc6 __asm__("f30") = fragC.data[6];
+      register float fc7 __asm__("f31") = fragC.data[7];
+
+      // Force outputs into accumulator registers
+      register float fd0 __asm__("f24");
+      register float fd1 __asm__("f25");
+      register float fd2 __asm__("f26");
+      register float fd3 __asm__("f27");
+      register float fd4 __asm__("f28");
+      register float fd5 __asm__("f29");
+      register float fd6 __asm__("f30");
+      register float fd7 __asm__("f31");
+
+      __asm__ volatile (".insn r %[insn], 1, 2, x%[fmd], x%[fms], %[meta]"
+        : "=f"(fd0), "=f"(fd1), "=f"(fd2), "=f"(fd3), "=f"(fd4), "=f"(fd5), "=f"(fd6), "=f"(fd7)
+        : [insn]"i"(RISCV_CUSTOM0), [fmd]"i"(Ot::id), [fms]"i"(It::id), [meta]"r"(fragA.meta),
+          "f"(fa0), "f"(fa1), "f"(fa2), "f"(fa3),
+          "f"(fb0), "f"(fb1), "f"(fb2), "f"(fb3), "f"(fb4), "f"(fb5), "f"(fb6), "f"(fb7),
+          "f"(fc0), "f"(fc1), "f"(fc2), "f"(fc3), "f"(fc4), "f"(fc5), "f"(fc6), "f"(fc7)
+      );
+
+      // Write results to fragD
+      fragD.data = {fd0, fd1, fd2, fd3, fd4, fd5, fd6, fd7};
+    } else {
+      static_assert(FragB::NR == 4, "Unsupported number of registers for FragB");
+      // fragB: caller-saved registers (f28-f31)
+      register float fb0 __asm__("f28") = fragB.data[0];
+      register float fb1 __asm__("f29") = fragB.data[1];
+      register float fb2 __asm__("f30") = fragB.data[2];
+      register float fb3 __asm__("f31") = fragB.data[3];
+
+      // fragC: caller-saved registers (f10-f17)
+      register float fc0 __asm__("f10") = fragC.data[0];
+      register float fc1 __asm__("f11") = fragC.data[1];
+      register float fc2 __asm__("f12") = fragC.data[2];
+      register float fc3 __asm__("f13") = fragC.data[3];
+      register float fc4 __asm__("f14") = fragC.data[4];
+      register float fc5 __asm__("f15") = fragC.data[5];
+      register float fc6 __asm__("f16") = fragC.data[6];
+      register float fc7 __asm__("f17") = fragC.data[7];
+
+      // Force outputs into accumulator registers
+      register float fd0 __asm__("f10");
+      register float fd1 __asm__("f11");
+      register float fd2 __asm__("f12");
+      register float fd3 __asm__("f13");
+      register float fd4 __asm__("f14");
+      register float fd5 __asm__("f15");
+      register float fd6 __asm__("f16");
+      register float fd7 __asm__("f17");
+
+      __asm__ volatile (".insn r %[insn], 1, 2, x%[fmd], x%[fms], %[meta]"
+        : "=f"(fd0), "=f"(fd1), "=f"(fd2), "=f"(fd3), "=f"(fd4), "=f"(fd5), "=f"(fd6), "=f"(fd7)
+        : [insn]"i"(RISCV_CUSTOM0), [fmd]"i"(Ot::id), [fms]"i"(It::id), [meta]"r"(fragA.meta),
+          "f"(fa0), "f"(fa1), "f"(fa2), "f"(fa3),
+          "f"(fb0), "f"(fb1), "f"(fb2), "f"(fb3),
+          "f"(fc0), "f"(fc1), "f"(fc2), "f"(fc3), "f"(fc4), "f"(fc5), "f"(fc6), "f"(fc7)
+      );
+
+      // Write results to fragD
+      fragD.data = {fd0, fd1, fd2, fd3, fd4, fd5, fd6, fd7};
+    }
+  }
 };
 
 } // namespace tensor
@@ -0,0 +1,186 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vx_tensor.h>
+#include <vx_spawn.h>
+
+namespace vortex {
+namespace tensor {
+
+// 2D convolution shape: NHWC input, RSCK filters, NPQK output.
+struct conv2d_desc_t {
+  uint32_t batch;      // N
+  uint32_t in_h;       // H
+  uint32_t in_w;       // W
+  uint32_t channels;   // C
+  uint32_t filters;    // K
+  uint32_t kernel_h;   // R
+  uint32_t kernel_w;   // S
+  uint32_t out_h;      // P
+  uint32_t out_w;      // Q
+  uint32_t stride;
+  uint32_t pad;
+};
+
+// Tiled GEMM kernels on the tensor unit.
+//
+// A work group of cfg::group_size threads (WM x WN warps) computes one
+// blockM x blockN block of C: block (blockIdx.y, blockIdx.x), problem blockIdx.z
+// for batched calls. For every K slice, the group stages blockM x blockK of A
+// and blockK x blockN of B in local memory (cfg::local_mem_size bytes per group),
+// then each warp accumulates its wmma tile of C from there.
+//
+// All matrices are row-major. Problem sizes must be multiples of the block
+// sizes and rows must be 4-byte aligned.
+template <uint32_t NT,   // number of threads per warp
+          typename It,   // input type (A,B)
+          typename Ot,   // output type (C)
+          uint32_t WM,   // warps along M
+          uint32_t WN,   // warps along N
+          uint32_t KT    // wmma tiles per K slice
+          >
+struct gemm_context {
+  using ctx = wmma_context<NT, It, Ot>;
+  using cfg = gemm_config_t<NT, It, Ot, WM, WN, KT>;
+
+  using input_t  = typename ctx::input_t;
+  using output_t = typename ctx::output_t;
+
+  static constexpr uint32_t blockM = cfg::blockM;
+  static constexpr uint32_t blockN = cfg::blockN;
+  static constexpr uint32_t blockK = cfg::blockK;
+
+  static_assert(ctx::tileK == cfg::wmma::tileK, "tile shape mismatch");
+
+  // C = A * B (M x K by K x N)
+  static void gemm(const input_t* A, uint32_t lda,
+                   const input_t* B, uint32_t ldb,
+                   output_t* C, uint32_t ldc,
+                   uint32_t K) {
+    uint32_t m0 = blockIdx.y * blockM;
+    uint32_t n0 = blockIdx.x * blockN;
+    run_block(K,
+      [&](input_t* dst, uint32_t k0, uint32_t tid) {
+        stage<blockM, blockK>(dst, A + m0 * lda + k0, lda, tid);
+      },
+      [&](input_t* dst, uint32_t k0, uint32_t tid) {
+        stage<blockK, blockN>(dst, B + k0 * ldb + n0, ldb, tid);
+      },
+      C + m0 * ldc + n0, ldc);
+  }
+
+  // C[b] = A[b] * B[b] for problem b = blockIdx.z, matrices are stride_* elements apart
+  static void gemm_batched(const input_t* A, uint32_t lda, uint32_t stride_a,
+                           const input_t* B, uint32_t ldb, uint32_t stride_b,
+                           output_t* C, uint32_t ldc, uint32_t stride_c,
+                           uint32_t K) {
+    uint32_t b = blockIdx.z;
+    gemm(A + b * stride_a, lda, B + b * stride_b, ldb, C + b * stride_c, ldc, K);
+  }
+
+  // Implicit-GEMM convolution: O (N*P*Q x K) = im2col(I) (N*P*Q x R*S*C) * W (R*S*C x K).
+  // The im2col slices are gathered directly into local memory, padding reads as zero.
+  // channels must be a multiple of the elements per 32-bit word.
+  static void conv2d(const input_t* I, const input_t* W, output_t* O, const conv2d_desc_t& d) {
+    constexpr uint32_t epw = sizeof(uint32_t) / sizeof(input_t);
+    constexpr uint32_t wpr = blockK / epw;
+    uint32_t m0 = blockIdx.y * blockM;
+    uint32_t n0 = blockIdx.x * blockN;
+    uint32_t gemm_k = d.kernel_h * d.kernel_w * d.channels;
+    run_block(gemm_k,
+      [&](input_t* dst, uint32_t k0, uint32_t tid) {
+        auto dst32 = reinterpret_cast<uint32_t*>(dst);
+        for (uint32_t i = tid; i < blockM * wpr; i += cfg::group_size) {
+          uint32_t m = m0 + i / wpr;
+          uint32_t k = k0 + (i % wpr) * epw;
+          // output pixel (n, p, q) and filter tap (r, s, c)
+          uint32_t q = m % d.out_w;
+          uint32_t p = (m / d.out_w) % d.out_h;
+          uint32_t n = m / (d.out_w * d.out_h);
+          uint32_t c = k % d.channels;
+          uint32_t s = (k / d.channels) % d.kernel_w;
+          uint32_t r = k / (d.channels * d.kernel_w);
+          int32_t y = int32_t(p * d.stride + r) - int32_t(d.pad);
+          int32_t x = int32_t(q * d.stride + s) - int32_t(d.pad);
+          uint32_t value = 0;
+          if (y >= 0 && y < int32_t(d.in_h) && x >= 0 && x < int32_t(d.in_w)) {
+            auto src = I + ((n * d.in_h + y) * d.in_w + x) * d.channels + c;
+            value = *reinterpret_cast<const uint32_t*>(src);
+          }
+          dst32[i] = value;
+        }
+      },
+      [&](input_t* dst, uint32_t k0, uint32_t tid) {
+        stage<blockK, blockN>(dst, W + k0 * d.filters + n0, d.filters, tid);
+      },
+      O + m0 * d.filters + n0, d.filters);
+  }
+
+private:
+
+  // copy a Rows x Cols block (row pitch ld) to local memory, one 32-bit word per thread
+  template <uint32_t Rows, uint32_t Cols>
+  static void stage(input_t* dst, const input_t* src, uint32_t ld, uint32_t tid) {
+    constexpr uint32_t epw = sizeof(uint32_t) / sizeof(input_t);
+    constexpr uint32_t wpr = Cols / epw;
+    static_assert(wpr * epw == Cols, "block rows must be a whole number of words");
+    auto dst32 = reinterpret_cast<uint32_t*>(dst);
+    for (uint32_t i = tid; i < Rows * wpr; i += cfg::group_size) {
+      uint32_t r = i / wpr;
+      uint32_t w = i % wpr;
+      dst32[i] = *reinterpret_cast<const uint32_t*>(src + r * ld + w * epw);
+    }
+  }
+
+  template <typename LoadA, typename LoadB>
+  static void run_block(uint32_t K, LoadA&& load_a, LoadB&& load_b, output_t* C, uint32_t ldc) {
+    auto smem_a = reinterpret_cast<input_t*>(__local_mem(cfg::local_mem_size));
+    auto smem_b = smem_a + blockM * blockK;
+
+    uint32_t tid  = threadIdx.x;
+    uint32_t warp = tid / NT;
+    uint32_t wm   = warp / WN;
+    uint32_t wn   = warp % WN;
+
+    typename ctx::fragment_a   fragA;
+    typename ctx::fragment_b   fragB;
+    typename ctx::fragment_acc fragC;
+
+    ctx::fill_fragment(fragC, 0);
+
+    auto tile_a = smem_a + wm * ctx::tileM * blockK;
+    auto tile_b = smem_b + wn * ctx::tileN;
+
+    for (uint32_t k0 = 0; k0 < K; k0 += blockK) {
+      load_a(smem_a, k0, tid);
+      load_b(smem_b, k0, tid);
+      __syncthreads();
+
+      detail::unroll_for<KT>([&](auto kt) {
+        ctx::load_matrix_sync(fragA, tile_a + kt * ctx::tileK, blockK);
+        ctx::load_matrix_sync(fragB, tile_b + kt * ctx::tileK * blockN, blockN);
+        ctx::mma_sync(fragC, fragA, fragB, fragC);
+      });
+
+      // the slices are refilled next iteration
+      __syncthreads();
+    }
+
+    ctx::store_matrix_sync(C + (wm * ctx::tileM) * ldc + wn * ctx::tileN, fragC, ldc);
+  }
+};
+
+} // namespace tensor
+} // namespace vortex
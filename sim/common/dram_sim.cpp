@@ -14,6 +14,7 @@
 #include "dram_sim.h"
 #include "util.h"
 #include <fstream>
+#include <algorithm>
 
 DISABLE_WARNING_PUSH
 DISABLE_WARNING_UNUSED_PARAMETER
@@ -122,13 +123,20 @@ public:
 		}
 	}
 
-	void send_request(uint64_t addr, bool is_write, ResponseCallback response_cb, void* arg) {
+	void send_request(uint64_t addr, bool is_write, ResponseCallback response_cb, void* arg, uint32_t size) {
 		// enqueue the request
 		if (cpu_channel_size_ > dram_channel_size_) {
+			// partial blocks only transfer the bursts they cover
 			uint32_t n = cpu_channel_size_ / dram_channel_size_;
-			for (uint32_t i = 0; i < n; ++i) {
+			uint32_t first = 0;
+			if (size != 0 && size < cpu_channel_size_) {
+				uint32_t offset = addr % cpu_channel_size_;
+				first = offset / dram_channel_size_;
+				n = std::min((offset + size + dram_channel_size_ - 1) / dram_channel_size_, n) - first;
+			}
+			for (uint32_t i = first; i < first + n; ++i) {
 				uint64_t dram_byte_addr = (addr / cpu_channel_size_) * dram_channel_size_ + (i * dram_channel_size_);
-				if (i == 0) {
+				if (i == first) {
 					pending_reqs_.push({dram_byte_addr, is_write, response_cb, arg});
 				} else {
 					pending_reqs_.push({dram_byte_addr, is_write, nullptr, nullptr});
@@ -162,6 +170,6 @@ void DramSim::tick() {
   impl_->tick();
 }
 
-void DramSim::send_request(uint64_t addr, bool is_write, ResponseCallback callback, void* arg) {
-  impl_->send_request(addr, is_write, callback, arg);
+void DramSim::send_request(uint64_t addr, bool is_write, ResponseCallback callback, void* arg, uint32_t size) {
+  impl_->send_request(addr, is_write, callback, arg, size);
 }
\ No newline at end of file
@@ -27,7 +27,8 @@ public:
   void tick();
 
   // addr: per-channel block address
-  void send_request(uint64_t addr, bool is_write, ResponseCallback response_cb, void* arg);
+  // size: bytes to transfer from addr within the block (0: full block)
+  void send_request(uint64_t addr, bool is_write, ResponseCallback response_cb, void* arg, uint32_t size = 0);
 
 private:
 	class Impl;
@@ -43,6 +43,22 @@ struct bf16 {
   static constexpr const char* name = "bf16";
 };
 
+// OCP 8-bit floats: E4M3 (bias 7, no infinities, NaN = S.1111.111)
+// and E5M2 (bias 15, IEEE-style special values)
+struct fp8 {
+  using dtype = uint8_t;
+  static constexpr uint32_t id = 3;
+  static constexpr uint32_t bits = 8;
+  static constexpr const char* name = "fp8";
+};
+
+struct bf8 {
+  using dtype = uint8_t;
+  static constexpr uint32_t id = 4;
+  static constexpr uint32_t bits = 8;
+  static constexpr const char* name = "bf8";
+};
+
 struct int32 {
   using dtype = int32_t;
   static constexpr uint32_t id = 8;
@@ -83,6 +99,8 @@ inline const char* fmt_string(uint32_t fmt) {
   case fp32::id:  return fp32::name;
   case fp16::id:  return fp16::name;
   case bf16::id:  return bf16::name;
+  case fp8::id:   return fp8::name;
+  case bf8::id:   return bf8::name;
   case int32::id: return int32::name;
   case int8::id:  return int8::name;
   case uint8::id: return uint8::name;
@@ -92,6 +110,22 @@ inline const char* fmt_string(uint32_t fmt) {
   }
 }
 
+inline uint32_t fmt_bits(uint32_t fmt) {
+  switch (fmt) {
+  case fp32::id:  return fp32::bits;
+  case fp16::id:  return fp16::bits;
+  case bf16::id:  return bf16::bits;
+  case fp8::id:   return fp8::bits;
+  case bf8::id:   return bf8::bits;
+  case int32::id: return int32::bits;
+  case int8::id:  return int8::bits;
+  case uint8::id: return uint8::bits;
+  case int4::id:  return int4::bits;
+  case uint4::id: return uint4::bits;
+  default:        return 0;
+  }
+}
+
 template <uint32_t NT,      // number of threads per warp
           typename It = fp32, // input type (A,B)
           typename Ot = fp32, // output type (C,D)
@@ -165,5 +199,35 @@ public:
   static constexpr uint32_t tileK = xtileK * i_ratio; // Adjusted for input type size
 };
 
+// Work group tiling of the GEMM library (vx_tensor_gemm.h): WM x WN warps each
+// compute one wmma tile of C, over K slices of KT wmma tiles staged in local memory.
+template <uint32_t NT,      // number of threads per warp
+          typename It,      // input type (A,B)
+          typename Ot,      // output type (C,D)
+          uint32_t WM,      // warps along M
+          uint32_t WN,      // warps along N
+          uint32_t KT       // wmma tiles per K slice
+          >
+struct gemm_config_t {
+  using wmma = wmma_config_t<NT, It, Ot>;
+
+  static constexpr uint32_t warps_m = WM;
+  static constexpr uint32_t warps_n = WN;
+  static constexpr uint32_t tiles_k = KT;
+
+  static constexpr uint32_t num_warps  = WM * WN;
+  static constexpr uint32_t group_size = num_warps * NT; // threads per work group
+
+  static constexpr uint32_t blockM = WM * wmma::tileM;
+  static constexpr uint32_t blockN = WN * wmma::tileN;
+  static constexpr uint32_t blockK = KT * wmma::tileK;
+
+  // local memory of a work group: A slice (blockM x blockK) then B slice (blockK x blockN)
+  static constexpr uint32_t local_mem_size = (blockM * blockK + blockK * blockN) * sizeof(typename It::dtype);
+
+  static_assert(WM != 0 && WN != 0 && KT != 0, "invalid gemm tiling");
+  static_assert(It::bits >= 8, "sub-byte inputs are not supported");
+};
+
 } // namespace tensor
 } // namespace vortex
\ No newline at end of file
@@ -0,0 +1,155 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+#include "types.h"
+
+namespace vortex {
+
+enum class BPredType {
+  None,     // stall fetch until the branch resolves
+  NotTaken, // static fall-through prediction
+  Bimodal   // 2-bit counters with a branch target buffer
+};
+
+inline std::ostream &operator<<(std::ostream &os, const BPredType& type) {
+  switch (type) {
+  case BPredType::None:     os << "None"; break;
+  case BPredType::NotTaken: os << "NotTaken"; break;
+  case BPredType::Bimodal:  os << "Bimodal"; break;
+  default: assert(false);
+  }
+  return os;
+}
+
+// Per-core branch predictor shared by all warps (they run the same code).
+// The BTB is direct-mapped and only holds taken targets; the bimodal table
+// is indexed by PC. Both are trained with the resolved outcome at predict
+// time, since the functional model already knows it.
+class BranchPredictor {
+public:
+  struct Config {
+    BPredType type;
+    uint32_t  btb_size;
+    uint32_t  bht_size;
+  };
+
+  struct PerfStats {
+    uint64_t branches;
+    uint64_t mispredicts;
+    uint64_t btb_misses;
+    uint64_t resolve_stalls; // unpredicted transfers that hold fetch until they resolve
+
+    PerfStats()
+      : branches(0)
+      , mispredicts(0)
+      , btb_misses(0)
+      , resolve_stalls(0)
+    {}
+
+    PerfStats& operator+=(const PerfStats& rhs) {
+      this->branches += rhs.branches;
+      this->mispredicts += rhs.mispredicts;
+      this->btb_misses += rhs.btb_misses;
+      this->resolve_stalls += rhs.resolve_stalls;
+      return *this;
+    }
+  };
+
+  BranchPredictor(const Config& config)
+    : config_(config)
+    , btb_(std::max<uint32_t>(config.btb_size, 1))
+    , bht_(std::max<uint32_t>(config.bht_size, 1))
+  {
+    this->reset();
+  }
+
+  void reset() {
+    for (auto& entry : btb_) {
+      entry.valid = false;
+    }
+    std::fill(bht_.begin(), bht_.end(), 1); // weakly not-taken
+    perf_stats_ = PerfStats();
+  }
+
+  BPredType type() const {
+    return config_.type;
+  }
+
+  // predict a control transfer and train with its outcome.
+  // returns true if fetch could have continued down the right path.
+  bool predict(Word pc, bool conditional, bool taken, Word target) {
+    ++perf_stats_.branches;
+    bool correct = false;
+    switch (config_.type) {
+    case BPredType::None:
+      // nothing is predicted, so nothing is mispredicted
+      ++perf_stats_.resolve_stalls;
+      return false;
+    case BPredType::NotTaken:
+      correct = !taken;
+      break;
+    case BPredType::Bimodal: {
+      auto& counter = bht_.at((pc >> 2) % bht_.size());
+      auto& entry = btb_.at((pc >> 2) % btb_.size());
+      bool btb_hit = entry.valid && entry.pc == pc;
+      bool pred_taken = btb_hit && (!conditional || counter >= 2);
+      if (pred_taken) {
+        correct = taken && (entry.target == target);
+      } else {
+        correct = !taken;
+      }
+      if (taken && !(btb_hit && entry.target == target)) {
+        ++perf_stats_.btb_misses;
+      }
+      // train
+      if (conditional) {
+        if (taken) {
+          counter += (counter < 3);
+        } else {
+          counter -= (counter > 0);
+        }
+      }
+      if (taken) {
+        entry.valid  = true;
+        entry.pc     = pc;
+        entry.target = target;
+      }
+    } break;
+    default:
+      assert(false);
+    }
+    perf_stats_.mispredicts += !correct;
+    return correct;
+  }
+
+  const PerfStats& perf_stats() const {
+    return perf_stats_;
+  }
+
+private:
+  struct btb_entry_t {
+    bool valid;
+    Word pc;
+    Word target;
+  };
+
+  Config config_;
+  std::vector<btb_entry_t> btb_;
+  std::vector<uint8_t> bht_;
+  PerfStats perf_stats_;
+};
+
+}
@@ -87,6 +87,24 @@ public:
 
 	void tick() {}
 
+	void bind_lower(CacheSim* lower) {
+		for (auto cache : caches_) {
+			lower->bind_upper(cache.get());
+		}
+	}
+
+	void add_snoop_ports(std::vector<SimPort<MemReq>*>& ports) const {
+		for (auto cache : caches_) {
+			ports.push_back(&cache->SnoopPort);
+		}
+	}
+
+	void set_miss_handler(const CacheSim::MissHandler& handler) {
+		for (auto cache : caches_) {
+			cache->set_miss_handler(handler);
+		}
+	}
+
 	CacheSim::PerfStats perf_stats() const {
 		CacheSim::PerfStats perf;
 		for (auto cache : caches_) {
@@ -95,6 +113,14 @@ public:
 		return perf;
 	}
 
+	uint32_t mshr_size() const {
+		uint32_t size = 0;
+		for (auto cache : caches_) {
+			size += cache->mshr_size();
+		}
+		return size;
+	}
+
 private:
   std::vector<CacheSim::Ptr> caches_;
 };
@@ -26,8 +26,13 @@ struct params_t {
 	uint32_t sets_per_bank;
 	uint32_t lines_per_set;
 	uint32_t words_per_line;
+	uint32_t sectors_per_line;
 	uint32_t log2_num_inputs;
 
+	uint32_t log2_line_size;
+	uint32_t log2_word_size;
+	uint32_t log2_sector_size;
+
 	int32_t word_select_addr_start;
 	int32_t word_select_addr_end;
 
@@ -40,17 +45,29 @@ struct params_t {
 	int32_t tag_select_addr_start;
 	int32_t tag_select_addr_end;
 
+	// hashed indexing keeps the full line address in the tag
+	bool hashed;
+	IndexHash bank_hash;
+	IndexHash set_hash;
+
 	params_t(const CacheSim::Config& config) {
 		int32_t offset_bits = config.L - config.W;
 		int32_t index_bits = config.C - (config.L + config.A + config.B);
+		int32_t sector_bits = config.L - config.S;
 		assert(offset_bits >= 0);
 		assert(index_bits >= 0);
+		assert(sector_bits >= 0 && sector_bits <= 5);
 
 		this->log2_num_inputs = log2ceil(config.num_inputs);
 
 		this->sets_per_bank  = 1 << index_bits;
 		this->lines_per_set  = 1 << config.A;
 		this->words_per_line = 1 << offset_bits;
+		this->sectors_per_line = 1 << sector_bits;
+
+		this->log2_line_size = config.L;
+		this->log2_word_size = config.W;
+		this->log2_sector_size = config.S;
 
 		// Word select
 		this->word_select_addr_start = config.W;
@@ -67,9 +84,16 @@ struct params_t {
 		// Tag select
 		this->tag_select_addr_start = (1+this->set_select_addr_end);
 		this->tag_select_addr_end = (config.addr_width-1);
+
+		this->hashed = (config.bank_hash != HashType::Linear)
+		            || (config.set_hash != HashType::Linear);
+		this->bank_hash = IndexHash(config.bank_hash, config.B);
+		this->set_hash = IndexHash(config.set_hash, index_bits);
 	}
 
 	uint32_t addr_bank_id(uint64_t addr) const {
+		if (hashed)
+			return bank_hash(addr >> bank_select_addr_start);
 		if (bank_select_addr_end >= bank_select_addr_start)
 			return (uint32_t)bit_getw(addr, bank_select_addr_start, bank_select_addr_end);
 		else
@@ -77,6 +101,8 @@ struct params_t {
 	}
 
 	uint32_t addr_set_id(uint64_t addr) const {
+		if (hashed)
+			return set_hash(addr >> set_select_addr_start);
 		if (set_select_addr_end >= set_select_addr_start)
 			return (uint32_t)bit_getw(addr, set_select_addr_start, set_select_addr_end);
 		else
@@ -84,13 +110,43 @@ struct params_t {
 	}
 
 	uint64_t addr_tag(uint64_t addr) const {
+		if (hashed)
+			return bit_getw(addr, bank_select_addr_start, tag_select_addr_end);
 		if (tag_select_addr_end >= tag_select_addr_start)
 			return bit_getw(addr, tag_select_addr_start, tag_select_addr_end);
 		else
 			return 0;
 	}
 
+	uint32_t addr_line_offset(uint64_t addr, uint32_t size) const {
+		uint32_t offset = addr & ((1 << log2_line_size) - 1);
+		if (size == 0) {
+			// full word access
+			offset &= ~((1 << log2_word_size) - 1);
+		}
+		return offset;
+	}
+
+	uint32_t line_access_size(uint32_t offset, uint32_t size) const {
+		if (size == 0) {
+			size = 1 << log2_word_size;
+		}
+		return std::min<uint32_t>(size, (1 << log2_line_size) - offset);
+	}
+
+	uint32_t sector_range(uint32_t lo, uint32_t hi) const {
+		return (uint32_t)(((uint64_t(1) << (hi + 1)) - 1) & ~((uint64_t(1) << lo) - 1));
+	}
+
+	uint32_t sector_mask(uint32_t offset, uint32_t size) const {
+		uint32_t lo = offset >> log2_sector_size;
+		uint32_t hi = (offset + size - 1) >> log2_sector_size;
+		return this->sector_range(lo, hi);
+	}
+
 	uint64_t mem_addr(uint32_t bank_id, uint32_t set_id, uint64_t tag) const {
+		if (hashed)
+			return tag << bank_select_addr_start;
 		uint64_t addr(0);
 		if (bank_select_addr_end >= bank_select_addr_start)
 			addr = bit_setw(addr, bank_select_addr_start, bank_select_addr_end, bank_id);
@@ -105,12 +161,16 @@ struct params_t {
 struct line_t {
 	uint64_t tag;
 	uint32_t lru_ctr;
+	uint32_t valid_sectors;
+	uint32_t dirty_sectors;
 	bool     valid;
 	bool     dirty;
 
 	void reset() {
 		valid = false;
 		dirty = false;
+		valid_sectors = 0;
+		dirty_sectors = 0;
 	}
 };
 
@@ -151,6 +211,15 @@ struct set_t {
 		}
 		return hit_line_id;
 	}
+
+	int tag_find(uint64_t tag) const {
+		for (uint32_t i = 0, n = lines.size(); i < n; ++i) {
+			auto& line = lines.at(i);
+			if (line.valid && line.tag == tag)
+				return i;
+		}
+		return -1;
+	}
 };
 
 struct bank_req_t {
@@ -160,12 +229,17 @@ struct bank_req_t {
 	enum ReqType {
 		None   = 0,
 		Replay = 2,
-		Core   = 3
+		Core   = 3,
+		Evict  = 4
 	};
 
 	uint64_t addr_tag;
 	uint32_t set_id;
+	uint32_t offset;
+	uint32_t size;
+	uint32_t sectors;
 	uint32_t cid;
+	uint32_t wid;
 	uint64_t req_tag;
 	uint64_t uuid;
 	ReqType  type;
@@ -183,6 +257,7 @@ struct bank_req_t {
 		os << "set=" << req.set_id << ", rw=" << req.write;
 		os << ", type=" << req.type;
 		os << ", addr_tag=0x" << std::hex << req.addr_tag;
+		os << ", sectors=0x" << req.sectors;
 		os << ", req_tag=" << req.req_tag;
 		os << ", cid=" << std::dec << req.cid;
 		os << " (#" << req.uuid << ")";
@@ -192,21 +267,30 @@ struct bank_req_t {
 
 struct mshr_entry_t {
 	bank_req_t bank_req;
+	uint32_t bank_id;
 	uint32_t line_id;
+	uint32_t fill_sectors; // outstanding fill issued by this entry
+	bool stale;            // the line was snooped while the fill was in flight
 
 	mshr_entry_t() {}
 
 	void reset() {
 		bank_req.reset();
+		stale = false;
 	}
 };
 
 class MSHR {
 public:
-	MSHR(uint32_t size)
-		: entries_(size)
-		, ready_reqs_(0)
+	MSHR(uint32_t size, uint32_t targets, uint32_t num_banks)
+		: entries_(targets ? (size * targets) : size)
+		, ready_reqs_(num_banks, 0)
+		, occupancy_(size + 1, 0)
+		, max_fills_(size)
+		, targets_(targets)
 		, size_(0)
+		, fills_(0)
+		, pending_(0)
 	{}
 
 	uint32_t capacity() const {
@@ -226,28 +310,90 @@ public:
 		return (size_ == entries_.size());
 	}
 
-	bool has_ready_reqs() const {
-		return (ready_reqs_ != 0);
+	// slots reserved by requests in flight through the bank pipelines
+	uint32_t pending() const {
+		return pending_;
+	}
+
+	void reserve() {
+		++pending_;
+	}
+
+	void release() {
+		assert(pending_ > 0);
+		--pending_;
+	}
+
+	bool has_ready_reqs(uint32_t bank_id) const {
+		return (ready_reqs_.at(bank_id) != 0);
+	}
+
+	// returns true if a new fill can be issued (targets mode)
+	bool fill_ready() const {
+		return (0 == targets_) || (fills_ < max_fills_);
+	}
+
+	// returns true if the line can accept another target (targets mode)
+	bool target_ready(uint32_t bank_id, const bank_req_t& bank_req) const {
+		if (0 == targets_)
+			return true;
+		uint32_t count = 0;
+		for (auto& entry : entries_) {
+			if (entry.bank_req.type != bank_req_t::None
+			 && entry.bank_id == bank_id
+			 && entry.bank_req.set_id == bank_req.set_id
+			 && entry.bank_req.addr_tag == bank_req.addr_tag) {
+				++count;
+			}
+		}
+		return (count < targets_);
 	}
 
-	bool lookup(const bank_req_t& bank_req) {
-		for (auto& entry : entries_) {;
+	// returns the sectors already being filled for the request's line
+	uint32_t lookup(uint32_t bank_id, const bank_req_t& bank_req, uint32_t* line_id) {
+		uint32_t pending_sectors = 0;
+		for (auto& entry : entries_) {
 			if (entry.bank_req.type != bank_req_t::None
+			 && entry.bank_id == bank_id
 		 	 && entry.bank_req.set_id == bank_req.set_id
-		   && entry.bank_req.addr_tag == bank_req.addr_tag) {
-				return true;
+			 && entry.bank_req.addr_tag == bank_req.addr_tag
+			 && !entry.stale) {
+				pending_sectors |= entry.fill_sectors;
+				*line_id = entry.line_id;
 			}
 		}
-		return false;
+		return pending_sectors;
 	}
 
-	int enqueue(const bank_req_t& bank_req, uint32_t line_id) {
+	// mark the fills in flight for a snooped line as stale, returns true if any
+	bool mark_stale(uint32_t bank_id, uint32_t set_id, uint64_t addr_tag) {
+		bool found = false;
+		for (auto& entry : entries_) {
+			if (entry.bank_req.type == bank_req_t::Core
+			 && entry.bank_id == bank_id
+			 && entry.bank_req.set_id == set_id
+			 && entry.bank_req.addr_tag == addr_tag
+			 && entry.fill_sectors != 0) {
+				entry.stale = true;
+				found = true;
+			}
+		}
+		return found;
+	}
+
+	int enqueue(uint32_t bank_id, const bank_req_t& bank_req, uint32_t line_id, uint32_t fill_sectors) {
 		assert(bank_req.type == bank_req_t::Core);
 		for (uint32_t i = 0, n = entries_.size(); i < n; ++i) {
 			auto& entry = entries_.at(i);
 			if (entry.bank_req.type == bank_req_t::None) {
 				entry.bank_req = bank_req;
+				entry.bank_id = bank_id;
 				entry.line_id = line_id;
+				entry.fill_sectors = fill_sectors;
+				entry.stale = false;
+				if (fill_sectors != 0) {
+					++fills_;
+				}
 				++size_;
 				return i;
 			}
@@ -256,46 +402,171 @@ public:
 		return -1;
 	}
 
-	mshr_entry_t& replay(uint32_t id) {
+	mshr_entry_t& at(uint32_t id) {
+		return entries_.at(id);
+	}
+
+	uint32_t replay(uint32_t id, uint32_t valid_sectors) {
 		auto& root_entry = entries_.at(id);
+		auto bank_id = root_entry.bank_id;
+		auto& ready_reqs = ready_reqs_.at(bank_id);
 		assert(root_entry.bank_req.type == bank_req_t::Core);
-		assert(ready_reqs_ == 0);
-		// mark all related mshr entries for replay
+		assert(root_entry.fill_sectors != 0);
+		assert(ready_reqs == 0);
+		root_entry.fill_sectors = 0;
+		root_entry.stale = false;
+		--fills_;
+		// collect sectors still in flight for this line
+		uint32_t pending_sectors = 0;
+		for (auto& entry : entries_) {
+			if (entry.bank_req.type == bank_req_t::Core
+			 && entry.bank_id == bank_id
+			 && entry.bank_req.set_id == root_entry.bank_req.set_id
+			 && entry.bank_req.addr_tag == root_entry.bank_req.addr_tag
+			 && !entry.stale) {
+				pending_sectors |= entry.fill_sectors;
+			}
+		}
+		// mark related mshr entries whose sectors are now available for replay,
+		// sectors lost to an eviction and no longer in flight are not waited on
+		// (schedule_replay retries those as new misses).
 		for (auto& entry : entries_) {
 			if (entry.bank_req.type == bank_req_t::Core
+			 && entry.bank_id == bank_id
 			 && entry.bank_req.set_id == root_entry.bank_req.set_id
-			 && entry.bank_req.addr_tag == root_entry.bank_req.addr_tag) {
-				entry.bank_req.type = bank_req_t::Replay;
-				++ready_reqs_;
+			 && entry.bank_req.addr_tag == root_entry.bank_req.addr_tag
+			 && entry.fill_sectors == 0) {
+				uint32_t missing = entry.bank_req.sectors & ~valid_sectors;
+				if (missing == 0 || (missing & ~pending_sectors) != 0) {
+					entry.bank_req.type = bank_req_t::Replay;
+					++ready_reqs;
+				}
 			}
 		}
-		return root_entry;
+		return ready_reqs;
 	}
 
-	void dequeue(bank_req_t* out) {
-		assert(ready_reqs_ > 0);
+	void dequeue(uint32_t bank_id, bank_req_t* out) {
+		auto& ready_reqs = ready_reqs_.at(bank_id);
+		assert(ready_reqs > 0);
 		for (auto& entry : entries_) {
-			if (entry.bank_req.type == bank_req_t::Replay) {
+			if (entry.bank_req.type == bank_req_t::Replay
+			 && entry.bank_id == bank_id) {
 				*out = entry.bank_req;
 				entry.bank_req.type = bank_req_t::None;
-				--ready_reqs_;
+				--ready_reqs;
 				--size_;
 				break;
 			}
 		}
 	}
 
+	// record the number of occupied entries for this cycle
+	void sample() {
+		uint32_t occupied = targets_ ? fills_ : size_;
+		++occupancy_.at(occupied);
+	}
+
+	const std::vector<uint64_t>& occupancy() const {
+		return occupancy_;
+	}
+
 	void reset() {
 		for (auto& entry : entries_) {
 			entry.reset();
 		}
+		for (auto& ready_reqs : ready_reqs_) {
+			ready_reqs = 0;
+		}
+		for (auto& count : occupancy_) {
+			count = 0;
+		}
 		size_ = 0;
+		fills_ = 0;
+		pending_ = 0;
 	}
 
 private:
 	std::vector<mshr_entry_t> entries_;
-	uint32_t ready_reqs_;
+	std::vector<uint32_t> ready_reqs_;
+	std::vector<uint64_t> occupancy_;
+	uint32_t max_fills_;
+	uint32_t targets_;
 	uint32_t size_;
+	uint32_t fills_;
+	uint32_t pending_;
+};
+
+struct victim_t {
+	uint32_t set_id;
+	line_t   line;
+	uint64_t order;
+};
+
+class VictimBuffer {
+public:
+	VictimBuffer(uint32_t size)
+		: entries_(size)
+		, order_(0)
+	{}
+
+	uint32_t capacity() const {
+		return entries_.size();
+	}
+
+	int lookup(uint32_t set_id, uint64_t tag) const {
+		for (uint32_t i = 0, n = entries_.size(); i < n; ++i) {
+			auto& entry = entries_.at(i);
+			if (entry.line.valid
+			 && entry.set_id == set_id
+			 && entry.line.tag == tag)
+				return i;
+		}
+		return -1;
+	}
+
+	line_t remove(uint32_t id) {
+		auto& entry = entries_.at(id);
+		auto line = entry.line;
+		entry.line.reset();
+		return line;
+	}
+
+	// insert a victim line, returns true if the oldest entry was displaced
+	bool insert(uint32_t set_id, const line_t& line, victim_t* displaced) {
+		int free_id = -1;
+		uint32_t oldest_id = 0;
+		for (uint32_t i = 0, n = entries_.size(); i < n; ++i) {
+			auto& entry = entries_.at(i);
+			if (!entry.line.valid) {
+				free_id = i;
+				break;
+			}
+			if (entry.order < entries_.at(oldest_id).order) {
+				oldest_id = i;
+			}
+		}
+		uint32_t id = (free_id != -1) ? free_id : oldest_id;
+		auto& entry = entries_.at(id);
+		if (free_id == -1) {
+			*displaced = entry;
+		}
+		entry.set_id = set_id;
+		entry.line   = line;
+		entry.order  = order_++;
+		return (free_id == -1);
+	}
+
+	void reset() {
+		for (auto& entry : entries_) {
+			entry.line.reset();
+		}
+		order_ = 0;
+	}
+
+private:
+	std::vector<victim_t> entries_;
+	uint64_t order_;
 };
 
 class CacheBank : public SimObject<CacheBank> {
@@ -310,7 +581,8 @@ public:
 	          const char* name,
 	          const CacheSim::Config& config,
 				    const params_t& params,
-						uint32_t bank_id)
+						uint32_t bank_id,
+						MSHR* mshr)
     : SimObject<CacheBank>(ctx, name)
 		, core_req_port(this)
 		, core_rsp_port(this)
@@ -320,15 +592,17 @@ public:
 	  , params_(params)
 		, bank_id_(bank_id)
 		, sets_(params.sets_per_bank, params.lines_per_set)
-		, mshr_(config.mshr_size)
+		, mshr_(mshr)
+		, victims_(config.victim_size)
+		, lower_inclusion_(CacheSim::NINE)
 		, pipe_req_(TFifo<bank_req_t>::Create("", config.latency-1))
 	{
 		this->reset();
 	}
 
   void reset() {
+		victims_.reset();
 		perf_stats_ = CacheSim::PerfStats();
-		pending_mshr_size_ = 0;
     pending_read_reqs_ = 0;
 		pending_write_reqs_ = 0;
 		pending_fill_reqs_ = 0;
@@ -349,6 +623,80 @@ public:
 		return perf_stats_;
 	}
 
+	void bind_upper(CacheSim* upper) {
+		uppers_.push_back(upper);
+	}
+
+	void set_lower_inclusion(uint8_t inclusion) {
+		lower_inclusion_ = inclusion;
+	}
+
+	void set_miss_handler(const CacheSim::MissHandler& handler) {
+		miss_handler_ = handler;
+	}
+
+	bool invalidate(uint64_t addr) {
+		auto set_id = params_.addr_set_id(addr);
+		auto tag = params_.addr_tag(addr);
+		auto& set = sets_.at(set_id);
+		bool dirty = false;
+		bool found = false;
+		int line_id = set.tag_find(tag);
+		if (line_id != -1) {
+			auto& line = set.lines.at(line_id);
+			dirty |= line.dirty;
+			line.reset();
+			found = true;
+		}
+		int victim_id = victims_.lookup(set_id, tag);
+		if (victim_id != -1) {
+			dirty |= victims_.remove(victim_id).dirty;
+			found = true;
+		}
+		if (found) {
+			DT(3, this->name() << "-back-invalidate: addr=0x" << std::hex << addr << std::dec << ", dirty=" << dirty);
+			++perf_stats_.back_invals;
+			if (config_.inclusion == CacheSim::Inclusive) {
+				// propagate to our own upper levels
+				for (auto upper : uppers_) {
+					dirty |= upper->invalidate(addr, 1 << params_.log2_line_size);
+				}
+			}
+		}
+		return dirty;
+	}
+
+	// drop a line written behind the cache, dirty sectors are written back first
+	void snoop(uint64_t addr) {
+		auto set_id = params_.addr_set_id(addr);
+		auto tag = params_.addr_tag(addr);
+		auto& set = sets_.at(set_id);
+		bool found = false;
+		int line_id = set.tag_find(tag);
+		if (line_id != -1) {
+			auto& line = set.lines.at(line_id);
+			if (line.dirty) {
+				this->send_sectors(set_id, line, line.dirty_sectors, line.dirty_sectors, 0);
+			}
+			line.reset();
+			found = true;
+		}
+		int victim_id = victims_.lookup(set_id, tag);
+		if (victim_id != -1) {
+			auto victim = victims_.remove(victim_id);
+			if (victim.dirty) {
+				this->send_sectors(set_id, victim, victim.dirty_sectors, victim.dirty_sectors, 0);
+			}
+			found = true;
+		}
+		// fills in flight carry pre-snoop data, they must not be installed
+		found |= mshr_->mark_stale(bank_id_, set_id, tag);
+		if (found) {
+			DT(3, this->name() << "-snoop-invalidate: addr=0x" << std::hex << addr << std::dec);
+			++perf_stats_.snoop_invals;
+		}
+	}
+
 private:
 
 	void processInputs() {
@@ -357,10 +705,8 @@ private:
 			bank_req_t bank_req;
 
 			// first: schedule MSHR replay
-			if (mshr_.has_ready_reqs()) {
-				mshr_.dequeue(&bank_req);
-				--pending_mshr_size_;
-				pipe_req_->push(bank_req);
+			if (mshr_->has_ready_reqs(bank_id_)) {
+				this->schedule_replay(bank_req);
 				break;
 			}
 
@@ -368,15 +714,30 @@ private:
 			if (!this->mem_rsp_port.empty()) {
 				auto& mem_rsp = mem_rsp_port.front();
 				DT(3, this->name() << "-fill-rsp: " << mem_rsp);
-				// update MSHR
-				auto& entry = mshr_.replay(mem_rsp.tag);
+				// update cache line
+				auto& entry = mshr_->at(mem_rsp.tag);
 				auto& set   = sets_.at(entry.bank_req.set_id);
 				auto& line  = set.lines.at(entry.line_id);
-				line.valid  = true;
-				line.tag    = entry.bank_req.addr_tag;
-				mshr_.dequeue(&bank_req);
-				--pending_mshr_size_;
-				pipe_req_->push(bank_req);
+				uint32_t valid_sectors = 0;
+				if (entry.stale) {
+					// drop a fill overtaken by a snoop, its waiters retry as new misses
+					DT(3, this->name() << "-fill-drop: " << mem_rsp);
+					if (line.valid && line.tag == entry.bank_req.addr_tag) {
+						valid_sectors = line.valid_sectors;
+					}
+				} else {
+					if (!line.valid || line.tag != entry.bank_req.addr_tag) {
+						line.reset();
+						line.valid = true;
+						line.tag   = entry.bank_req.addr_tag;
+					}
+					line.valid_sectors |= entry.fill_sectors;
+					valid_sectors = line.valid_sectors;
+				}
+				// update MSHR
+				if (mshr_->replay(mem_rsp.tag, valid_sectors)) {
+					this->schedule_replay(bank_req);
+				}
 				mem_rsp_port.pop();
 				--pending_fill_reqs_;
 				break;
@@ -385,19 +746,39 @@ private:
 			// third: schedule core request
 			if (!this->core_req_port.empty()) {
 				auto& core_req = core_req_port.front();
+				if (core_req.evict) {
+					// victim line from an upper level
+					DT(3, this->name() << "-evict-req: " << core_req);
+					bank_req.type = bank_req_t::Evict;
+					bank_req.cid = core_req.cid;
+					bank_req.uuid = core_req.uuid;
+					bank_req.set_id = params_.addr_set_id(core_req.addr);
+					bank_req.addr_tag = params_.addr_tag(core_req.addr);
+					bank_req.offset = params_.addr_line_offset(core_req.addr, core_req.size);
+					bank_req.size = params_.line_access_size(bank_req.offset, core_req.size);
+					bank_req.sectors = params_.sector_mask(bank_req.offset, bank_req.size);
+					bank_req.write = core_req.write;
+					pipe_req_->push(bank_req);
+					core_req_port.pop();
+					break;
+				}
 				// check MSHR capacity
 				if ((!core_req.write || config_.write_back)
-				 && (pending_mshr_size_ >= mshr_.capacity())) {
+				 && (mshr_->pending() >= mshr_->capacity())) {
 					++perf_stats_.mshr_stalls;
 					break;
 				}
-				++pending_mshr_size_;
+				mshr_->reserve();
 				DT(3, this->name() << "-core-req: " << core_req);
 				bank_req.type = bank_req_t::Core;
 				bank_req.cid = core_req.cid;
+				bank_req.wid = core_req.wid;
 				bank_req.uuid = core_req.uuid;
 				bank_req.set_id = params_.addr_set_id(core_req.addr);
 				bank_req.addr_tag = params_.addr_tag(core_req.addr);
+				bank_req.offset = params_.addr_line_offset(core_req.addr, core_req.size);
+				bank_req.size = params_.line_access_size(bank_req.offset, core_req.size);
+				bank_req.sectors = params_.sector_mask(bank_req.offset, bank_req.size);
 				bank_req.req_tag = core_req.tag;
 				bank_req.write = core_req.write;
 				pipe_req_->push(bank_req);
@@ -426,14 +807,41 @@ private:
 				this->core_rsp_port.push(core_rsp);
 				DT(3, this->name() << "-replay: " << core_rsp);
 			}
+			if (!bank_req.write && config_.inclusion == CacheSim::Exclusive) {
+				// the line moves to the upper level once no other fill is pending
+				auto& set = sets_.at(bank_req.set_id);
+				uint32_t line_id = 0;
+				int hit_line_id = set.tag_find(bank_req.addr_tag);
+				if (hit_line_id != -1 && 0 == mshr_->lookup(bank_id_, bank_req, &line_id)) {
+					this->drop_line(bank_req.set_id, set.lines.at(hit_line_id), bank_req.cid);
+				}
+			}
+		} break;
+		case bank_req_t::Evict: {
+			this->install_victim(bank_req);
 		} break;
 		case bank_req_t::Core: {
+			// stall on MSHR entry or target exhaustion
+			if (!this->mshr_ready(bank_req))
+				return;
 			int32_t free_line_id = -1;
 			int32_t repl_line_id = 0;
 			auto& set = sets_.at(bank_req.set_id);
 			// tag lookup
 			int hit_line_id = set.tag_lookup(bank_req.addr_tag, &free_line_id, &repl_line_id);
-			if (hit_line_id != -1) {
+			// victim buffer lookup
+			if (hit_line_id == -1
+			 && victims_.capacity() != 0
+			 && !(bank_req.write && !config_.write_back)) {
+				hit_line_id = this->victim_swap(set, bank_req, free_line_id, repl_line_id);
+			}
+			// check requested sectors (write-through writes do not allocate)
+			bool sector_miss = false;
+			if (hit_line_id != -1 && !(bank_req.write && !config_.write_back)) {
+				auto& hit_line = set.lines.at(hit_line_id);
+				sector_miss = (bank_req.sectors & ~hit_line.valid_sectors) != 0;
+			}
+			if (hit_line_id != -1 && !sector_miss) {
 				// Hit handling
 				if (bank_req.write) {
 					// handle write has_hit
@@ -441,7 +849,8 @@ private:
 					if (!config_.write_back) {
 						// forward write request to memory
 						MemReq mem_req;
-						mem_req.addr  = params_.mem_addr(bank_id_, bank_req.set_id, bank_req.addr_tag);
+						mem_req.addr  = params_.mem_addr(bank_id_, bank_req.set_id, bank_req.addr_tag) + bank_req.offset;
+						mem_req.size  = bank_req.size;
 						mem_req.write = true;
 						mem_req.cid   = bank_req.cid;
 						mem_req.uuid  = bank_req.uuid;
@@ -450,6 +859,7 @@ private:
 					} else {
 						// mark line as dirty
 						hit_line.dirty = true;
+						hit_line.dirty_sectors |= bank_req.sectors;
 					}
 				}
 				// send core response
@@ -458,33 +868,26 @@ private:
 					this->core_rsp_port.push(core_rsp);
 					DT(3, this->name() << "-core-rsp: " << core_rsp);
 				}
-				--pending_mshr_size_;
+				if (!bank_req.write && config_.inclusion == CacheSim::Exclusive) {
+					// the line moves to the upper level
+					this->drop_line(bank_req.set_id, set.lines.at(hit_line_id), bank_req.cid);
+				}
+				mshr_->release();
 			} else {
 				// Miss handling
 				if (bank_req.write)
 					++perf_stats_.write_misses;
 				else
 					++perf_stats_.read_misses;
-
-				if (free_line_id == -1 && config_.write_back) {
-					// write back dirty line
-					auto& repl_line = set.lines.at(repl_line_id);
-					if (repl_line.dirty) {
-						MemReq mem_req;
-						mem_req.addr  = params_.mem_addr(bank_id_, bank_req.set_id, repl_line.tag);
-						mem_req.write = true;
-						mem_req.cid   = bank_req.cid;
-						this->mem_req_port.push(mem_req);
-						DT(3, this->name() << "-writeback: " << mem_req);
-						++perf_stats_.evictions;
-					}
-				}
+				if (sector_miss)
+					++perf_stats_.sector_misses;
 
 				if (bank_req.write && !config_.write_back) {
 					// forward write request to memory
 					{
 						MemReq mem_req;
-						mem_req.addr  = params_.mem_addr(bank_id_, bank_req.set_id, bank_req.addr_tag);
+						mem_req.addr  = params_.mem_addr(bank_id_, bank_req.set_id, bank_req.addr_tag) + bank_req.offset;
+						mem_req.size  = bank_req.size;
 						mem_req.write = true;
 						mem_req.cid   = bank_req.cid;
 						mem_req.uuid  = bank_req.uuid;
@@ -497,19 +900,50 @@ private:
 						this->core_rsp_port.push(core_rsp);
 						DT(3, this->name() << "-core-rsp: " << core_rsp);
 					}
-					--pending_mshr_size_;
+					mshr_->release();
 				} else {
 					// MSHR lookup
-					auto mshr_pending = mshr_.lookup(bank_req);
+					uint32_t line_id = sector_miss ? hit_line_id : ((free_line_id != -1) ? free_line_id : repl_line_id);
+					uint32_t pending_sectors = mshr_->lookup(bank_id_, bank_req, &line_id);
+					bool mshr_pending = (pending_sectors != 0);
+
+					if (!mshr_pending && !sector_miss && free_line_id == -1) {
+						// evict the replaced line
+						this->evict_line(bank_req.set_id, set.lines.at(repl_line_id), bank_req.cid);
+					}
+
+					// determine sectors to fetch
+					uint32_t fill_sectors = bank_req.sectors & ~pending_sectors;
+					if (sector_miss) {
+						fill_sectors &= ~set.lines.at(hit_line_id).valid_sectors;
+					}
+					if (fill_sectors != 0) {
+						// fetch a contiguous sector range
+						uint32_t lo = __builtin_ctz(fill_sectors);
+						uint32_t hi = 31 - __builtin_clz(fill_sectors);
+						fill_sectors = params_.sector_range(lo, hi);
+					}
+
+					if (fill_sectors != 0) {
+						++perf_stats_.primary_misses;
+						if (miss_handler_) {
+							miss_handler_(bank_req.cid, bank_req.wid, params_.mem_addr(bank_id_, bank_req.set_id, bank_req.addr_tag));
+						}
+					} else {
+						++perf_stats_.secondary_misses;
+					}
 
 					// allocate MSHR
-					auto mshr_id = mshr_.enqueue(bank_req, (free_line_id != -1) ? free_line_id : repl_line_id);
+					auto mshr_id = mshr_->enqueue(bank_id_, bank_req, line_id, fill_sectors);
 					DT(3, this->name() << "-mshr-enqueue: " << bank_req);
 
 					// send fill request
-					if (!mshr_pending) {
+					if (fill_sectors != 0) {
+						uint32_t lo = __builtin_ctz(fill_sectors);
 						MemReq mem_req;
-						mem_req.addr  = params_.mem_addr(bank_id_, bank_req.set_id, bank_req.addr_tag);
+						mem_req.addr  = params_.mem_addr(bank_id_, bank_req.set_id, bank_req.addr_tag) + (lo << params_.log2_sector_size);
+						mem_req.size  = __builtin_popcount(fill_sectors) << params_.log2_sector_size;
+						mem_req.sectored = true;
 						mem_req.write = false;
 						mem_req.tag   = mshr_id;
 						mem_req.cid   = bank_req.cid;
@@ -528,13 +962,182 @@ private:
 		pipe_req_->pop();
 	}
 
+	// dequeue the next MSHR replay, a request whose sectors were lost to an
+	// eviction is retried as a new miss and keeps its MSHR reservation
+	void schedule_replay(bank_req_t& bank_req) {
+		mshr_->dequeue(bank_id_, &bank_req);
+		auto& set = sets_.at(bank_req.set_id);
+		int line_id = set.tag_find(bank_req.addr_tag);
+		if (line_id != -1
+		 && 0 == (bank_req.sectors & ~set.lines.at(line_id).valid_sectors)) {
+			mshr_->release();
+		} else {
+			bank_req.type = bank_req_t::Core;
+			DT(3, this->name() << "-replay-retry: " << bank_req);
+		}
+		pipe_req_->push(bank_req);
+	}
+
+	// check that a missing request can be allocated in the MSHR
+	bool mshr_ready(const bank_req_t& bank_req) {
+		if (0 == config_.mshr_targets
+		 || (bank_req.write && !config_.write_back))
+			return true;
+		auto& set = sets_.at(bank_req.set_id);
+		uint32_t valid_sectors = 0;
+		int line_id = set.tag_find(bank_req.addr_tag);
+		if (line_id != -1) {
+			valid_sectors = set.lines.at(line_id).valid_sectors;
+		} else if (victims_.lookup(bank_req.set_id, bank_req.addr_tag) != -1) {
+			return true;
+		}
+		uint32_t missing = bank_req.sectors & ~valid_sectors;
+		if (0 == missing)
+			return true;
+		uint32_t mshr_line_id = 0;
+		uint32_t pending_sectors = mshr_->lookup(bank_id_, bank_req, &mshr_line_id);
+		if (0 != (missing & ~pending_sectors)) {
+			// primary miss
+			if (!mshr_->fill_ready()) {
+				++perf_stats_.mshr_stalls;
+				return false;
+			}
+		} else {
+			// secondary miss
+			if (!mshr_->target_ready(bank_id_, bank_req)) {
+				++perf_stats_.mshr_target_stalls;
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// send line sectors to the next level
+	void send_sectors(uint32_t set_id, const line_t& line, uint32_t sectors, uint32_t dirty_sectors, uint32_t cid) {
+		for (uint32_t s = 0; s < params_.sectors_per_line; ++s) {
+			if (0 == ((sectors >> s) & 0x1))
+				continue;
+			MemReq mem_req;
+			mem_req.addr  = params_.mem_addr(bank_id_, set_id, line.tag) + (s << params_.log2_sector_size);
+			mem_req.size  = (1 << params_.log2_sector_size);
+			mem_req.sectored = true;
+			mem_req.write = (dirty_sectors >> s) & 0x1;
+			mem_req.evict = (lower_inclusion_ == CacheSim::Exclusive);
+			mem_req.cid   = cid;
+			this->mem_req_port.push(mem_req);
+			DT(3, this->name() << (mem_req.write ? "-writeback: " : "-victim-fill: ") << mem_req);
+		}
+	}
+
+	// a line leaves this bank
+	void release_line(uint32_t set_id, const line_t& line, uint32_t cid) {
+		uint32_t dirty_sectors = line.dirty ? line.dirty_sectors : 0;
+		if (config_.inclusion == CacheSim::Inclusive) {
+			// back-invalidate upper copies, their dirty data is written back with the line
+			auto addr = params_.mem_addr(bank_id_, set_id, line.tag);
+			for (auto upper : uppers_) {
+				if (upper->invalidate(addr, 1 << params_.log2_line_size)) {
+					dirty_sectors = line.valid_sectors;
+				}
+			}
+		}
+		// an exclusive lower level also receives clean victims
+		uint32_t sectors = (lower_inclusion_ == CacheSim::Exclusive) ? line.valid_sectors : dirty_sectors;
+		this->send_sectors(set_id, line, sectors, dirty_sectors, cid);
+		if (dirty_sectors != 0) {
+			++perf_stats_.evictions;
+		}
+	}
+
+	// evict a line into the victim buffer, or out of the bank
+	void evict_line(uint32_t set_id, const line_t& line, uint32_t cid) {
+		if (!line.valid)
+			return;
+		if (victims_.capacity() != 0) {
+			victim_t displaced;
+			if (victims_.insert(set_id, line, &displaced)) {
+				this->release_line(displaced.set_id, displaced.line, cid);
+			}
+			++perf_stats_.victim_fills;
+		} else {
+			this->release_line(set_id, line, cid);
+		}
+	}
+
+	// hand a line over to the upper level (exclusive policy)
+	void drop_line(uint32_t set_id, line_t& line, uint32_t cid) {
+		if (line.dirty) {
+			this->send_sectors(set_id, line, line.dirty_sectors, line.dirty_sectors, cid);
+			++perf_stats_.evictions;
+		}
+		line.reset();
+	}
+
+	// move a victim buffer hit back into the set
+	int victim_swap(set_t& set, const bank_req_t& bank_req, int free_line_id, int repl_line_id) {
+		int victim_id = victims_.lookup(bank_req.set_id, bank_req.addr_tag);
+		if (victim_id == -1)
+			return -1;
+		uint32_t line_id = (free_line_id != -1) ? free_line_id : repl_line_id;
+		auto& line = set.lines.at(line_id);
+		auto victim = victims_.remove(victim_id);
+		// the displaced line takes the released victim entry
+		this->evict_line(bank_req.set_id, line, bank_req.cid);
+		line = victim;
+		line.lru_ctr = 0;
+		DT(3, this->name() << "-victim-hit: " << bank_req);
+		++perf_stats_.victim_hits;
+		return line_id;
+	}
+
+	// install a victim line received from an upper level
+	void install_victim(const bank_req_t& bank_req) {
+		int32_t free_line_id = -1;
+		int32_t repl_line_id = 0;
+		auto& set = sets_.at(bank_req.set_id);
+		int hit_line_id = set.tag_lookup(bank_req.addr_tag, &free_line_id, &repl_line_id);
+		if (hit_line_id == -1) {
+			uint32_t line_id = 0;
+			if (mshr_->lookup(bank_id_, bank_req, &line_id) != 0)
+				return; // a fill is already bringing the line in
+			hit_line_id = (free_line_id != -1) ? free_line_id : repl_line_id;
+			auto& line = set.lines.at(hit_line_id);
+			this->evict_line(bank_req.set_id, line, bank_req.cid);
+			line.reset();
+			line.valid = true;
+			line.tag   = bank_req.addr_tag;
+			line.lru_ctr = 0;
+		}
+		auto& line = set.lines.at(hit_line_id);
+		line.valid_sectors |= bank_req.sectors;
+		if (bank_req.write) {
+			if (config_.write_back) {
+				line.dirty = true;
+				line.dirty_sectors |= bank_req.sectors;
+			} else {
+				MemReq mem_req;
+				mem_req.addr  = params_.mem_addr(bank_id_, bank_req.set_id, bank_req.addr_tag) + bank_req.offset;
+				mem_req.size  = bank_req.size;
+				mem_req.write = true;
+				mem_req.cid   = bank_req.cid;
+				mem_req.uuid  = bank_req.uuid;
+				this->mem_req_port.push(mem_req);
+				DT(3, this->name() << "-writethrough: " << mem_req);
+			}
+		}
+		++perf_stats_.excl_fills;
+	}
+
 	CacheSim::Config config_;
 	params_t params_;
 	uint32_t bank_id_;
 
   std::vector<set_t> sets_;
-	MSHR mshr_;
-	uint32_t pending_mshr_size_;
+	MSHR* mshr_;
+	VictimBuffer victims_;
+	std::vector<CacheSim*> uppers_;
+	uint8_t lower_inclusion_;
+	CacheSim::MissHandler miss_handler_;
 	TFifo<bank_req_t>::Ptr pipe_req_;
 
 	CacheSim::PerfStats perf_stats_;
@@ -602,10 +1205,20 @@ public:
 				return params_.addr_bank_id(req.addr);
 			});
 
+		// Create MSHR files (one per bank, or a single one shared by all banks)
+		if (config_.mshr_shared) {
+			mshrs_.emplace_back(new MSHR(config_.mshr_size * num_banks, config_.mshr_targets, num_banks));
+		} else {
+			for (uint32_t i = 0; i < num_banks; ++i) {
+				mshrs_.emplace_back(new MSHR(config_.mshr_size, config_.mshr_targets, num_banks));
+			}
+		}
+
 		// Create cache banks
 		for (uint32_t i = 0, n = num_banks; i < n; ++i) {
 			snprintf(sname, 100, "%s-bank%d", simobject->name().c_str(), i);
-			banks_.at(i) = CacheBank::Create(sname, config, params_, i);
+			auto mshr = mshrs_.at(config_.mshr_shared ? 0 : i).get();
+			banks_.at(i) = CacheBank::Create(sname, config, params_, i, mshr);
 
 			// bind core ports
 			bank_core_xbar_->ReqOut.at(i).bind(&banks_.at(i)->core_req_port);
@@ -621,13 +1234,24 @@ public:
 		if (config_.bypass)
 			return;
 
+		for (auto& mshr : mshrs_) {
+			mshr->reset();
+		}
+
 		// calculate cache initialization cycles
 		init_cycles_ = params_.sets_per_bank;
+
+		snoops_ = 0;
 	}
 
   void tick() {
-		if (config_.bypass)
+		if (config_.bypass) {
+			// nothing to invalidate
+			while (!simobject_->SnoopPort.empty()) {
+				simobject_->SnoopPort.pop();
+			}
 			return;
+		}
 
 		// wait on cache initialization cycles
 		if (init_cycles_ != 0) {
@@ -636,6 +1260,23 @@ public:
 			return;
 		}
 
+		// sample MSHR occupancy
+		for (auto& mshr : mshrs_) {
+			mshr->sample();
+		}
+
+		// handle snoop invalidations, one request per cycle
+		if (!simobject_->SnoopPort.empty()) {
+			auto& snoop_req = simobject_->SnoopPort.front();
+			DT(3, simobject_->name() << "-snoop-req: " << snoop_req);
+			uint32_t line_size = 1 << config_.L;
+			for (uint64_t a = snoop_req.addr & ~uint64_t(line_size - 1); a < snoop_req.addr + snoop_req.size; a += line_size) {
+				banks_.at(params_.addr_bank_id(a))->snoop(a);
+			}
+			++snoops_;
+			simobject_->SnoopPort.pop();
+		}
+
 		// handle cache bypasss responses
 		for (uint32_t i = 0, n = config_.mem_ports; i < n; ++i) {
 			// Forward non-cacheable arbiter's output 1 to core response ports
@@ -679,11 +1320,61 @@ public:
 			for (const auto& bank : banks_) {
 				perf_stats += bank->perf_stats();
 			}
+			for (const auto& mshr : mshrs_) {
+				CacheSim::PerfStats mshr_perf;
+				mshr_perf.mshr_occupancy = mshr->occupancy();
+				perf_stats += mshr_perf;
+			}
 			perf_stats.bank_stalls = bank_core_xbar_->collisions();
+			perf_stats.snoops = snoops_;
 		}
 		return perf_stats;
 	}
 
+	uint32_t mshr_size() const {
+		uint32_t size = 0;
+		for (const auto& mshr : mshrs_) {
+			size += mshr->size();
+		}
+		return size;
+	}
+
+	void bind_upper(CacheSim* upper) {
+		if (config_.bypass)
+			return;
+		for (auto& bank : banks_) {
+			bank->bind_upper(upper);
+		}
+		upper->impl_->set_lower_inclusion(config_.inclusion);
+	}
+
+	void set_lower_inclusion(uint8_t inclusion) {
+		for (auto& bank : banks_) {
+			if (bank) {
+				bank->set_lower_inclusion(inclusion);
+			}
+		}
+	}
+
+	bool invalidate(uint64_t addr, uint32_t size) {
+		if (config_.bypass)
+			return false;
+		bool dirty = false;
+		uint32_t line_size = 1 << config_.L;
+		for (uint64_t a = addr & ~uint64_t(line_size - 1); a < addr + size; a += line_size) {
+			dirty |= banks_.at(params_.addr_bank_id(a))->invalidate(a);
+		}
+		return dirty;
+	}
+
+	void set_miss_handler(const MissHandler& handler) {
+		for (auto& bank : banks_) {
+			if (bank) {
+				bank->set_miss_handler(handler);
+			}
+		}
+	}
+
 private:
 
 	void processBypassResponse(const MemRsp& mem_rsp) {
@@ -715,10 +1406,12 @@ private:
 	Config config_;
 	params_t params_;
 	std::vector<CacheBank::Ptr> banks_;
+	std::vector<std::unique_ptr<MSHR>> mshrs_;
 	MemArbiter::Ptr bank_arb_;
 	std::vector<MemArbiter::Ptr> nc_mem_arbs_;
 	MemCrossBar::Ptr bank_core_xbar_;
 	uint32_t init_cycles_;
+	uint64_t snoops_;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -729,6 +1422,7 @@ CacheSim::CacheSim(const SimContext& ctx, const char* name, const Config& config
 	, CoreRspPorts(config.num_inputs, this)
 	, MemReqPorts(config.mem_ports, this)
 	, MemRspPorts(config.mem_ports, this)
+	, SnoopPort(this)
 	, impl_(new Impl(this, config))
 {}
 
@@ -744,6 +1438,22 @@ void CacheSim::tick() {
   impl_->tick();
 }
 
+void CacheSim::bind_upper(CacheSim* upper) {
+  impl_->bind_upper(upper);
+}
+
+bool CacheSim::invalidate(uint64_t addr, uint32_t size) {
+  return impl_->invalidate(addr, size);
+}
+
+void CacheSim::set_miss_handler(const MissHandler& handler) {
+  impl_->set_miss_handler(handler);
+}
+
 CacheSim::PerfStats CacheSim::perf_stats() const {
   return impl_->perf_stats();
+}
+
+uint32_t CacheSim::mshr_size() const {
+  return impl_->mshr_size();
 }
\ No newline at end of file
@@ -14,16 +14,24 @@
 #pragma once
 
 #include <simobject.h>
+#include <functional>
 #include "mem_sim.h"
 
 namespace vortex {
 
 class CacheSim : public SimObject<CacheSim> {
 public:
+	enum Inclusion {
+		NINE      = 0, // non-inclusive non-exclusive
+		Inclusive = 1, // lower level evictions back-invalidate upper levels
+		Exclusive = 2  // lines live in either the upper or the lower level
+	};
+
 	struct Config {
 		bool    bypass;         // cache bypass
 		uint8_t C;              // log2 cache size
 		uint8_t L;              // log2 line size
+		uint8_t S;              // log2 sector size (S == L: unsectored)
 		uint8_t W;              // log2 word size
 		uint8_t A;              // log2 associativity
 		uint8_t B;              // log2 number of banks
@@ -34,6 +42,12 @@ public:
 		bool    write_reponse;  // enable write response
 		uint16_t mshr_size;     // MSHR buffer size
 		uint8_t latency;        // pipeline latency
+		uint8_t victim_size;    // victim buffer entries (0: disabled)
+		uint8_t inclusion;      // inclusion policy wrt upper caches
+		uint8_t mshr_targets;   // targets per MSHR entry (0: one entry per request)
+		bool    mshr_shared;    // single MSHR file shared by all banks
+		HashType bank_hash;     // bank selection hash
+		HashType set_hash;      // set selection hash
 	};
 
 	struct PerfStats {
@@ -41,20 +55,41 @@ public:
 		uint64_t writes;
 		uint64_t read_misses;
 		uint64_t write_misses;
+		uint64_t sector_misses;
 		uint64_t evictions;
 		uint64_t bank_stalls;
 		uint64_t mshr_stalls;
+		uint64_t mshr_target_stalls;
+		uint64_t primary_misses;
+		uint64_t secondary_misses;
 		uint64_t mem_latency;
+		uint64_t victim_hits;
+		uint64_t victim_fills;
+		uint64_t back_invals;
+		uint64_t excl_fills;
+		uint64_t snoops;
+		uint64_t snoop_invals;
+		std::vector<uint64_t> mshr_occupancy; // cycles per number of occupied MSHR entries
 
 		PerfStats()
 			: reads(0)
 			, writes(0)
 			, read_misses(0)
 			, write_misses(0)
+			, sector_misses(0)
 			, evictions(0)
 			, bank_stalls(0)
 			, mshr_stalls(0)
+			, mshr_target_stalls(0)
+			, primary_misses(0)
+			, secondary_misses(0)
 			, mem_latency(0)
+			, victim_hits(0)
+			, victim_fills(0)
+			, back_invals(0)
+			, excl_fills(0)
+			, snoops(0)
+			, snoop_invals(0)
 		{}
 
 		PerfStats& operator+=(const PerfStats& rhs) {
@@ -62,10 +97,26 @@ public:
 			this->writes += rhs.writes;
 			this->read_misses += rhs.read_misses;
 			this->write_misses += rhs.write_misses;
+			this->sector_misses += rhs.sector_misses;
 			this->evictions += rhs.evictions;
 			this->bank_stalls += rhs.bank_stalls;
 			this->mshr_stalls += rhs.mshr_stalls;
+			this->mshr_target_stalls += rhs.mshr_target_stalls;
+			this->primary_misses += rhs.primary_misses;
+			this->secondary_misses += rhs.secondary_misses;
 			this->mem_latency += rhs.mem_latency;
+			this->victim_hits += rhs.victim_hits;
+			this->victim_fills += rhs.victim_fills;
+			this->back_invals += rhs.back_invals;
+			this->excl_fills += rhs.excl_fills;
+			this->snoops += rhs.snoops;
+			this->snoop_invals += rhs.snoop_invals;
+			if (this->mshr_occupancy.size() < rhs.mshr_occupancy.size()) {
+				this->mshr_occupancy.resize(rhs.mshr_occupancy.size(), 0);
+			}
+			for (size_t i = 0; i < rhs.mshr_occupancy.size(); ++i) {
+				this->mshr_occupancy.at(i) += rhs.mshr_occupancy.at(i);
+			}
 			return *this;
 		}
 	};
@@ -75,6 +126,9 @@ public:
 	std::vector<SimPort<MemReq>> MemReqPorts;
 	std::vector<SimPort<MemRsp>> MemRspPorts;
 
+	// invalidations for lines written behind the cache (e.g. by DMA engines)
+	SimPort<MemReq> SnoopPort;
+
 	CacheSim(const SimContext& ctx, const char* name, const Config& config);
 	~CacheSim();
 
@@ -82,8 +136,21 @@ public:
 
 	void tick();
 
+	// register an upper level cache for inclusion enforcement
+	void bind_upper(CacheSim* upper);
+
+	// back-invalidate lines in [addr, addr+size), returns true if any was dirty
+	bool invalidate(uint64_t addr, uint32_t size);
+
+	// primary miss notification (core id, warp id, line address)
+	using MissHandler = std::function<void(uint32_t cid, uint32_t wid, uint64_t addr)>;
+	void set_miss_handler(const MissHandler& handler);
+
 	PerfStats perf_stats() const;
 
+	// MSHR entries currently allocated
+	uint32_t mshr_size() const;
+
 private:
 	class Impl;
 	Impl* impl_;
@@ -47,6 +47,7 @@ Cluster::Cluster(const SimContext& ctx,
     !L2_ENABLED,
     log2ceil(L2_CACHE_SIZE),// C
     log2ceil(MEM_BLOCK_SIZE),// L
+    log2ceil(L2_SECTOR_SIZE),// S
     log2ceil(L1_LINE_SIZE), // W
     log2ceil(L2_NUM_WAYS),  // A
     log2ceil(L2_NUM_BANKS), // B
@@ -57,6 +58,12 @@ Cluster::Cluster(const SimContext& ctx,
     false,                  // write response
     L2_MSHR_SIZE,           // mshr size
     2,                      // pipeline latency
+    L2_VICTIM_SIZE,         // victim buffer size
+    L2_INCLUSION,           // inclusion policy
+    L2_MSHR_TARGETS,        // mshr targets
+    L2_MSHR_SHARED,         // shared mshr
+    HashType(L2_BANK_HASH), // bank hash
+    HashType(L2_SET_HASH),  // set hash
   });
 
   // connect l2cache core interfaces
@@ -67,11 +74,25 @@ Cluster::Cluster(const SimContext& ctx,
     }
   }
 
+  // register l1 caches for inclusion enforcement
+  if (L2_ENABLED) {
+    for (auto& socket : sockets_) {
+      socket->bind_lower_cache(l2cache_.get());
+    }
+  }
+
   // connect l2cache memory interfaces
   for (uint32_t i = 0; i < L2_MEM_PORTS; ++i) {
     l2cache_->MemReqPorts.at(i).bind(&this->mem_req_ports.at(i));
     this->mem_rsp_ports.at(i).bind(&l2cache_->MemRspPorts.at(i));
   }
+
+  // sample MSHR occupancy on the timeline
+  auto& timeline = Timeline::instance();
+  if (timeline.enabled()) {
+    auto l2cache = l2cache_.get();
+    timeline.add_counter(this->name(), "l2cache mshr", [l2cache]() { return l2cache->mshr_size(); });
+  }
 }
 
 Cluster::~Cluster() {
@@ -88,12 +109,43 @@ void Cluster::tick() {
   //--
 }
 
+void Cluster::bind_lower_cache(CacheSim* cache) {
+  if (L2_ENABLED) {
+    cache->bind_upper(l2cache_.get());
+  } else {
+    for (auto& socket : sockets_) {
+      socket->bind_lower_cache(cache);
+    }
+  }
+}
+
 void Cluster::attach_ram(RAM* ram) {
   for (auto& socket : sockets_) {
     socket->attach_ram(ram);
   }
 }
 
+void Cluster::attach_mem_replay(MemTraceReplayer* replayer) {
+  for (auto& socket : sockets_) {
+    socket->attach_mem_replay(replayer);
+  }
+}
+
+void Cluster::add_snoop_ports(std::vector<SimPort<MemReq>*>& ports, bool with_l2) const {
+  for (auto& socket : sockets_) {
+    socket->add_snoop_ports(ports);
+  }
+  if (with_l2 && L2_ENABLED) {
+    ports.push_back(&l2cache_->SnoopPort);
+  }
+}
+
+void Cluster::attach_dma_snoops(const std::vector<SimPort<MemReq>*>& ports) {
+  for (auto& socket : sockets_) {
+    socket->attach_dma_snoops(ports);
+  }
+}
+
 #ifdef VM_ENABLE
 void Cluster::set_satp(uint64_t satp) {
   for (auto& socket : sockets_) {
@@ -147,6 +199,19 @@ void Cluster::barrier(uint32_t bar_id, uint32_t count, uint32_t core_id) {
 
 Cluster::PerfStats Cluster::perf_stats() const {
   PerfStats perf_stats;
+  for (auto& socket : sockets_) {
+    auto socket_perf = socket->perf_stats();
+    perf_stats.icache += socket_perf.icache;
+    perf_stats.dcache += socket_perf.dcache;
+    perf_stats.lmem += socket_perf.lmem;
+    perf_stats.opc += socket_perf.opc;
+    perf_stats.issue += socket_perf.issue;
+    perf_stats.fetch += socket_perf.fetch;
+    perf_stats.dma += socket_perf.dma;
+  #ifdef EXT_TCU_ENABLE
+    perf_stats.tcu += socket_perf.tcu;
+  #endif
+  }
   perf_stats.l2cache = l2cache_->perf_stats();
   return perf_stats;
 }
\ No newline at end of file
@@ -29,7 +29,17 @@ class ProcessorImpl;
 class Cluster : public SimObject<Cluster> {
 public:
   struct PerfStats {
+    CacheSim::PerfStats icache;
+    CacheSim::PerfStats dcache;
     CacheSim::PerfStats l2cache;
+    LocalMem::PerfStats lmem;
+    OpcUnit::PerfStats opc;
+    Core::IssueStats issue;
+    Core::FetchStats fetch;
+    DmaEngine::PerfStats dma;
+  #ifdef EXT_TCU_ENABLE
+    TensorUnit::PerfStats tcu;
+  #endif
   };
 
   std::vector<SimPort<MemReq>> mem_req_ports;
@@ -55,8 +65,19 @@ public:
 
   void tick();
 
+  // register this level's caches as uppers of the given cache
+  void bind_lower_cache(CacheSim* cache);
+
   void attach_ram(RAM* ram);
 
+  void attach_mem_replay(MemTraceReplayer* replayer);
+
+  // collect the snoop ports of this level's data caches
+  void add_snoop_ports(std::vector<SimPort<MemReq>*>& ports, bool with_l2) const;
+
+  // caches to invalidate on the DMA engines' global writes
+  void attach_dma_snoops(const std::vector<SimPort<MemReq>*>& ports);
+
   #ifdef VM_ENABLE
   void set_satp(uint64_t satp);
   #endif
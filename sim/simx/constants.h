@@ -33,7 +33,7 @@ inline constexpr uint32_t MAX_NUM_CORES   = 1024;
 inline constexpr uint32_t MAX_NUM_WARPS   = 64;
 inline constexpr uint32_t MAX_NUM_REGS    = 32;
 inline constexpr uint32_t LOG_NUM_REGS    = 5;
-inline constexpr uint32_t NUM_SRC_REGS    = 3;
+inline constexpr uint32_t NUM_SRC_REGS    = 5;
 
 inline constexpr uint32_t LSU_WORD_SIZE   = (XLEN / 8);
 inline constexpr uint32_t LSU_CHANNELS    = NUM_LSU_LANES;
@@ -52,17 +52,253 @@ inline constexpr uint32_t L3_NUM_REQS     = NUM_CLUSTERS * L2_MEM_PORTS;
 inline constexpr uint32_t PER_ISSUE_WARPS = NUM_WARPS / ISSUE_WIDTH;
 inline constexpr uint32_t ISSUE_WIS_BITS  = log2ceil(PER_ISSUE_WARPS);
 
+// Cache Configuration
+#ifndef DCACHE_SECTOR_SIZE
+#define DCACHE_SECTOR_SIZE L1_LINE_SIZE   // bytes (line size: unsectored)
+#endif
+
+#ifndef L2_SECTOR_SIZE
+#define L2_SECTOR_SIZE MEM_BLOCK_SIZE
+#endif
+
+#ifndef L3_SECTOR_SIZE
+#define L3_SECTOR_SIZE MEM_BLOCK_SIZE
+#endif
+
+#ifndef ICACHE_VICTIM_SIZE
+#define ICACHE_VICTIM_SIZE 0    // victim buffer entries (0: disabled)
+#endif
+
+#ifndef DCACHE_VICTIM_SIZE
+#define DCACHE_VICTIM_SIZE 0
+#endif
+
+#ifndef L2_VICTIM_SIZE
+#define L2_VICTIM_SIZE 0
+#endif
+
+#ifndef L3_VICTIM_SIZE
+#define L3_VICTIM_SIZE 0
+#endif
+
+// inclusion policy wrt the upper cache levels (0: NINE, 1: inclusive, 2: exclusive)
+#ifndef L2_INCLUSION
+#define L2_INCLUSION 0
+#endif
+
+#ifndef L3_INCLUSION
+#define L3_INCLUSION 0
+#endif
+
+// MSHR targets per entry (0: one entry per request)
+#ifndef DCACHE_MSHR_TARGETS
+#define DCACHE_MSHR_TARGETS 0
+#endif
+
+#ifndef L2_MSHR_TARGETS
+#define L2_MSHR_TARGETS 0
+#endif
+
+#ifndef L3_MSHR_TARGETS
+#define L3_MSHR_TARGETS 0
+#endif
+
+// single MSHR file shared by all cache banks
+#ifndef DCACHE_MSHR_SHARED
+#define DCACHE_MSHR_SHARED 0
+#endif
+
+#ifndef L2_MSHR_SHARED
+#define L2_MSHR_SHARED 0
+#endif
+
+#ifndef L3_MSHR_SHARED
+#define L3_MSHR_SHARED 0
+#endif
+
+// address hashing (0: linear, 1: xor, 2: prime modulo, 3: skewed)
+#ifndef DCACHE_BANK_HASH
+#define DCACHE_BANK_HASH 0
+#endif
+
+#ifndef DCACHE_SET_HASH
+#define DCACHE_SET_HASH 0
+#endif
+
+#ifndef L2_BANK_HASH
+#define L2_BANK_HASH 0
+#endif
+
+#ifndef L2_SET_HASH
+#define L2_SET_HASH 0
+#endif
+
+#ifndef L3_BANK_HASH
+#define L3_BANK_HASH 0
+#endif
+
+#ifndef L3_SET_HASH
+#define L3_SET_HASH 0
+#endif
+
+#ifndef LMEM_BANK_HASH
+#define LMEM_BANK_HASH 0
+#endif
+
+#ifndef MEM_BANK_HASH
+#define MEM_BANK_HASH 0
+#endif
+
+// Local Memory Configuration
+#ifndef LMEM_NUM_PORTS
+#define LMEM_NUM_PORTS 1        // bank ports (2: double-pumped banks)
+#endif
+
+#ifndef LMEM_BROADCAST
+#define LMEM_BROADCAST 0        // same-word reads are broadcast to all lanes
+#endif
+
+// Operand Collector Configuration
+#ifndef OPC_NUM_CUS
+#define OPC_NUM_CUS 1           // collector units per operand collector
+#endif
+
+#ifndef GPR_BANK_PORTS
+#define GPR_BANK_PORTS 1        // read ports per register file bank
+#endif
+
+#ifndef OPC_RF_CACHE_SIZE
+#define OPC_RF_CACHE_SIZE 0     // register file cache entries per operand collector
+#endif
+
+// Issue Configuration
+#ifndef WARP_ISSUE_WIDTH
+#define WARP_ISSUE_WIDTH 1      // instructions a warp can issue per cycle
+#endif
+
+// Warp Scheduler Configuration
+// (0: lowest index, 1: loose round-robin, 2: greedy-then-oldest, 3: two-level, 4: CCWS)
+#ifndef SCHEDULE_POLICY
+#define SCHEDULE_POLICY 0       // schedule stage warp selection
+#endif
+
+#ifndef ISSUE_POLICY
+#define ISSUE_POLICY 1          // issue stage ibuffer selection
+#endif
+
+#ifndef SCHED_ACTIVE_WARPS
+#define SCHED_ACTIVE_WARPS 0    // two-level active set size (0: half of the warps)
+#endif
+
+#ifndef CCWS_VTA_SIZE
+#define CCWS_VTA_SIZE 8         // victim tag entries per warp
+#endif
+
+#ifndef CCWS_LLS_SCORE
+#define CCWS_LLS_SCORE 64       // lost-locality score base and increment
+#endif
+
+// Front-end Configuration
+#ifndef FETCH_QUEUE_SIZE
+#define FETCH_QUEUE_SIZE 1      // instructions per warp in flight between schedule and decode
+#endif
+
+#ifndef BPRED_TYPE
+#define BPRED_TYPE 0            // 0: none (stall until resolved), 1: static not-taken, 2: bimodal
+#endif
+
+#ifndef BPRED_BTB_SIZE
+#define BPRED_BTB_SIZE 64
+#endif
+
+#ifndef BPRED_BHT_SIZE
+#define BPRED_BHT_SIZE 256
+#endif
+
+#ifndef BPRED_MISS_PENALTY
+#define BPRED_MISS_PENALTY 2    // redirect cycles after a mispredicted branch resolves
+#endif
+
+#ifndef ICACHE_PREFETCH_DEGREE
+#define ICACHE_PREFETCH_DEGREE 0  // next-line prefetches per new demand line (0: disabled)
+#endif
+
+#ifndef ICACHE_PREFETCH_TABLE
+#define ICACHE_PREFETCH_TABLE 16  // recently prefetched lines tracked for usefulness
+#endif
+
+#ifndef LOOP_BUFFER_SIZE
+#define LOOP_BUFFER_SIZE 0      // instructions (0: disabled)
+#endif
+
 // DMA Engine Configuration
 #ifndef DMA_QUEUE_SIZE
 #define DMA_QUEUE_SIZE 8
 #endif
 
 #ifndef DMA_BANDWIDTH
-#define DMA_BANDWIDTH 64        // bytes per cycle (1 cache line)
+#define DMA_BANDWIDTH 64        // max bytes per memory request
+#endif
+
+#ifndef DMA_MAX_PENDING
+#define DMA_MAX_PENDING 16      // outstanding memory reads per engine
+#endif
+
+#ifndef DMA_SNOOP_LATENCY
+#define DMA_SNOOP_LATENCY 2     // cycles for a DMA write to invalidate cached copies
+#endif
+
+#ifndef DMA_MAX_CHAINS
+#define DMA_MAX_CHAINS 4        // active descriptor chains per engine
 #endif
 
 #ifndef DMA_STARTUP_LATENCY
 #define DMA_STARTUP_LATENCY 2   // cycles (reduced for faster small transfers)
 #endif
 
+// Tensor Core Unit timing
+#ifndef TCU_FMUL_LATENCY
+#define TCU_FMUL_LATENCY 3      // fp multiply + rounding stage
+#endif
+
+#ifndef TCU_FADD_LATENCY
+#define TCU_FADD_LATENCY 3      // fp adder + rounding stage (per tree level)
+#endif
+
+#ifndef TCU_IMUL_LATENCY
+#define TCU_IMUL_LATENCY 2      // integer multiply stage
+#endif
+
+#ifndef TCU_IADD_LATENCY
+#define TCU_IADD_LATENCY 1      // integer adder stage (per tree level)
+#endif
+
+#ifndef TCU_FP16_II
+#define TCU_FP16_II 1           // cycles between fp16 WMMA uops per block
+#endif
+
+#ifndef TCU_BF16_II
+#define TCU_BF16_II 1           // cycles between bf16 WMMA uops per block
+#endif
+
+#ifndef TCU_FP8_II
+#define TCU_FP8_II 1            // cycles between fp8/bf8 WMMA uops per block
+#endif
+
+#ifndef TCU_INT8_II
+#define TCU_INT8_II 1           // cycles between int8/uint8 WMMA uops per block
+#endif
+
+#ifndef TCU_INT4_II
+#define TCU_INT4_II 1           // cycles between int4/uint4 WMMA uops per block
+#endif
+
+#ifndef TCU_RF_PORTS
+#define TCU_RF_PORTS 3          // operand registers read per cycle per block
+#endif
+
+#ifndef TCU_ACC_FWD
+#define TCU_ACC_FWD 1           // forward partial sums between K steps (0: disabled)
+#endif
+
 } // namespace vortex
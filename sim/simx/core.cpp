@@ -13,6 +13,7 @@
 
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 #include <string.h>
 #include <assert.h>
 #include <util.h>
@@ -48,14 +49,26 @@ Core::Core(const SimContext& ctx,
   , emulator_(arch, dcrs, this)
   , ibuffers_(arch.num_warps(), IBUF_SIZE)
   , scoreboard_(arch_)
+  , rf_banks_(NUM_GPR_BANKS, GPR_BANK_PORTS)
+#ifdef EXT_V_ENABLE
+  , vrf_banks_(NUM_GPR_BANKS, GPR_BANK_PORTS)
+#endif
   , operands_(ISSUE_WIDTH)
   , dispatchers_((uint32_t)FUType::Count)
   , func_units_((uint32_t)FUType::Count)
   , lmem_switch_(NUM_LSU_BLOCKS)
   , mem_coalescers_(NUM_LSU_BLOCKS)
-  , pending_icache_(arch_.num_warps())
+  , pending_icache_(arch_.num_warps() * FETCH_QUEUE_SIZE + ICACHE_PREFETCH_DEGREE)
+  , fetch_queues_(arch_.num_warps())
+  , fetch_counts_(arch_.num_warps())
+  , bpred_({BPredType(BPRED_TYPE), BPRED_BTB_SIZE, BPRED_BHT_SIZE})
+  , branch_warps_(arch_.num_warps())
+  , lbuf_valid_(std::max<uint32_t>(LOOP_BUFFER_SIZE, 1))
+  , pc_profiler_(PcProfiler::instance().enabled() ? &PcProfiler::instance() : nullptr)
+  , lsu_pcs_(arch_.num_warps(), 0)
+  , mem_replay_(nullptr)
+  , fu_busy_((uint32_t)FUType::Count, 0)
   , commit_arbs_(ISSUE_WIDTH)
-  , ibuffer_arbs_(ISSUE_WIDTH, {ArbiterType::RoundRobin, PER_ISSUE_WARPS})
 {
   char sname[100];
 
@@ -63,6 +76,18 @@ Core::Core(const SimContext& ctx,
     operands_.at(iw) = Operands::Create(this);
   }
 
+  // create the issue schedulers
+  ibuffer_scheds_.reserve(ISSUE_WIDTH);
+  for (uint32_t iw = 0; iw < ISSUE_WIDTH; ++iw) {
+    ibuffer_scheds_.emplace_back(WarpScheduler::Config{
+      WarpSchedType(ISSUE_POLICY),
+      PER_ISSUE_WARPS,
+      SCHED_ACTIVE_WARPS,
+      CCWS_VTA_SIZE,
+      CCWS_LLS_SCORE
+    });
+  }
+
   // create the memory coalescer
   for (uint32_t b = 0; b < NUM_LSU_BLOCKS; ++b) {
     snprintf(sname, 100, "%s-coalescer%d", this->name().c_str(), b);
@@ -76,7 +101,10 @@ Core::Core(const SimContext& ctx,
     LSU_WORD_SIZE,
     LSU_CHANNELS,
     log2ceil(LMEM_NUM_BANKS),
-    false
+    false,
+    HashType(LMEM_BANK_HASH),
+    LMEM_NUM_PORTS,
+    LMEM_BROADCAST
   });
 
   // create lmem switch
@@ -175,8 +203,25 @@ Core::Core(const SimContext& ctx,
   dma_config.bandwidth = DMA_BANDWIDTH;
   dma_config.startup_latency = DMA_STARTUP_LATENCY;
   dma_config.num_channels = 4;
+  dma_config.max_pending = DMA_MAX_PENDING;
+  dma_config.snoop_latency = DMA_SNOOP_LATENCY;
+  dma_config.num_groups = DMA_NUM_GROUPS;
+  dma_config.max_chains = DMA_MAX_CHAINS;
   dma_engine_ = DmaEngine::Create(sname, dma_config);
 
+  // register timeline tracks
+  auto& timeline = Timeline::instance();
+  if (timeline.enabled()) {
+    for (uint32_t w = 0; w < arch_.num_warps(); ++w) {
+      warp_tracks_.push_back(timeline.add_track(this->name(), StrFormat("warp%d", w)));
+    }
+    for (uint32_t fu = 0; fu < (uint32_t)FUType::Count; ++fu) {
+      std::stringstream ss;
+      ss << (FUType)fu << " busy";
+      timeline.add_counter(this->name(), ss.str(), [this, fu]() { return fu_busy_.at(fu); });
+    }
+  }
+
   this->reset();
 }
 
@@ -201,21 +246,53 @@ void Core::reset() {
   }
 
   scoreboard_.reset();
+  rf_banks_.reset();
+#ifdef EXT_V_ENABLE
+  vrf_banks_.reset();
+#endif
   fetch_latch_.reset();
   decode_latch_.reset();
   pending_icache_.clear();
 
-  for (auto& arb : ibuffer_arbs_) {
-    arb.reset();
+  for (auto& fetch_queue : fetch_queues_) {
+    fetch_queue.clear();
+  }
+  std::fill(fetch_counts_.begin(), fetch_counts_.end(), 0);
+  num_throttled_ = 0;
+  bpred_.reset();
+  branch_warps_.reset();
+  redirects_.clear();
+
+  prefetch_queue_.clear();
+  prefetch_table_.clear();
+  pending_prefetches_ = 0;
+  last_fetch_line_ = Word(-1);
+
+  lbuf_start_ = 0;
+  lbuf_end_ = 0;
+  lbuf_valid_.reset();
+
+  for (auto& sched : ibuffer_scheds_) {
+    sched.reset();
   }
 
   pending_instrs_.clear();
   pending_ifetches_ = 0;
 
+  std::fill(fu_busy_.begin(), fu_busy_.end(), 0);
+
   perf_stats_ = PerfStats();
+  issue_stats_ = IssueStats();
+  fetch_stats_ = FetchStats();
 }
 
 void Core::tick() {
+  if (mem_replay_) {
+    // the LSU is driven by the memory trace
+    ++perf_stats_.cycles;
+    return;
+  }
+
   this->commit();
   this->execute();
   this->issue();
@@ -223,29 +300,81 @@ void Core::tick() {
   this->fetch();
   this->schedule();
 
-  // tick DMA engine
-  if (dma_engine_) {
-    dma_engine_->tick();
-  }
-
   ++perf_stats_.cycles;
   DPN(2, std::flush);
 }
 
 void Core::schedule() {
+  // release warps redirected after a misprediction
+  for (auto it = redirects_.begin(); it != redirects_.end();) {
+    if (it->second > SimPlatform::instance().cycles()) {
+      ++it;
+      continue;
+    }
+    branch_warps_.reset(it->first);
+    emulator_.resume(it->first);
+    it = redirects_.erase(it);
+  }
+
   auto trace = emulator_.step();
   if (trace == nullptr) {
     ++perf_stats_.sched_idle;
+    fetch_stats_.queue_stalls += (num_throttled_ != 0);
+    fetch_stats_.branch_stalls += branch_warps_.any();
     return;
   }
 
-  // suspend warp until decode
-  emulator_.suspend(trace->wid);
+  auto wid = trace->wid;
+
+  // throttle the warp once its fetch queue is full
+  if (++fetch_counts_.at(wid) == FETCH_QUEUE_SIZE) {
+    emulator_.throttle(wid, true);
+    ++num_throttled_;
+  }
+
+  // a correctly predicted branch does not stall fetch
+  if (trace->fetch_stall) {
+    auto br_type = std::get_if<BrType>(&trace->op_type);
+    if (br_type && *br_type != BrType::SYS) {
+      auto next_pc = emulator_.get_pc(wid);
+      bool taken = (next_pc != trace->PC + 4);
+      // capture short backward loops into the loop buffer
+      if (LOOP_BUFFER_SIZE != 0 && taken && *br_type != BrType::JALR
+       && next_pc < trace->PC && ((trace->PC - next_pc) / 4 + 1) <= LOOP_BUFFER_SIZE
+       && (next_pc != lbuf_start_ || trace->PC != lbuf_end_)) {
+        DT(3, "loop-buffer-capture: start=0x" << std::hex << next_pc << ", end=0x" << trace->PC << std::dec);
+        lbuf_start_ = next_pc;
+        lbuf_end_ = trace->PC;
+        lbuf_valid_.reset();
+      }
+      if (bpred_.predict(trace->PC, (*br_type == BrType::BR), taken, next_pc)) {
+        trace->fetch_stall = false;
+      } else {
+        DT(3, "branch-mispredict: taken=" << taken << ", target=0x" << std::hex << next_pc << std::dec << ", " << *trace);
+        branch_warps_.set(wid);
+      }
+    }
+  }
+
+  // profile divergent splits
+  if (pc_profiler_) {
+    auto wctl_type = std::get_if<WctlType>(&trace->op_type);
+    if (wctl_type && *wctl_type == WctlType::SPLIT
+     && emulator_.get_tmask(wid) != trace->tmask) {
+      pc_profiler_->divergence(trace->PC);
+    }
+  }
+
+  // suspend warp until the control instruction resolves
+  if (trace->fetch_stall) {
+    emulator_.suspend(wid);
+  }
 
   DT(3, "pipeline-schedule: " << *trace);
 
   // advance to fetch stage
   fetch_latch_.push(trace);
+  fetch_queues_.at(wid).push_back({trace, false});
   pending_instrs_.push_back(trace);
 }
 
@@ -257,17 +386,62 @@ void Core::fetch() {
   if (!icache_rsp_port.empty()){
     auto& mem_rsp = icache_rsp_port.front();
     auto trace = pending_icache_.at(mem_rsp.tag);
-    decode_latch_.push(trace);
-    DT(3, "icache-rsp: addr=0x" << std::hex << trace->PC << ", tag=0x" << mem_rsp.tag << std::dec << ", " << *trace);
+    if (trace) {
+      DT(3, "icache-rsp: addr=0x" << std::hex << trace->PC << ", tag=0x" << mem_rsp.tag << std::dec << ", " << *trace);
+      // fill the loop buffer
+      if (LOOP_BUFFER_SIZE != 0 && trace->PC >= lbuf_start_ && trace->PC <= lbuf_end_) {
+        lbuf_valid_.set((trace->PC - lbuf_start_) / 4);
+      }
+      this->fetch_done(trace);
+      --pending_ifetches_;
+    } else {
+      DT(3, "icache-prefetch-rsp: tag=0x" << std::hex << mem_rsp.tag << std::dec);
+      --pending_prefetches_;
+    }
     pending_icache_.release(mem_rsp.tag);
     icache_rsp_port.pop();
-    --pending_ifetches_;
   }
 
-  // send icache request
-  if (fetch_latch_.empty())
+  if (fetch_latch_.empty()) {
+    // use the idle request slot for prefetching
+    if (!prefetch_queue_.empty() && pending_prefetches_ != ICACHE_PREFETCH_DEGREE) {
+      this->icache_prefetch(prefetch_queue_.front());
+      prefetch_queue_.pop_front();
+    }
     return;
+  }
   auto trace = fetch_latch_.front();
+
+  // serve tight loops from the loop buffer
+  if (LOOP_BUFFER_SIZE != 0
+   && trace->PC >= lbuf_start_ && trace->PC <= lbuf_end_
+   && lbuf_valid_.test((trace->PC - lbuf_start_) / 4)) {
+    DT(3, "loop-buffer-hit: addr=0x" << std::hex << trace->PC << std::dec << ", " << *trace);
+    this->fetch_done(trace);
+    fetch_latch_.pop();
+    ++fetch_stats_.lbuf_hits;
+    return;
+  }
+
+  // next-line prefetch on entering a new line
+  Word line_addr = trace->PC & ~Word(L1_LINE_SIZE - 1);
+  if (ICACHE_PREFETCH_DEGREE != 0 && line_addr != last_fetch_line_) {
+    last_fetch_line_ = line_addr;
+    auto it = std::find(prefetch_table_.begin(), prefetch_table_.end(), line_addr);
+    if (it != prefetch_table_.end()) {
+      prefetch_table_.erase(it);
+      ++fetch_stats_.prefetch_hits;
+    }
+    prefetch_queue_.clear();
+    for (uint32_t i = 1; i <= ICACHE_PREFETCH_DEGREE; ++i) {
+      Word pf_addr = line_addr + i * L1_LINE_SIZE;
+      if (std::find(prefetch_table_.begin(), prefetch_table_.end(), pf_addr) == prefetch_table_.end()) {
+        prefetch_queue_.push_back(pf_addr);
+      }
+    }
+  }
+
+  // send icache request
   MemReq mem_req;
   mem_req.addr  = trace->PC;
   mem_req.write = false;
@@ -281,6 +455,38 @@ void Core::fetch() {
   ++pending_ifetches_;
 }
 
+void Core::fetch_done(instr_trace_t* trace) {
+  // forward to decode in program order
+  auto& fetch_queue = fetch_queues_.at(trace->wid);
+  for (auto& entry : fetch_queue) {
+    if (entry.trace == trace) {
+      entry.ready = true;
+      break;
+    }
+  }
+  while (!fetch_queue.empty() && fetch_queue.front().ready) {
+    decode_latch_.push(fetch_queue.front().trace);
+    fetch_queue.pop_front();
+  }
+}
+
+void Core::icache_prefetch(Word addr) {
+  MemReq mem_req;
+  mem_req.addr  = addr;
+  mem_req.write = false;
+  mem_req.tag   = pending_icache_.allocate(nullptr);
+  mem_req.cid   = core_id_;
+  mem_req.uuid  = 0;
+  icache_req_ports.at(0).push(mem_req, 2);
+  DT(3, "icache-prefetch: addr=0x" << std::hex << addr << ", tag=0x" << mem_req.tag << std::dec);
+  prefetch_table_.push_back(addr);
+  if (prefetch_table_.size() > ICACHE_PREFETCH_TABLE) {
+    prefetch_table_.pop_front();
+  }
+  ++pending_prefetches_;
+  ++fetch_stats_.prefetches;
+}
+
 void Core::decode() {
   if (decode_latch_.empty())
     return;
@@ -294,14 +500,18 @@ void Core::decode() {
       DT(4, "*** ibuffer-stall: " << *trace);
     }
     ++perf_stats_.ibuf_stalls;
+    if (pc_profiler_) {
+      pc_profiler_->stall(trace->PC, PcStall::IBuf);
+    }
     return;
   } else {
     trace->log_once(false);
   }
 
-  // release warp
-  if (!trace->fetch_stall) {
-    emulator_.resume(trace->wid);
+  // release the fetch queue slot
+  if (fetch_counts_.at(trace->wid)-- == FETCH_QUEUE_SIZE) {
+    emulator_.throttle(trace->wid, false);
+    --num_throttled_;
   }
 
   DT(3, "pipeline-decode: " << *trace);
@@ -316,11 +526,13 @@ void Core::issue() {
   // dispatch operands
   for (uint32_t iw = 0; iw < ISSUE_WIDTH; ++iw) {
     auto& operand = operands_.at(iw);
-    if (operand->Output.empty())
-      continue;
-    auto trace = operand->Output.front();
-    dispatchers_.at((int)trace->fu_type)->Inputs.at(iw).push(trace);
-    operand->Output.pop();
+    for (auto& output : operand->Outputs) {
+      if (output.empty())
+        continue;
+      auto trace = output.front();
+      dispatchers_.at((int)trace->fu_type)->Inputs.at(iw).push(trace);
+      output.pop();
+    }
   }
 
   // issue ibuffer instructions
@@ -330,25 +542,27 @@ void Core::issue() {
     for (uint32_t w = 0; w < PER_ISSUE_WARPS; ++w) {
       uint32_t wid = w * ISSUE_WIDTH + iw;
       auto& ibuffer = ibuffers_.at(wid);
-      if (ibuffer.empty())
+      if (ibuffer.empty()) {
+        this->set_warp_state(wid, nullptr);
         continue;
+      }
       // check scoreboard
       has_instrs = true;
       auto trace = ibuffer.top();
       if (scoreboard_.in_use(trace)) {
-        auto uses = scoreboard_.get_uses(trace);
+      #ifndef NDEBUG
         if (!trace->log_once(true)) {
           DTH(4, "*** scoreboard-stall: dependents={");
-          for (uint32_t j = 0, n = uses.size(); j < n; ++j) {
-            auto& use = uses.at(j);
+          uint32_t j = 0;
+          scoreboard_.for_each_use(trace, [&](const Scoreboard::reg_use_t& use) {
             __unused (use);
-            if (j) DTN(4, ", ");
+            if (j++) DTN(4, ", ");
             DTN(4, use.reg_type << use.reg_id << " (#" << use.uuid << ")");
-          }
+          });
           DTN(4, "}, " << *trace << std::endl);
         }
-        for (uint32_t j = 0, n = uses.size(); j < n; ++j) {
-          auto& use = uses.at(j);
+      #endif
+        scoreboard_.for_each_use(trace, [&](const Scoreboard::reg_use_t& use) {
           switch (use.fu_type) {
           case FUType::ALU: ++perf_stats_.scrb_alu; break;
           case FUType::FPU: ++perf_stats_.scrb_fpu; break;
@@ -369,27 +583,73 @@ void Core::issue() {
         #endif
           default: assert(false);
           }
+        });
+        if (pc_profiler_) {
+          // attribute to pending loads first, then CSR/warp-control results
+          auto reason = PcStall::Dep;
+          scoreboard_.for_each_use(trace, [&](const Scoreboard::reg_use_t& use) {
+            if (use.fu_type == FUType::LSU) {
+              reason = PcStall::Mem;
+            } else if (use.fu_type == FUType::SFU && reason != PcStall::Mem) {
+              reason = PcStall::Sync;
+            }
+          });
+          pc_profiler_->stall(trace->PC, reason);
         }
+        this->set_warp_state(wid, "stall");
       } else {
         trace->log_once(false);
         ready_set.set(w); // mark instruction as ready
+        this->set_warp_state(wid, "ready");
       }
     }
 
     if (ready_set.any()) {
-      // select one instruction from ready set
-      auto w = ibuffer_arbs_.at(iw).grant(ready_set);
+      // select one warp from ready set
+      auto w = ibuffer_scheds_.at(iw).select(ready_set);
       uint32_t wid = w * ISSUE_WIDTH + iw;
       auto& ibuffer = ibuffers_.at(wid);
-      auto trace = ibuffer.top();
-      // update scoreboard
-      DT(3, "pipeline-ibuffer: " << *trace);
-      if (trace->wb) {
-        scoreboard_.reserve(trace);
+      // issue in order up to WARP_ISSUE_WIDTH independent instructions
+      // on distinct functional units
+      uint32_t fu_mask = 0;
+      uint32_t num_issued = 0;
+      for (;;) {
+        auto trace = ibuffer.top();
+        // update scoreboard
+        DT(3, "pipeline-ibuffer: " << *trace);
+        if (trace->wb) {
+          scoreboard_.reserve(trace);
+        }
+        // to operand stage
+        operands_.at(iw)->Inputs.at(num_issued).push(trace, 1);
+        ibuffer.pop();
+        fu_mask |= (1 << (int)trace->fu_type);
+        ++fu_busy_.at((int)trace->fu_type);
+        ++num_issued;
+        if (pc_profiler_) {
+          pc_profiler_->issue(trace->PC, trace->tmask.count());
+          if (trace->fu_type == FUType::LSU) {
+            lsu_pcs_.at(wid) = trace->PC;
+          }
+        }
+
+        if (ibuffer.empty())
+          break;
+        auto next = ibuffer.top();
+        if (scoreboard_.in_use(next)) {
+          issue_stats_.dep_stalls += (num_issued == 1);
+          break;
+        }
+        if (fu_mask & (1 << (int)next->fu_type)) {
+          issue_stats_.fu_conflicts += (num_issued == 1);
+          break;
+        }
+        issue_stats_.opportunities += (num_issued == 1);
+        if (num_issued == WARP_ISSUE_WIDTH)
+          break;
       }
-      // to operand stage
-      operands_.at(iw)->Input.push(trace, 1);
-      ibuffer.pop();
+      issue_stats_.multi_issues += (num_issued > 1);
+      this->set_warp_state(wid, "issue");
     }
 
     // track scoreboard stalls
@@ -423,6 +683,7 @@ void Core::commit() {
 
     // advance to commit stage
     DT(3, "pipeline-commit: " << *trace);
+    --fu_busy_.at((int)trace->fu_type);
     assert(trace->cid == core_id_);
 
     // update scoreboard
@@ -431,9 +692,7 @@ void Core::commit() {
         operands_.at(iw)->writeback(trace);
         scoreboard_.release(trace);
       }
-      auto orig_size = pending_instrs_.size();
-      pending_instrs_.remove(trace);
-      if (pending_instrs_.size() != orig_size) {
+      if (pending_instrs_.remove(trace)) {
         perf_stats_.instrs += trace->tmask.count();
       #ifdef EXT_V_ENABLE
         if (std::get_if<VsetType>(&trace->op_type)
@@ -457,9 +716,12 @@ int Core::get_exitcode() const {
 }
 
 bool Core::running() const {
+  if (mem_replay_) {
+    return !mem_replay_->done(core_id_);
+  }
   if (emulator_.running() || !pending_instrs_.empty()) {
   #ifndef NDEBUG
-    for (auto& trace : pending_instrs_) {
+    for (auto trace = pending_instrs_.front(); trace; trace = trace->pending_next) {
       DT(5, "pipeline-pending: " << *trace);
     }
   #endif
@@ -469,13 +731,37 @@ bool Core::running() const {
 }
 
 void Core::resume(uint32_t wid) {
+  if (wid < branch_warps_.size() && branch_warps_.test(wid)) {
+    // redirect fetch after a mispredicted branch
+    if (bpred_.type() != BPredType::None && BPRED_MISS_PENALTY != 0) {
+      redirects_.emplace_back(wid, SimPlatform::instance().cycles() + BPRED_MISS_PENALTY);
+      return;
+    }
+    branch_warps_.reset(wid);
+  } else if (wid == 0xffffffff) {
+    // global release also cancels pending redirects
+    branch_warps_.reset();
+    redirects_.clear();
+  }
   emulator_.resume(wid);
 }
 
+void Core::dcache_miss(uint32_t wid, uint64_t addr) {
+  if (pc_profiler_) {
+    pc_profiler_->dcache_miss(lsu_pcs_.at(wid));
+  }
+  emulator_.dcache_miss(wid, addr);
+  ibuffer_scheds_.at(wid % ISSUE_WIDTH).dcache_miss(wid / ISSUE_WIDTH, addr);
+}
+
 bool Core::barrier(uint32_t bar_id, uint32_t count, uint32_t wid) {
   return emulator_.barrier(bar_id, count, wid);
 }
 
+void Core::barrier_signal(uint32_t bar_id) {
+  emulator_.barrier_signal(bar_id);
+}
+
 bool Core::wspawn(uint32_t num_warps, Word nextPC) {
   return emulator_.wspawn(num_warps, nextPC);
 }
@@ -490,6 +776,10 @@ void Core::attach_ram(RAM* ram) {
   }
 }
 
+void Core::attach_mem_replay(MemTraceReplayer* replayer) {
+  mem_replay_ = replayer;
+}
+
 const Core::PerfStats& Core::perf_stats() const {
   perf_stats_.opds_stalls = 0;
   for (uint32_t iw = 0; iw < ISSUE_WIDTH; ++iw) {
@@ -498,6 +788,24 @@ const Core::PerfStats& Core::perf_stats() const {
   return perf_stats_;
 }
 
+Core::FetchStats Core::fetch_stats() const {
+  auto stats = fetch_stats_;
+  auto& bpred = bpred_.perf_stats();
+  stats.branches = bpred.branches;
+  stats.mispredicts = bpred.mispredicts;
+  stats.btb_misses = bpred.btb_misses;
+  stats.resolve_stalls = bpred.resolve_stalls;
+  return stats;
+}
+
+OpcUnit::PerfStats Core::opc_perf_stats() const {
+  OpcUnit::PerfStats perf;
+  for (uint32_t iw = 0; iw < ISSUE_WIDTH; ++iw) {
+    perf += operands_.at(iw)->perf_stats();
+  }
+  return perf;
+}
+
 #ifdef VM_ENABLE
 void Core::set_satp(uint64_t satp) {
   emulator_.set_satp(satp); //JAEWON wit, tid???
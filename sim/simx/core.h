@@ -14,6 +14,7 @@
 #pragma once
 
 #include <vector>
+#include <deque>
 #include <simobject.h>
 #include "types.h"
 #include "emulator.h"
@@ -22,6 +23,10 @@
 #include "local_mem.h"
 #include "ibuffer.h"
 #include "scoreboard.h"
+#include "bpred.h"
+#include "pc_profiler.h"
+#include "mem_trace.h"
+#include "timeline.h"
 
 #ifdef EXT_V_ENABLE
 #include "voperands.h"
@@ -44,6 +49,65 @@ class DCRS;
 
 class Core : public SimObject<Core> {
 public:
+  struct IssueStats {
+    uint64_t multi_issues;  // cycles a warp issued more than one instruction
+    uint64_t opportunities; // cycles the next instruction was independent on another unit
+    uint64_t fu_conflicts;  // next instruction independent but on the same unit
+    uint64_t dep_stalls;    // next instruction dependent on the issued ones
+
+    IssueStats()
+      : multi_issues(0)
+      , opportunities(0)
+      , fu_conflicts(0)
+      , dep_stalls(0)
+    {}
+
+    IssueStats& operator+=(const IssueStats& rhs) {
+      this->multi_issues += rhs.multi_issues;
+      this->opportunities += rhs.opportunities;
+      this->fu_conflicts += rhs.fu_conflicts;
+      this->dep_stalls += rhs.dep_stalls;
+      return *this;
+    }
+  };
+
+  struct FetchStats {
+    uint64_t branches;      // control transfers seen by the predictor
+    uint64_t mispredicts;
+    uint64_t btb_misses;
+    uint64_t resolve_stalls; // unpredicted transfers (BPredType::None)
+    uint64_t queue_stalls;  // idle schedule cycles with a full warp fetch queue
+    uint64_t branch_stalls; // idle schedule cycles with a warp waiting on a branch
+    uint64_t lbuf_hits;     // fetches served by the loop buffer
+    uint64_t prefetches;    // next-line icache prefetches issued
+    uint64_t prefetch_hits; // demand fetches to a previously prefetched line
+
+    FetchStats()
+      : branches(0)
+      , mispredicts(0)
+      , btb_misses(0)
+      , resolve_stalls(0)
+      , queue_stalls(0)
+      , branch_stalls(0)
+      , lbuf_hits(0)
+      , prefetches(0)
+      , prefetch_hits(0)
+    {}
+
+    FetchStats& operator+=(const FetchStats& rhs) {
+      this->branches += rhs.branches;
+      this->mispredicts += rhs.mispredicts;
+      this->btb_misses += rhs.btb_misses;
+      this->resolve_stalls += rhs.resolve_stalls;
+      this->queue_stalls += rhs.queue_stalls;
+      this->branch_stalls += rhs.branch_stalls;
+      this->lbuf_hits += rhs.lbuf_hits;
+      this->prefetches += rhs.prefetches;
+      this->prefetch_hits += rhs.prefetch_hits;
+      return *this;
+    }
+  };
+
   struct PerfStats {
     uint64_t cycles;
     uint64_t instrs;
@@ -124,12 +188,19 @@ public:
   void set_satp(uint64_t satp);
 #endif
 
+  // replace instruction execution with a recorded memory trace (nullptr to detach)
+  void attach_mem_replay(MemTraceReplayer* replayer);
+
   bool running() const;
 
   void resume(uint32_t wid);
 
+  void dcache_miss(uint32_t wid, uint64_t addr);
+
   bool barrier(uint32_t bar_id, uint32_t count, uint32_t wid);
 
+  void barrier_signal(uint32_t bar_id);
+
   bool wspawn(uint32_t num_warps, Word nextPC);
 
   uint32_t id() const {
@@ -180,14 +251,45 @@ public:
     return trace_pool_;
   }
 
+  RegFileBanks* rf_banks() {
+    return &rf_banks_;
+  }
+
+#ifdef EXT_V_ENABLE
+  RegFileBanks* vrf_banks() {
+    return &vrf_banks_;
+  }
+#endif
+
   const PerfStats& perf_stats() const;
 
+  OpcUnit::PerfStats opc_perf_stats() const;
+
+  const IssueStats& issue_stats() const {
+    return issue_stats_;
+  }
+
+  FetchStats fetch_stats() const;
+
   int get_exitcode() const;
 
 private:
 
+  struct fetch_entry_t {
+    instr_trace_t* trace;
+    bool ready;
+  };
+
+  void set_warp_state(uint32_t wid, const char* state) {
+    if (!warp_tracks_.empty()) {
+      Timeline::instance().set_state(warp_tracks_.at(wid), state);
+    }
+  }
+
   void schedule();
   void fetch();
+  void fetch_done(instr_trace_t* trace);
+  void icache_prefetch(Word addr);
   void decode();
   void issue();
   void execute();
@@ -209,6 +311,10 @@ private:
 
   std::vector<IBuffer> ibuffers_;
   Scoreboard scoreboard_;
+  RegFileBanks rf_banks_;
+#ifdef EXT_V_ENABLE
+  RegFileBanks vrf_banks_;
+#endif
   std::vector<Operands::Ptr> operands_;
   std::vector<Dispatcher::Ptr> dispatchers_;
   std::vector<FuncUnit::Ptr> func_units_;
@@ -221,16 +327,42 @@ private:
   PipelineLatch decode_latch_;
 
   HashTable<instr_trace_t*> pending_icache_;
-  std::list<instr_trace_t*, PoolAllocator<instr_trace_t*, 64>> pending_instrs_;
+  TraceList pending_instrs_;
+
+  std::vector<std::deque<fetch_entry_t>> fetch_queues_; // per-warp, in program order
+  std::vector<uint32_t> fetch_counts_;
+  uint32_t num_throttled_;
+  BranchPredictor bpred_;
+  BitVector<> branch_warps_; // warps waiting for a branch to resolve
+  std::vector<std::pair<uint32_t, uint64_t>> redirects_; // (wid, release cycle)
+
+  std::deque<Word> prefetch_queue_;  // line addresses waiting for a free icache slot
+  std::deque<Word> prefetch_table_;  // recently prefetched lines
+  uint32_t pending_prefetches_;
+  Word last_fetch_line_;
+
+  Word lbuf_start_;         // captured loop body [start, end]
+  Word lbuf_end_;
+  BitVector<> lbuf_valid_;
+
+  PcProfiler* pc_profiler_;  // nullptr when profiling is disabled
+  std::vector<Word> lsu_pcs_; // last memory instruction issued per warp
+
+  MemTraceReplayer* mem_replay_; // nullptr when executing instructions
+
+  std::vector<uint32_t> warp_tracks_; // timeline tracks (empty when disabled)
+  std::vector<uint32_t> fu_busy_;     // in-flight instructions per functional unit
 
   uint64_t pending_ifetches_;
 
   mutable PerfStats perf_stats_;
+  IssueStats issue_stats_;
+  FetchStats fetch_stats_;
 
   std::vector<TraceArbiter::Ptr> commit_arbs_;
 
   uint32_t commit_exe_;
-  std::vector<Arbiter> ibuffer_arbs_;
+  std::vector<WarpScheduler> ibuffer_scheds_;
 
   PoolAllocator<instr_trace_t, 64> trace_pool_;
 
@@ -488,6 +488,12 @@ static op_string_t op_string(const Instr &instr) {
       }
       case DmaType::WAIT:
         return {"DMA_WAIT", ""};
+      case DmaType::SET_PARAM:
+        return {"DMA_SET_PARAM", std::to_string(dmaArgs.param)};
+      case DmaType::CHAIN:
+        return {"DMA_CHAIN", ""};
+      case DmaType::WAIT_GROUP:
+        return {"DMA_WAIT_GROUP", ""};
       default:
         std::abort();
       }
@@ -1107,35 +1113,51 @@ void Emulator::decode(uint32_t code, uint32_t wid, uint64_t uuid) {
   #ifdef EXT_TCU_ENABLE
     case 2: {
       switch (funct3) {
-      case 0: { // WMMA
+      case 0:   // WMMA
+      case 1: { // WMMA_SP (2:4 sparse A)
         namespace vt = vortex::tensor;
         using cfg = vt::wmma_config_t<NUM_THREADS>;
+        bool sparse = (funct3 == 1);
+        auto tcu_type = sparse ? TcuType::WMMA_SP : TcuType::WMMA;
         uint32_t ra_base = 0;
         uint32_t rb_base = (cfg::NRB == 4) ? 28 : 10;
         uint32_t rc_base = (cfg::NRB == 4) ? 10 : 24;
+        uint32_t rm = rs2; // sparse A metadata
         uint32_t fmt_d = rd;
         uint32_t fmt_s = rs1;
+        // a sparse uop covers a K pair: its A register holds the kept values of
+        // both K steps, so it reads two B registers
+        uint32_t k_uops = sparse ? (cfg::k_steps / 2) : cfg::k_steps;
         uint32_t steps = 0;
-        uint32_t steps_count = cfg::m_steps * cfg::n_steps * cfg::k_steps;
+        uint32_t steps_count = cfg::m_steps * cfg::n_steps * k_uops;
         uint32_t steps_shift = 32 - log2ceil(steps_count);
         uint32_t uuid_hi = (uuid >> 32) & 0xffffffff;
         uint32_t uuid_lo = uuid & 0xffffffff;
-        for (uint32_t k = 0; k < cfg::k_steps; ++k) {
+        for (uint32_t k = 0; k < k_uops; ++k) {
           for (uint32_t m = 0; m < cfg::m_steps; ++m) {
             for (uint32_t n = 0; n < cfg::n_steps; ++n) {
-              uint32_t rs1 = ra_base + (m / cfg::a_sub_blocks) * cfg::k_steps + k;
-              uint32_t rs2 = rb_base + (k * cfg::n_steps + n) / cfg::b_sub_blocks;
+              uint32_t rs1 = ra_base + (m / cfg::a_sub_blocks) * k_uops + k;
               uint32_t rs3 = rc_base + m * cfg::n_steps + n;
               uint32_t uuid_lo_x = (steps << steps_shift) | uuid_lo;
               uint64_t uuid_x = (static_cast<uint64_t>(uuid_hi) << 32) | uuid_lo_x;
               ++steps;
               auto instr = std::allocate_shared<Instr>(instr_pool_, uuid_x, FUType::TCU);
-              instr->setOpType(TcuType::WMMA);
-              instr->setArgs(IntrTcuArgs{fmt_s, fmt_d, m, n});
+              instr->setOpType(tcu_type);
+              instr->setArgs(IntrTcuArgs{fmt_s, fmt_d, m, n, k});
               instr->setDestReg(rs3, RegType::Float);
               instr->setSrcReg(0, rs1, RegType::Float);
-              instr->setSrcReg(1, rs2, RegType::Float);
-              instr->setSrcReg(2, rs3, RegType::Float);
+              if (sparse) {
+                uint32_t rs2_lo = rb_base + ((2 * k) * cfg::n_steps + n) / cfg::b_sub_blocks;
+                uint32_t rs2_hi = rb_base + ((2 * k + 1) * cfg::n_steps + n) / cfg::b_sub_blocks;
+                instr->setSrcReg(1, rs2_lo, RegType::Float);
+                instr->setSrcReg(2, rs2_hi, RegType::Float);
+                instr->setSrcReg(3, rm, RegType::Integer);
+                instr->setSrcReg(4, rs3, RegType::Float);
+              } else {
+                uint32_t rs2 = rb_base + (k * cfg::n_steps + n) / cfg::b_sub_blocks;
+                instr->setSrcReg(1, rs2, RegType::Float);
+                instr->setSrcReg(2, rs3, RegType::Float);
+              }
               ibuffer.push_back(instr);
             }
           }
@@ -1194,13 +1216,33 @@ void Emulator::decode(uint32_t code, uint32_t wid, uint64_t uuid) {
       DPH(2, "Decoded DMA_SET_SIZE: rs1=" << rs1);
     } break;
     
-    case 0x4: { // DMA_WAIT
+    case 0x4: { // DMA_WAIT (imm[0]: wait on a completion group)
+      bool is_group = imm12 & 0x1;
       auto instr = std::allocate_shared<Instr>(instr_pool_, uuid, FUType::SFU);
-      instr->setOpType(DmaType::WAIT);
+      instr->setOpType(is_group ? DmaType::WAIT_GROUP : DmaType::WAIT);
       instr->setArgs(IntrDmaArgs{});
       instr->setSrcReg(0, rs1, RegType::Integer);
       ibuffer.push_back(instr);
-      DPH(2, "Decoded DMA_WAIT: rs1=" << rs1);
+      DPH(2, "Decoded DMA_WAIT: group=" << is_group << ", rs1=" << rs1);
+    } break;
+
+    case 0x5: { // DMA_SET_PARAM
+      auto instr = std::allocate_shared<Instr>(instr_pool_, uuid, FUType::SFU);
+      instr->setOpType(DmaType::SET_PARAM);
+      instr->setArgs(IntrDmaArgs{0, imm12});
+      instr->setSrcReg(0, rs1, RegType::Integer);
+      ibuffer.push_back(instr);
+      DPH(2, "Decoded DMA_SET_PARAM: param=" << imm12 << ", rs1=" << rs1);
+    } break;
+
+    case 0x6: { // DMA_CHAIN
+      auto instr = std::allocate_shared<Instr>(instr_pool_, uuid, FUType::SFU);
+      instr->setOpType(DmaType::CHAIN);
+      instr->setArgs(IntrDmaArgs{});
+      instr->setDestReg(rd, RegType::Integer);
+      instr->setSrcReg(0, rs1, RegType::Integer);
+      ibuffer.push_back(instr);
+      DPH(2, "Decoded DMA_CHAIN: rs1=" << rs1 << ", rd=" << rd);
     } break;
     
     default:
@@ -14,22 +14,53 @@
 #include "debug.h"
 #include "mem.h"
 #include "core.h"
+#include "socket.h"
 #include "local_mem.h"
+#include "timeline.h"
 #include <VX_config.h>
 
 using namespace vortex;
 
+// linked descriptor layout in device memory (must match vx_dma_node_t)
+struct dma_node_t {
+    Word next;
+    Word dst;
+    Word src;
+    uint32_t direction;
+    struct {
+        uint32_t elem_size;
+        uint32_t count[3];
+        uint32_t valid[3];
+        Word src_stride[2];
+        Word dst_stride[2];
+    } desc;
+};
+
 DmaEngine::DmaEngine(const SimContext& ctx, const char* name, const Config& config)
     : SimObject<DmaEngine>(ctx, name)
+    , MemReqPort(this)
+    , MemRspPort(this)
     , config_(config)
     , ram_(nullptr)
     , core_(nullptr)
     , next_dma_id_(1)
+    , group_pending_(config.num_groups, 0)
+    , chains_(config.max_chains)
+    , pending_reqs_(config.max_pending)
+    , next_channel_(0)
 {
     // 初始化所有通道为空
     for (uint32_t i = 0; i < MAX_CHANNELS; ++i) {
         active_transfers_[i] = nullptr;
     }
+
+    // one timeline track per channel
+    auto& timeline = Timeline::instance();
+    if (timeline.enabled()) {
+        for (uint32_t ch = 0; ch < std::min(config_.num_channels, MAX_CHANNELS); ++ch) {
+            timeline_tracks_.push_back(timeline.add_track(this->name(), StrFormat("channel%d", ch)));
+        }
+    }
 }
 
 DmaEngine::~DmaEngine() {
@@ -51,12 +82,20 @@ void DmaEngine::reset() {
             active_transfers_[i] = nullptr;
         }
     }
-    completed_transfers_.clear();
+    inflight_ids_.clear();
+    std::fill(group_pending_.begin(), group_pending_.end(), 0);
+    for (auto& chain : chains_) {
+        chain.valid = false;
+    }
     next_dma_id_ = 1;
+    pending_reqs_.clear();
+    next_channel_ = 0;
 }
 
 int32_t DmaEngine::request_transfer(uint64_t dst_addr, uint64_t src_addr, 
-                                     uint64_t size, int direction) {
+                                     const DmaShape& shape, int direction,
+                                     uint32_t group, int32_t barrier,
+                                     uint32_t core_mask) {
     if (is_queue_full()) {
         DT(3, this->name() << ": DMA queue full, rejecting request");
         perf_stats_.queue_stalls++;
@@ -69,60 +108,73 @@ int32_t DmaEngine::request_transfer(uint64_t dst_addr, uint64_t src_addr,
     req.dma_id = dma_id;
     req.dst_addr = dst_addr;
     req.src_addr = src_addr;
-    req.size = size;
+    req.size = shape.valid_bytes();
+    req.shape = shape;
     req.direction = direction;
     req.start_cycle = SimPlatform::instance().cycles();
     req.state = DmaState::IDLE;
     req.transfer_progress = 0;
     req.startup_counter = 0;
+    req.group = group;
+    req.barrier = barrier;
+    req.core_mask = core_mask;
     
     req_queue_.push(req);
+    inflight_ids_.insert(dma_id);
+    ++group_pending_.at(group);
     
     DT(3, this->name() << ": DMA request enqueued: id=" << dma_id
         << ", dst=0x" << std::hex << dst_addr
         << ", src=0x" << src_addr 
-        << ", size=" << std::dec << size 
-        << ", dir=" << (direction == 0 ? "G2L" : "L2G"));
+        << ", size=" << std::dec << req.size
+        << ", shape=" << shape.count[0] << "x" << shape.count[1] << "x" << shape.count[2]
+        << ", dir=" << (direction == 0 ? "G2L" : "L2G")
+        << ", cores=0x" << std::hex << core_mask << std::dec);
     
     return static_cast<int32_t>(dma_id);
 }
 
-bool DmaEngine::is_completed(uint32_t dma_id) const {
-    return completed_transfers_.count(dma_id) > 0;
-}
-
-bool DmaEngine::wait_for_completion(uint32_t dma_id) {
-    if (is_completed(dma_id)) {
-        return true;
+int32_t DmaEngine::request_chain(uint64_t head_addr, uint32_t group, int32_t barrier) {
+    uint32_t slot = 0;
+    while (slot < chains_.size() && chains_.at(slot).valid) {
+        ++slot;
     }
-    
-    // 检查所有活跃通道
-    for (uint32_t i = 0; i < MAX_CHANNELS; ++i) {
-        if (active_transfers_[i] && active_transfers_[i]->dma_id == dma_id) {
-            perf_stats_.wait_stalls++;
-            return false;
-        }
-    }
-    
-    // 检查等待队列
-    std::queue<DmaRequest> temp_queue = req_queue_;
-    while (!temp_queue.empty()) {
-        if (temp_queue.front().dma_id == dma_id) {
-            perf_stats_.wait_stalls++;
-            return false;
-        }
-        temp_queue.pop();
+    if (slot == chains_.size()) {
+        DT(3, this->name() << ": no free DMA chain slot, rejecting request");
+        perf_stats_.queue_stalls++;
+        return -1;
     }
-    
-    return true;
+
+    uint32_t dma_id = next_dma_id_++;
+
+    auto& chain = chains_.at(slot);
+    chain = chain_t();
+    chain.valid = true;
+    chain.dma_id = dma_id;
+    chain.group = group;
+    chain.barrier = barrier;
+    chain.start_cycle = SimPlatform::instance().cycles();
+    chain.fetch_addr = head_addr;
+
+    inflight_ids_.insert(dma_id);
+    ++group_pending_.at(group);
+
+    DT(3, this->name() << ": DMA chain started: id=" << dma_id
+        << ", head=0x" << std::hex << head_addr << std::dec
+        << ", group=" << group);
+
+    // an empty chain completes right away
+    check_chain(slot);
+
+    return static_cast<int32_t>(dma_id);
 }
 
-void DmaEngine::acknowledge_completion(uint32_t dma_id) {
-    auto it = completed_transfers_.find(dma_id);
-    if (it != completed_transfers_.end()) {
-        DT(4, this->name() << ": Acknowledged DMA " << dma_id);
-        completed_transfers_.erase(it);
-    }
+bool DmaEngine::is_completed(uint32_t dma_id) const {
+    return inflight_ids_.count(dma_id) == 0;
+}
+
+bool DmaEngine::is_group_completed(uint32_t group) const {
+    return group_pending_.at(group) == 0;
 }
 
 bool DmaEngine::is_busy() const {
@@ -130,6 +182,9 @@ bool DmaEngine::is_busy() const {
     for (uint32_t i = 0; i < config_.num_channels && i < MAX_CHANNELS; ++i) {
         if (active_transfers_[i] != nullptr) return true;
     }
+    for (auto& chain : chains_) {
+        if (chain.valid) return true;
+    }
     return false;
 }
 
@@ -139,6 +194,9 @@ bool DmaEngine::is_queue_full() const {
 
 void DmaEngine::tick() {
     uint32_t num_channels = std::min(config_.num_channels, MAX_CHANNELS);
+
+    // queue fetched chain nodes
+    dispatch_chains();
     
     // 为空闲通道分配新请求
     for (uint32_t ch = 0; ch < num_channels; ++ch) {
@@ -153,12 +211,18 @@ void DmaEngine::tick() {
         }
     }
     
+    // handle memory responses
+    process_response();
+
     // 处理所有活跃通道的传输
     for (uint32_t ch = 0; ch < num_channels; ++ch) {
         if (active_transfers_[ch]) {
             process_transfer(active_transfers_[ch], ch);
         }
     }
+
+    // send the next memory request
+    issue_request();
 }
 
 void DmaEngine::process_transfer(DmaRequest* transfer, uint32_t channel_idx) {
@@ -171,59 +235,282 @@ void DmaEngine::process_transfer(DmaRequest* transfer, uint32_t channel_idx) {
         transfer->startup_counter++;
         if (transfer->startup_counter >= config_.startup_latency) {
             transfer->state = DmaState::TRANSFERRING;
+            transfer->row = 0;
+            transfer->row_offset = 0;
+            enter_row(transfer);
+            seek(transfer);
             DT(3, this->name() << ": DMA " << transfer->dma_id 
                 << " (ch" << channel_idx << ") startup complete");
         }
         break;
         
-    case DmaState::TRANSFERRING: {
-        uint64_t remaining = transfer->size - transfer->transfer_progress;
-        uint64_t transfer_size = std::min(remaining, (uint64_t)config_.bandwidth);
-        
-        if (transfer_size > 0) {
-            std::vector<uint8_t> buffer(transfer_size);
-            
-            if (transfer->direction == 0) {
-                // G2L: Global to Local
-                ram_->read(buffer.data(), 
-                          transfer->src_addr + transfer->transfer_progress, 
-                          transfer_size);
-                
-                uint64_t local_offset = transfer->dst_addr - LMEM_BASE_ADDR 
-                                       + transfer->transfer_progress;
-                core_->local_mem()->write(buffer.data(), local_offset, transfer_size);
-                
-                perf_stats_.bytes_read += transfer_size;
-                perf_stats_.bytes_written += transfer_size;
-                
-            } else {
-                // L2G: Local to Global
-                uint64_t local_offset = transfer->src_addr - LMEM_BASE_ADDR 
-                                       + transfer->transfer_progress;
-                core_->local_mem()->read(buffer.data(), local_offset, transfer_size);
-                
-                ram_->write(buffer.data(), 
-                           transfer->dst_addr + transfer->transfer_progress, 
-                           transfer_size);
-                
-                perf_stats_.bytes_read += transfer_size;
-                perf_stats_.bytes_written += transfer_size;
-            }
-            
-            transfer->transfer_progress += transfer_size;
-        }
-        
+    case DmaState::TRANSFERRING:
+        // data moves through issue_request()/process_response()
         if (transfer->transfer_progress >= transfer->size) {
             complete_transfer(channel_idx);
         }
         break;
-    }
         
     default:
         break;
     }
 }
 
+void DmaEngine::process_response() {
+    if (MemRspPort.empty())
+        return;
+    auto& mem_rsp = MemRspPort.front();
+    DT(3, this->name() << "-mem-rsp: " << mem_rsp);
+    auto entry = pending_reqs_.at(mem_rsp.tag);
+    pending_reqs_.release(mem_rsp.tag);
+    MemRspPort.pop();
+
+    if (entry.chain >= 0) {
+        // descriptor data has arrived
+        auto& chain = chains_.at(entry.chain);
+        chain.fetch_received += entry.size;
+        if (chain.fetch_received == sizeof(dma_node_t)) {
+            load_node(entry.chain);
+        }
+        return;
+    }
+
+    // the global data has arrived, fill local memory
+    auto transfer = active_transfers_[entry.channel];
+    assert(transfer != nullptr);
+    copy_data(*transfer, entry.src_addr, entry.dst_addr, entry.size);
+    transfer->transfer_progress += entry.size;
+    if (transfer->transfer_progress >= transfer->size) {
+        complete_transfer(entry.channel);
+    }
+}
+
+void DmaEngine::issue_request() {
+    // descriptor fetches go first, they feed the channels
+    if (issue_fetch())
+        return;
+
+    uint32_t num_channels = std::min(config_.num_channels, MAX_CHANNELS);
+    for (uint32_t i = 0; i < num_channels; ++i) {
+        uint32_t ch = (next_channel_ + i) % num_channels;
+        auto transfer = active_transfers_[ch];
+        if (transfer == nullptr
+         || transfer->state != DmaState::TRANSFERRING
+         || transfer->issue_progress >= transfer->size)
+            continue;
+
+        bool is_read = (transfer->direction == 0);
+        if (is_read && pending_reqs_.full()) {
+            perf_stats_.pending_stalls++;
+            return;
+        }
+
+        // split rows at cache line boundaries
+        auto& shape = transfer->shape;
+        uint64_t src_addr = transfer->src_addr + shape.src_offset(transfer->row) + transfer->row_offset;
+        uint64_t dst_addr = transfer->dst_addr + shape.dst_offset(transfer->row) + transfer->row_offset;
+        uint64_t mem_addr = is_read ? src_addr : dst_addr;
+        uint64_t row_remaining = shape.row_valid_bytes(transfer->row) - transfer->row_offset;
+        uint64_t line_remaining = L1_LINE_SIZE - (mem_addr & (L1_LINE_SIZE - 1));
+        uint32_t size = std::min({row_remaining, (uint64_t)config_.bandwidth, line_remaining});
+
+        MemReq mem_req;
+        mem_req.addr  = mem_addr;
+        mem_req.size  = size;
+        mem_req.write = !is_read;
+        mem_req.type  = AddrType::Global;
+        mem_req.cid   = core_->id();
+        mem_req.uuid  = transfer->dma_id;
+        if (is_read) {
+            mem_req.tag = pending_reqs_.allocate({ch, src_addr, dst_addr, size, -1});
+            perf_stats_.mem_reads++;
+        } else {
+            // local memory is read at issue, global writes are posted
+            copy_data(*transfer, src_addr, dst_addr, size);
+            for (auto port : snoop_ports_) {
+                port->push(mem_req, config_.snoop_latency);
+            }
+            transfer->transfer_progress += size;
+            perf_stats_.mem_writes++;
+        }
+        MemReqPort.push(mem_req);
+        DT(3, this->name() << "-mem-req: " << mem_req);
+
+        transfer->issue_progress += size;
+        transfer->row_offset += size;
+        seek(transfer);
+        next_channel_ = (ch + 1) % num_channels;
+        if (transfer->transfer_progress >= transfer->size) {
+            complete_transfer(ch);
+        }
+        return;
+    }
+}
+
+bool DmaEngine::issue_fetch() {
+    for (uint32_t slot = 0; slot < chains_.size(); ++slot) {
+        auto& chain = chains_.at(slot);
+        if (!chain.valid
+         || chain.fetch_addr == 0
+         || chain.fetch_offset >= sizeof(dma_node_t))
+            continue;
+        if (pending_reqs_.full()) {
+            perf_stats_.pending_stalls++;
+            return true;
+        }
+
+        // split the node at cache line boundaries
+        uint64_t addr = chain.fetch_addr + chain.fetch_offset;
+        uint64_t line_remaining = L1_LINE_SIZE - (addr & (L1_LINE_SIZE - 1));
+        uint32_t size = std::min<uint64_t>(sizeof(dma_node_t) - chain.fetch_offset, line_remaining);
+
+        MemReq mem_req;
+        mem_req.addr  = addr;
+        mem_req.size  = size;
+        mem_req.write = false;
+        mem_req.type  = AddrType::Global;
+        mem_req.tag   = pending_reqs_.allocate({0, addr, 0, size, int32_t(slot)});
+        mem_req.cid   = core_->id();
+        mem_req.uuid  = chain.dma_id;
+        MemReqPort.push(mem_req);
+        DT(3, this->name() << "-desc-req: " << mem_req);
+
+        chain.fetch_offset += size;
+        perf_stats_.desc_reads++;
+        return true;
+    }
+    return false;
+}
+
+void DmaEngine::load_node(uint32_t slot) {
+    auto& chain = chains_.at(slot);
+
+    dma_node_t node;
+    ram_->read(&node, chain.fetch_addr, sizeof(node));
+
+    DmaShape shape;
+    shape.elem_size = node.desc.elem_size;
+    for (uint32_t d = 0; d < 3; ++d) {
+        shape.count[d] = node.desc.count[d];
+        shape.valid[d] = node.desc.valid[d];
+    }
+    for (uint32_t d = 0; d < 2; ++d) {
+        shape.src_stride[d] = node.desc.src_stride[d];
+        shape.dst_stride[d] = node.desc.dst_stride[d];
+    }
+
+    auto& req = chain.node;
+    req = DmaRequest();
+    req.dma_id = chain.dma_id;
+    req.dst_addr = node.dst;
+    req.src_addr = node.src;
+    req.size = shape.valid_bytes();
+    req.shape = shape;
+    req.direction = node.direction & 0x1;
+    req.start_cycle = SimPlatform::instance().cycles();
+    req.chain = slot;
+
+    DT(3, this->name() << ": DMA chain " << chain.dma_id << " node: addr=0x" << std::hex << chain.fetch_addr
+        << ", dst=0x" << req.dst_addr << ", src=0x" << req.src_addr
+        << ", next=0x" << node.next << std::dec
+        << ", size=" << req.size
+        << ", dir=" << (req.direction == 0 ? "G2L" : "L2G"));
+
+    chain.has_node = true;
+    chain.next_addr = node.next;
+    chain.fetch_addr = 0;
+    chain.fetch_offset = 0;
+    chain.fetch_received = 0;
+}
+
+void DmaEngine::dispatch_chains() {
+    for (auto& chain : chains_) {
+        if (!chain.valid || !chain.has_node || is_queue_full())
+            continue;
+        req_queue_.push(chain.node);
+        chain.has_node = false;
+        ++chain.pending;
+        // prefetch the next node while this one transfers
+        chain.fetch_addr = chain.next_addr;
+        chain.next_addr = 0;
+    }
+}
+
+void DmaEngine::check_chain(uint32_t slot) {
+    auto& chain = chains_.at(slot);
+    if (chain.fetch_addr != 0
+     || chain.has_node
+     || chain.pending != 0)
+        return;
+    DT(3, this->name() << ": DMA chain " << chain.dma_id << " completed, latency="
+        << (SimPlatform::instance().cycles() - chain.start_cycle) << " cycles");
+    chain.valid = false;
+    perf_stats_.chains++;
+    finish(chain.dma_id, chain.group, chain.barrier, 0);
+}
+
+void DmaEngine::finish(uint32_t dma_id, uint32_t group, int32_t barrier, uint32_t core_mask) {
+    inflight_ids_.erase(dma_id);
+    --group_pending_.at(group);
+    if (barrier < 0)
+        return;
+    // wake up the warps sleeping on the barrier of each receiving core
+    if (core_mask == 0) {
+        core_->barrier_signal(barrier);
+        return;
+    }
+    auto socket = core_->socket();
+    for (uint32_t i = 0; i < socket->num_cores(); ++i) {
+        if (core_mask & (1u << i)) {
+            socket->core(i)->barrier_signal(barrier);
+        }
+    }
+}
+
+void DmaEngine::enter_row(DmaRequest* transfer) {
+    auto& shape = transfer->shape;
+    if (transfer->direction != 0 || transfer->row >= shape.num_rows())
+        return;
+    // zero-fill the padded part of the local tile row
+    uint64_t valid_bytes = shape.row_valid_bytes(transfer->row);
+    uint64_t pad_bytes = shape.row_bytes() - valid_bytes;
+    if (pad_bytes == 0)
+        return;
+    std::vector<uint8_t> zeros(pad_bytes, 0);
+    uint64_t local_addr = transfer->dst_addr + shape.dst_offset(transfer->row) + valid_bytes;
+    write_local(transfer->core_mask, zeros.data(), local_addr, pad_bytes);
+    perf_stats_.bytes_written += pad_bytes;
+}
+
+void DmaEngine::seek(DmaRequest* transfer) {
+    // advance to the next row with data left to request
+    auto& shape = transfer->shape;
+    uint64_t num_rows = shape.num_rows();
+    while (transfer->row < num_rows
+        && transfer->row_offset >= shape.row_valid_bytes(transfer->row)) {
+        ++transfer->row;
+        transfer->row_offset = 0;
+        enter_row(transfer);
+    }
+}
+
+void DmaEngine::copy_data(const DmaRequest& transfer, uint64_t src_addr, uint64_t dst_addr, uint32_t size) {
+    assert(ram_ != nullptr);
+    assert(core_ != nullptr);
+    std::vector<uint8_t> buffer(size);
+    if (transfer.direction == 0) {
+        // G2L: Global to Local
+        ram_->read(buffer.data(), src_addr, size);
+        write_local(transfer.core_mask, buffer.data(), dst_addr, size);
+    } else {
+        // L2G: Local to Global
+        core_->local_mem()->read(buffer.data(), src_addr - LMEM_BASE_ADDR, size);
+        ram_->write(buffer.data(), dst_addr, size);
+    }
+    perf_stats_.bytes_read += size;
+    perf_stats_.bytes_written += size;
+}
+
 void DmaEngine::complete_transfer(uint32_t channel_idx) {
     DmaRequest* transfer = active_transfers_[channel_idx];
     assert(transfer != nullptr);
@@ -233,14 +520,54 @@ void DmaEngine::complete_transfer(uint32_t channel_idx) {
     DT(3, this->name() << ": DMA " << transfer->dma_id 
         << " (ch" << channel_idx << ") completed, latency=" << latency << " cycles");
     
+    if (!timeline_tracks_.empty()) {
+        Timeline::instance().slice(timeline_tracks_.at(channel_idx),
+            (transfer->direction == 0) ? "G2L" : "L2G",
+            transfer->start_cycle, SimPlatform::instance().cycles());
+    }
+
     transfer->state = DmaState::COMPLETED;
-    completed_transfers_[transfer->dma_id] = *transfer;
     
     perf_stats_.transfers++;
     perf_stats_.total_latency += latency;
+
+    auto dma_id = transfer->dma_id;
+    auto group = transfer->group;
+    auto barrier = transfer->barrier;
+    auto chain = transfer->chain;
+    
+    auto core_mask = transfer->core_mask;
+    if (core_mask != 0) {
+        perf_stats_.mcast_transfers++;
+    }
     
     delete transfer;
     active_transfers_[channel_idx] = nullptr;
+
+    if (chain >= 0) {
+        --chains_.at(chain).pending;
+        check_chain(chain);
+    } else {
+        finish(dma_id, group, barrier, core_mask);
+    }
+}
+
+void DmaEngine::write_local(uint32_t core_mask, const void* data, uint64_t addr, uint32_t size) {
+    if (core_mask == 0) {
+        core_->local_mem()->write(data, addr - LMEM_BASE_ADDR, size);
+        return;
+    }
+    // multicast: the global data is read once and written to every receiving core
+    auto socket = core_->socket();
+    for (uint32_t i = 0; i < socket->num_cores(); ++i) {
+        if (0 == (core_mask & (1u << i)))
+            continue;
+        auto core = socket->core(i);
+        core->local_mem()->write(data, addr - LMEM_BASE_ADDR, size);
+        if (core != core_) {
+            perf_stats_.mcast_bytes += size;
+        }
+    }
 }
 
 const DmaEngine::PerfStats& DmaEngine::perf_stats() const {
@@ -254,3 +581,7 @@ void DmaEngine::attach_ram(RAM* ram) {
 void DmaEngine::attach_core(Core* core) {
     core_ = core;
 }
+
+void DmaEngine::attach_snoops(const std::vector<SimPort<MemReq>*>& ports) {
+    snoop_ports_ = ports;
+}
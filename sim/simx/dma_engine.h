@@ -14,7 +14,7 @@
 
 #include <simobject.h>
 #include <queue>
-#include <unordered_map>
+#include <unordered_set>
 #include "types.h"
 
 namespace vortex {
@@ -26,9 +26,13 @@ class DmaEngine : public SimObject<DmaEngine> {
 public:
     struct Config {
         uint32_t queue_size;        // 请求队列大小
-        uint32_t bandwidth;         // 每周期每通道传输字节数
+        uint32_t bandwidth;         // max bytes per memory request
         uint32_t startup_latency;   // 启动延迟（周期）
         uint32_t num_channels;      // 并行通道数量
+        uint32_t max_pending;       // outstanding memory reads
+        uint32_t snoop_latency;     // cycles for a global write to invalidate cached copies
+        uint32_t num_groups;        // completion groups
+        uint32_t max_chains;        // active descriptor chains
     };
     
     struct PerfStats {
@@ -38,10 +42,20 @@ public:
         uint64_t total_latency;     // 总延迟
         uint64_t queue_stalls;      // 队列满的周期数
         uint64_t wait_stalls;       // wait指令等待的周期数
+        uint64_t mem_reads;         // memory read requests
+        uint64_t mem_writes;        // memory write requests
+        uint64_t pending_stalls;    // cycles blocked on outstanding reads
+        uint64_t chains;            // descriptor chains completed
+        uint64_t desc_reads;        // descriptor fetch requests
+        uint64_t mcast_transfers;   // multicast transfers
+        uint64_t mcast_bytes;       // bytes delivered to other cores' local memories
         
         PerfStats() 
             : transfers(0), bytes_read(0), bytes_written(0)
-            , total_latency(0), queue_stalls(0), wait_stalls(0) {}
+            , total_latency(0), queue_stalls(0), wait_stalls(0)
+            , mem_reads(0), mem_writes(0), pending_stalls(0)
+            , chains(0), desc_reads(0)
+            , mcast_transfers(0), mcast_bytes(0) {}
         
         PerfStats& operator+=(const PerfStats& other) {
             transfers += other.transfers;
@@ -50,6 +64,13 @@ public:
             total_latency += other.total_latency;
             queue_stalls += other.queue_stalls;
             wait_stalls += other.wait_stalls;
+            mem_reads += other.mem_reads;
+            mem_writes += other.mem_writes;
+            pending_stalls += other.pending_stalls;
+            chains += other.chains;
+            desc_reads += other.desc_reads;
+            mcast_transfers += other.mcast_transfers;
+            mcast_bytes += other.mcast_bytes;
             return *this;
         }
     };
@@ -67,19 +88,32 @@ public:
         uint32_t dma_id;
         uint64_t dst_addr;
         uint64_t src_addr;
-        uint64_t size;
+        uint64_t size;              // bytes to move (valid part of the shape)
+        DmaShape shape;
         int direction;              // 0=G2L, 1=L2G
         uint64_t start_cycle;
         DmaState state;
         uint64_t transfer_progress;
         uint64_t startup_counter;
+        uint64_t issue_progress;    // bytes requested from memory
+        uint64_t row;               // current row of the shape
+        uint64_t row_offset;        // bytes requested in the current row
+        uint32_t group;             // completion group
+        int32_t barrier;            // local barrier to signal (-1: none)
+        int32_t chain;              // owning chain slot (-1: standalone)
+        uint32_t core_mask;         // socket cores receiving the data (G2L)
         
         DmaRequest() 
             : dma_id(0), dst_addr(0), src_addr(0), size(0)
             , direction(0), start_cycle(0), state(DmaState::IDLE)
-            , transfer_progress(0), startup_counter(0) {}
+            , transfer_progress(0), startup_counter(0), issue_progress(0)
+            , row(0), row_offset(0), group(0), barrier(-1), chain(-1), core_mask(0) {}
     };
 
+    // global memory interface (line-sized requests into the socket memory path)
+    SimPort<MemReq> MemReqPort;
+    SimPort<MemRsp> MemRspPort;
+
     DmaEngine(const SimContext& ctx, const char* name, const Config& config);
     ~DmaEngine();
 
@@ -88,16 +122,18 @@ public:
 
     // 提交DMA传输（返回DMA ID，失败返回-1）
     int32_t request_transfer(uint64_t dst_addr, uint64_t src_addr, 
-                            uint64_t size, int direction);
+                            const DmaShape& shape, int direction,
+                            uint32_t group = 0, int32_t barrier = -1,
+                            uint32_t core_mask = 0);
+
+    // start walking a descriptor chain in device memory (returns -1 if no chain slot is free)
+    int32_t request_chain(uint64_t head_addr, uint32_t group, int32_t barrier);
     
     // 检查DMA是否完成
     bool is_completed(uint32_t dma_id) const;
-    
-    // 等待DMA完成（返回true表示已完成）
-    bool wait_for_completion(uint32_t dma_id);
-    
-    // 确认并清理已完成的DMA
-    void acknowledge_completion(uint32_t dma_id);
+
+    // all transfers and chains of a group have completed
+    bool is_group_completed(uint32_t group) const;
     
     bool is_busy() const;
     bool is_queue_full() const;
@@ -107,6 +143,9 @@ public:
     void attach_ram(RAM* ram);
     void attach_core(Core* core);
 
+    // data caches to invalidate on global writes
+    void attach_snoops(const std::vector<SimPort<MemReq>*>& ports);
+
 private:
     Config config_;
     RAM* ram_;
@@ -121,10 +160,53 @@ private:
     static const uint32_t MAX_CHANNELS = 8;
     DmaRequest* active_transfers_[MAX_CHANNELS];
     
-    std::unordered_map<uint32_t, DmaRequest> completed_transfers_;
+    std::unordered_set<uint32_t> inflight_ids_;   // issued, not yet completed
+    std::vector<uint32_t> group_pending_;          // in-flight IDs per group
+
+    // a chain walks its nodes one at a time, fetching the next node
+    // while the previous one is queued or transferring
+    struct chain_t {
+        bool valid;
+        uint32_t dma_id;
+        uint32_t group;
+        int32_t barrier;
+        uint64_t start_cycle;
+        uint64_t fetch_addr;    // node being fetched (0: none)
+        uint32_t fetch_offset;  // node bytes requested
+        uint32_t fetch_received;// node bytes received
+        uint64_t next_addr;     // node after the fetched one (0: end of chain)
+        bool has_node;          // fetched node waiting for a queue entry
+        DmaRequest node;
+        uint32_t pending;       // node transfers not completed
+    };
+    std::vector<chain_t> chains_;
+
+    std::vector<uint32_t> timeline_tracks_; // per channel (empty when disabled)
+
+    struct pending_req_t {
+        uint32_t channel;
+        uint64_t src_addr;
+        uint64_t dst_addr;
+        uint32_t size;
+        int32_t chain;          // descriptor fetch of this chain slot (-1: data)
+    };
+    HashTable<pending_req_t> pending_reqs_;
+    std::vector<SimPort<MemReq>*> snoop_ports_;
+    uint32_t next_channel_;     // round-robin request issue
     
     void process_transfer(DmaRequest* transfer, uint32_t channel_idx);
     void complete_transfer(uint32_t channel_idx);
+    void process_response();
+    void issue_request();
+    bool issue_fetch();
+    void dispatch_chains();
+    void load_node(uint32_t slot);
+    void check_chain(uint32_t slot);
+    void finish(uint32_t dma_id, uint32_t group, int32_t barrier, uint32_t core_mask);
+    void enter_row(DmaRequest* transfer);
+    void seek(DmaRequest* transfer);
+    void copy_data(const DmaRequest& transfer, uint64_t src_addr, uint64_t dst_addr, uint32_t size);
+    void write_local(uint32_t core_mask, const void* data, uint64_t addr, uint32_t size);
 };
 
 } // namespace vortex
@@ -12,6 +12,7 @@
 // limitations under the License.
 
 #include <iostream>
+#include <algorithm>
 #include <stdlib.h>
 #include <unistd.h>
 #include <math.h>
@@ -42,6 +43,7 @@ void warp_t::reset(uint64_t startup_addr) {
   this->tmask.reset();
   this->PC = startup_addr;
   this->uuid = 0;
+  this->code = 0;
   this->fcsr = 0;
 
   for (auto& reg_file : this->ireg_file) {
@@ -77,7 +79,11 @@ Emulator::Emulator(const Arch &arch, const DCRS &dcrs, Core* core)
     , dcrs_(dcrs)
     , core_(core)
     , warps_(arch.num_warps(), arch.num_threads())
+    , warp_sched_({WarpSchedType(SCHEDULE_POLICY), arch.num_warps(), SCHED_ACTIVE_WARPS, CCWS_VTA_SIZE, CCWS_LLS_SCORE})
+    , ready_warps_(arch.num_warps())
     , barriers_(arch.num_barriers(), 0)
+    , barrier_counts_(arch.num_barriers(), 0)
+    , barrier_signals_(arch.num_barriers(), 0)
     , ipdom_size_(arch.num_threads()-1)
     , dma_pending_configs_(arch.num_warps())
   #ifdef EXT_TCU_ENABLE
@@ -86,6 +92,7 @@ Emulator::Emulator(const Arch &arch, const DCRS &dcrs, Core* core)
   #ifdef EXT_V_ENABLE
     , vec_unit_(core->vec_unit())
   #endif
+    , itrace_(ITraceWriter::instance().enabled() ? &ITraceWriter::instance() : nullptr)
 {
   std::srand(50);
   this->reset();
@@ -113,6 +120,8 @@ void Emulator::reset() {
   for (auto& barrier : barriers_) {
     barrier.reset();
   }
+  std::fill(barrier_counts_.begin(), barrier_counts_.end(), 0);
+  std::fill(barrier_signals_.begin(), barrier_signals_.end(), 0);
 
   // Reset DMA configurations
   for (auto& cfg : dma_pending_configs_) {
@@ -126,6 +135,8 @@ void Emulator::reset() {
   csr_mscratch_ = startup_arg;
 
   stalled_warps_.reset();
+  throttled_warps_.reset();
+  warp_sched_.reset();
   active_warps_.reset();
 
   // activate first warp and thread
@@ -172,18 +183,20 @@ instr_trace_t* Emulator::step() {
   }
 
   // find next ready warp
+  bool has_ready = false;
   for (size_t wid = 0, nw = arch_.num_warps(); wid < nw; ++wid) {
     bool warp_active = active_warps_.test(wid);
-    bool warp_stalled = stalled_warps_.test(wid);
-    if (warp_active && !warp_stalled) {
-      scheduled_warp = wid;
-      break;
-    }
+    bool warp_stalled = stalled_warps_.test(wid) || throttled_warps_.test(wid);
+    bool warp_ready = warp_active && !warp_stalled;
+    ready_warps_.set(wid, warp_ready);
+    has_ready |= warp_ready;
   }
 
-  if (scheduled_warp == -1)
+  if (!has_ready)
     return nullptr;
 
+  scheduled_warp = warp_sched_.select(ready_warps_);
+
   // get scheduled warp
   auto& warp = warps_.at(scheduled_warp);
   assert(warp.tmask.any());
@@ -191,17 +204,19 @@ instr_trace_t* Emulator::step() {
   // fetch next instruction if ibuffer is empty
   if (warp.ibuffer.empty()) {
     uint64_t uuid = 0;
-  #ifndef NDEBUG
+  #ifdef NDEBUG
+    if (itrace_)
+  #endif
     {
       // generate unique universal instruction ID
       uint32_t instr_uuid = warp.uuid++;
       uint32_t g_wid = core_->id() * arch_.num_warps() + scheduled_warp;
       uuid = (uint64_t(g_wid) << 32) | instr_uuid;
     }
-  #endif
 
     // Fetch
     auto instr_code = this->fetch(scheduled_warp, uuid);
+    warp.code = instr_code;
 
     // decode
     this->decode(instr_code, scheduled_warp, uuid);
@@ -218,6 +233,10 @@ instr_trace_t* Emulator::step() {
   // Execute
   auto trace = this->execute(*instr, scheduled_warp);
 
+  if (itrace_) {
+    itrace_->write(*trace, warp.code, SimPlatform::instance().cycles());
+  }
+
   return trace;
 }
 
@@ -229,6 +248,10 @@ int Emulator::get_exitcode() const {
   return warps_.at(0).ireg_file.at(3).at(0);
 }
 
+void Emulator::dcache_miss(uint32_t wid, uint64_t addr) {
+  warp_sched_.dcache_miss(wid, addr);
+}
+
 DmaPendingConfig& Emulator::dma_config(uint32_t wid) {
   return dma_pending_configs_.at(wid);
 }
@@ -247,6 +270,10 @@ void Emulator::resume(uint32_t wid) {
   }
 }
 
+void Emulator::throttle(uint32_t wid, bool enable) {
+  throttled_warps_.set(wid, enable);
+}
+
 bool Emulator::wspawn(uint32_t num_warps, Word nextPC) {
   num_warps = std::min<uint32_t>(num_warps, arch_.num_warps());
   if (num_warps < 2 && active_warps_.count() == 1)
@@ -276,20 +303,50 @@ bool Emulator::barrier(uint32_t bar_id, uint32_t count, uint32_t wid) {
     }
   } else {
     // local barrier handling
-    if (barrier.count() == (size_t)count) {
-      // resume suspended warps
-      for (uint32_t i = 0; i < arch_.num_warps(); ++i) {
-        if (barrier.test(i)) {
-          DP(3, "*** Resume core #" << core_->id() << ", warp #" << i << " at barrier #" << bar_idx);
-          stalled_warps_.reset(i);
-        }
-      }
-      barrier.reset();
+    barrier_counts_.at(bar_idx) = count;
+    if (this->barrier_ready(bar_idx)) {
+      this->release_barrier(bar_idx);
     }
   }
   return false;
 }
 
+void Emulator::barrier_signal(uint32_t bar_id) {
+  uint32_t bar_idx = bar_id & 0x7fffffff;
+  auto& barrier = barriers_.at(bar_idx);
+  ++barrier_signals_.at(bar_idx);
+  DP(3, "*** Signal core #" << core_->id() << " at barrier #" << bar_idx);
+  // warps arriving later check the pending signals
+  if (barrier.any() && this->barrier_ready(bar_idx)) {
+    this->release_barrier(bar_idx);
+  }
+}
+
+// Every signal stands for one arrival, so several transfers can signal the
+// same barrier phase. Signals beyond the arrivals still missing in a phase
+// are kept for later phases.
+bool Emulator::barrier_ready(uint32_t bar_idx) const {
+  uint32_t signals = barrier_signals_.at(bar_idx);
+  return barriers_.at(bar_idx).count() + signals >= barrier_counts_.at(bar_idx);
+}
+
+void Emulator::release_barrier(uint32_t bar_idx) {
+  auto& barrier = barriers_.at(bar_idx);
+  // resume suspended warps
+  for (uint32_t i = 0; i < arch_.num_warps(); ++i) {
+    if (barrier.test(i)) {
+      DP(3, "*** Resume core #" << core_->id() << ", warp #" << i << " at barrier #" << bar_idx);
+      stalled_warps_.reset(i);
+    }
+  }
+  // consume the signals standing in for missing warps
+  uint32_t count = barrier.count();
+  if (count < barrier_counts_.at(bar_idx)) {
+    barrier_signals_.at(bar_idx) -= (barrier_counts_.at(bar_idx) - count);
+  }
+  barrier.reset();
+}
+
 #ifdef VM_ENABLE
 void Emulator::icache_read(void *data, uint64_t addr, uint32_t size) {
   DP(3, "*** icache_read 0x" << std::hex << addr << ", size = 0x "  << size);
@@ -20,6 +20,8 @@
 #include <mem.h>
 #include "types.h"
 #include "instr.h"
+#include "warp_sched.h"
+#include "itrace.h"
 #ifdef EXT_TCU_ENABLE
 #include "tensor_unit.h"
 #endif
@@ -60,6 +62,7 @@ struct warp_t {
   Word                              PC;
   Byte                              fcsr;
   uint32_t                          uuid;
+  uint32_t                          code; // last fetched instruction word
 
   warp_t(uint32_t num_threads);
 
@@ -81,21 +84,30 @@ struct DmaPendingConfig {
   uint64_t dst_addr;
   uint64_t src_addr;
   uint64_t size;
+  DmaShape shape;   // multi-dimensional descriptor (SET_PARAM)
+  uint32_t group;   // completion group
+  int32_t barrier;  // local barrier to signal on completion (-1: none)
+  uint32_t core_mask; // socket cores receiving a G2L multicast (0: this core)
   bool has_dst;
   bool has_src;
   bool has_size;
+  bool has_shape;
   
   DmaPendingConfig() 
-    : dst_addr(0), src_addr(0), size(0)
-    , has_dst(false), has_src(false), has_size(false) {}
+    : dst_addr(0), src_addr(0), size(0), group(0), barrier(-1), core_mask(0)
+    , has_dst(false), has_src(false), has_size(false), has_shape(false) {}
   
   void reset() {
     dst_addr = src_addr = size = 0;
-    has_dst = has_src = has_size = false;
+    shape = DmaShape();
+    group = 0;
+    barrier = -1;
+    core_mask = 0;
+    has_dst = has_src = has_size = has_shape = false;
   }
   
   bool is_ready() const {
-    return has_dst && has_src && has_size;
+    return has_dst && has_src && (has_size || has_shape);
   }
 };
 
@@ -123,8 +135,22 @@ public:
 
   void resume(uint32_t wid);
 
+  // front-end flow control, independent of suspend/resume
+  void throttle(uint32_t wid, bool enable);
+
+  Word get_pc(uint32_t wid) const {
+    return warps_.at(wid).PC;
+  }
+
+  const ThreadMask& get_tmask(uint32_t wid) const {
+    return warps_.at(wid).tmask;
+  }
+
   bool barrier(uint32_t bar_id, uint32_t count, uint32_t wid);
 
+  // arrival of a non-warp agent (DMA completion) at a local barrier
+  void barrier_signal(uint32_t bar_id);
+
   bool wspawn(uint32_t num_warps, Word nextPC);
 
   int get_exitcode() const;
@@ -133,6 +159,8 @@ public:
 
   void dcache_write(const void* data, uint64_t addr, uint32_t size);
 
+  void dcache_miss(uint32_t wid, uint64_t addr);
+
   // Access DMA configuration for a warp (for execute stage)
   DmaPendingConfig& dma_config(uint32_t wid);
 
@@ -169,6 +197,10 @@ private:
   void trigger_ecall();
   void trigger_ebreak();
 
+  bool barrier_ready(uint32_t bar_idx) const;
+
+  void release_barrier(uint32_t bar_idx);
+
   const Arch& arch_;
   const DCRS& dcrs_;
   Core*       core_;
@@ -176,7 +208,12 @@ private:
   std::vector<warp_t> warps_;
   WarpMask    active_warps_;
   WarpMask    stalled_warps_;
+  WarpMask    throttled_warps_;
+  WarpScheduler warp_sched_;
+  BitVector<> ready_warps_;
   std::vector<WarpMask> barriers_;
+  std::vector<uint32_t> barrier_counts_;  // expected arrivals, from the last warp arrival
+  std::vector<uint32_t> barrier_signals_; // pending non-warp arrivals
   std::unordered_map<int, std::stringstream> print_bufs_;
   MemoryUnit  mmu_;
   uint32_t    ipdom_size_;
@@ -195,6 +232,7 @@ private:
 #endif
 
   PoolAllocator<Instr, 64> instr_pool_;
+  ITraceWriter* itrace_; // nullptr when tracing is disabled
 };
 
 }
@@ -124,6 +124,8 @@ instr_trace_t* Emulator::execute(const Instr &instr, uint32_t wid) {
   auto rsrc0  = instr.getSrcReg(0);
   auto rsrc1  = instr.getSrcReg(1);
   auto rsrc2  = instr.getSrcReg(2);
+  auto rsrc3  = instr.getSrcReg(3);
+  auto rsrc4  = instr.getSrcReg(4);
 
   auto num_threads = arch_.num_threads();
 
@@ -137,12 +139,14 @@ instr_trace_t* Emulator::execute(const Instr &instr, uint32_t wid) {
   trace->PC       = warp.PC;
   trace->tmask    = warp.tmask;
   trace->dst_reg  = rdest;
-  trace->src_regs = {rsrc0, rsrc1, rsrc2};
+  trace->src_regs = {rsrc0, rsrc1, rsrc2, rsrc3, rsrc4};
 
   std::vector<reg_data_t> rd_data(num_threads);
   std::vector<reg_data_t> rs1_data;
   std::vector<reg_data_t> rs2_data;
   std::vector<reg_data_t> rs3_data;
+  std::vector<reg_data_t> rs4_data;
+  std::vector<reg_data_t> rs5_data;
 
   DP(1, "Instr: " << instr << ", cid=" << core_->id() << ", wid=" << wid << ", tmask=" << warp.tmask
          << ", PC=0x" << std::hex << warp.PC << std::dec << " (#" << instr.getUUID() << ")");
@@ -151,6 +155,8 @@ instr_trace_t* Emulator::execute(const Instr &instr, uint32_t wid) {
   if (rsrc0.type != RegType::None) fetch_registers(rs1_data, wid, 0, rsrc0);
   if (rsrc1.type != RegType::None) fetch_registers(rs2_data, wid, 1, rsrc1);
   if (rsrc2.type != RegType::None) fetch_registers(rs3_data, wid, 2, rsrc2);
+  if (rsrc3.type != RegType::None) fetch_registers(rs4_data, wid, 3, rsrc3);
+  if (rsrc4.type != RegType::None) fetch_registers(rs5_data, wid, 4, rsrc4);
 
   uint32_t thread_start = 0;
   for (; thread_start < num_threads; ++thread_start) {
@@ -1456,11 +1462,21 @@ instr_trace_t* Emulator::execute(const Instr &instr, uint32_t wid) {
     ,[&](TcuType tcu_type) {
       auto tpuArgs = std::get<IntrTcuArgs>(instrArgs);
       switch (tcu_type) {
-      case TcuType::WMMA: {
+      case TcuType::WMMA:
+      case TcuType::WMMA_SP: {
+        bool sparse = (tcu_type == TcuType::WMMA_SP);
         auto trace_data = std::make_shared<TensorUnit::ExeTraceData>();
+        trace_data->fmt_s  = tpuArgs.fmt_s;
+        trace_data->fmt_d  = tpuArgs.fmt_d;
+        trace_data->step_k = tpuArgs.step_k;
+        trace_data->sparse = sparse;
         trace->data = trace_data;
         assert(warp.tmask.count() == num_threads);
-        tensor_unit_->wmma(wid, tpuArgs.fmt_s, tpuArgs.fmt_d, tpuArgs.step_m, tpuArgs.step_n, rs1_data, rs2_data, rs3_data, rd_data, trace_data.get());
+        if (sparse) {
+          tensor_unit_->wmma_sp(wid, tpuArgs.fmt_s, tpuArgs.fmt_d, tpuArgs.step_m, tpuArgs.step_n, tpuArgs.step_k, rs1_data, rs2_data, rs3_data, rs4_data, rs5_data, rd_data, trace_data.get());
+        } else {
+          tensor_unit_->wmma(wid, tpuArgs.fmt_s, tpuArgs.fmt_d, tpuArgs.step_m, tpuArgs.step_n, rs1_data, rs2_data, rs3_data, rd_data, trace_data.get());
+        }
         rd_write = true;
       } break;
       default:
@@ -1493,6 +1509,69 @@ instr_trace_t* Emulator::execute(const Instr &instr, uint32_t wid) {
         dma_cfg.has_size = true;
         DT(3, "DMA Set SIZE: size=" << dma_cfg.size);
       } break;
+
+      case DmaType::SET_PARAM: {
+        // Read descriptor parameter from rs1
+        auto value = rs1_data[thread_start].u;
+        auto& shape = dma_cfg.shape;
+        DT(3, "DMA Set PARAM: param=" << dmaArgs.param << ", value=" << value);
+        if (dmaArgs.param == VX_DMA_PARAM_GROUP) {
+          if (value >= DMA_NUM_GROUPS) {
+            DT(1, "ERROR: invalid DMA group " << value);
+            std::abort();
+          }
+          dma_cfg.group = value;
+          break;
+        }
+        if (dmaArgs.param == VX_DMA_PARAM_BARRIER) {
+          if (value >= arch_.num_barriers()) {
+            DT(1, "ERROR: invalid DMA barrier " << value);
+            std::abort();
+          }
+          dma_cfg.barrier = value;
+          break;
+        }
+        if (dmaArgs.param == VX_DMA_PARAM_CORE_MASK) {
+          // the mask is 32 bits wide
+          uint32_t num_cores = core_->socket()->num_cores();
+          uint64_t mask = value;
+          if ((mask >> 32) != 0 || (num_cores < 32 && (mask >> num_cores) != 0)) {
+            DT(1, "ERROR: invalid DMA core mask 0x" << std::hex << value << std::dec);
+            std::abort();
+          }
+          dma_cfg.core_mask = value;
+          break;
+        }
+        {
+          // the descriptor fields are as wide as in the RTL engine
+          uint32_t field_bits = VX_DMA_COUNT_BITS;
+          if (dmaArgs.param == VX_DMA_PARAM_ELEM_SIZE) {
+            field_bits = VX_DMA_ELEM_SIZE_BITS;
+          } else if (dmaArgs.param >= VX_DMA_PARAM_SRC_STRIDE1 && dmaArgs.param <= VX_DMA_PARAM_DST_STRIDE2) {
+            field_bits = VX_DMA_STRIDE_BITS;
+          }
+          if ((uint64_t(value) >> field_bits) != 0) {
+            DT(1, "ERROR: DMA param " << dmaArgs.param << " value " << value << " exceeds " << field_bits << " bits");
+            std::abort();
+          }
+        }
+        switch (dmaArgs.param) {
+        case VX_DMA_PARAM_ELEM_SIZE:   shape.elem_size = value; break;
+        case VX_DMA_PARAM_COUNT0:      shape.count[0] = value; break;
+        case VX_DMA_PARAM_COUNT1:      shape.count[1] = value; break;
+        case VX_DMA_PARAM_COUNT2:      shape.count[2] = value; break;
+        case VX_DMA_PARAM_SRC_STRIDE1: shape.src_stride[0] = value; break;
+        case VX_DMA_PARAM_SRC_STRIDE2: shape.src_stride[1] = value; break;
+        case VX_DMA_PARAM_DST_STRIDE1: shape.dst_stride[0] = value; break;
+        case VX_DMA_PARAM_DST_STRIDE2: shape.dst_stride[1] = value; break;
+        case VX_DMA_PARAM_VALID0:      shape.valid[0] = value; break;
+        case VX_DMA_PARAM_VALID1:      shape.valid[1] = value; break;
+        case VX_DMA_PARAM_VALID2:      shape.valid[2] = value; break;
+        default:
+          std::abort();
+        }
+        dma_cfg.has_shape = true;
+      } break;
       
       case DmaType::TRIGGER: {
         // Check if configuration is complete
@@ -1502,15 +1581,22 @@ instr_trace_t* Emulator::execute(const Instr &instr, uint32_t wid) {
         }
         
         int direction = dmaArgs.direction;
+        if (dma_cfg.core_mask != 0 && direction != 0) {
+          DT(1, "ERROR: DMA multicast requires a G2L transfer!");
+          std::abort();
+        }
         
+        // 1D transfers are a single row of bytes
+        DmaShape shape = dma_cfg.has_shape ? dma_cfg.shape : DmaShape(dma_cfg.size);
+
         DT(3, "DMA Trigger: dst=0x" << std::hex << dma_cfg.dst_addr 
             << ", src=0x" << dma_cfg.src_addr 
-            << ", size=" << std::dec << dma_cfg.size
+            << ", size=" << std::dec << shape.valid_bytes()
             << ", direction=" << (direction == 0 ? "G2L" : "L2G"));
         
         // Request DMA transfer (using core's own DMA engine)
         int32_t dma_id = core_->dma_engine()->request_transfer(
-            dma_cfg.dst_addr, dma_cfg.src_addr, dma_cfg.size, direction
+            dma_cfg.dst_addr, dma_cfg.src_addr, shape, direction, dma_cfg.group, dma_cfg.barrier, dma_cfg.core_mask
         );
         
         if (dma_id >= 0) {
@@ -1537,6 +1623,31 @@ instr_trace_t* Emulator::execute(const Instr &instr, uint32_t wid) {
         dma_cfg.reset();
       } break;
       
+      case DmaType::CHAIN: {
+        // Read the head descriptor address from rs1
+        uint64_t head_addr = rs1_data[thread_start].u;
+        int32_t dma_id = core_->dma_engine()->request_chain(head_addr, dma_cfg.group, dma_cfg.barrier);
+        for (uint32_t t = 0; t < num_threads; ++t) {
+          if (!warp.tmask.test(t))
+            continue;
+          rd_data[t].i = dma_id;
+        }
+        rd_write = true;
+        DT(3, "DMA Chain: head=0x" << std::hex << head_addr << std::dec << ", id=" << dma_id);
+        dma_cfg.reset();
+      } break;
+
+      case DmaType::WAIT_GROUP: {
+        uint32_t group = rs1_data[thread_start].u;
+        if (group >= DMA_NUM_GROUPS) {
+          DT(1, "ERROR: invalid DMA group " << group);
+          std::abort();
+        }
+        trace->fetch_stall = true;
+        trace->data = std::make_shared<SfuTraceData>(group, 0);
+        DT(3, "DMA Wait group: group=" << group << ", stalling warp " << wid);
+      } break;
+
       case DmaType::WAIT: {
         // Read DMA ID from rs1
         uint32_t dma_id = rs1_data[thread_start].u;
@@ -161,6 +161,7 @@ void FpuUnit::tick() {
 LsuUnit::LsuUnit(const SimContext& ctx, Core* core)
 	: FuncUnit(ctx, core, "lsu-unit")
 	, pending_loads_(0)
+	, mem_trace_(MemTraceRecorder::instance().enabled() ? &MemTraceRecorder::instance() : nullptr)
 {}
 
 LsuUnit::~LsuUnit()
@@ -172,9 +173,19 @@ void LsuUnit::reset() {
 	}
 	pending_loads_ = 0;
 	remain_addrs_ = 0;
+	addrs_start_ = 0;
 }
 
 void LsuUnit::tick() {
+	if (core_->mem_replay_) {
+		// drive the memory ports from a recorded trace
+		for (uint32_t b = 0; b < NUM_LSU_BLOCKS; ++b) {
+			auto& lmem_switch = core_->lmem_switch_.at(b);
+			core_->mem_replay_->tick(core_->id(), b, lmem_switch->ReqIn, lmem_switch->RspIn);
+		}
+		return;
+	}
+
 	core_->perf_stats_.load_latency += pending_loads_;
 
 	// handle memory responses
@@ -185,6 +196,9 @@ void LsuUnit::tick() {
 		auto& state = states_.at(b);
 		auto& lsu_rsp = lsu_rsp_port.front();
 		DT(3, this->name() << "-mem-rsp: " << lsu_rsp);
+		if (mem_trace_) {
+			mem_trace_->response(core_->id(), b, lsu_rsp);
+		}
 		auto& entry = state.pending_rd_reqs.at(lsu_rsp.tag);
 		auto trace = entry.trace;
 		assert(entry.count != 0);
@@ -196,6 +210,9 @@ void LsuUnit::tick() {
 			if (entry.eop) {
 				int iw = trace->wid % ISSUE_WIDTH;
 				Outputs.at(iw).push(trace, 1);
+				if (core_->pc_profiler_) {
+					core_->pc_profiler_->mem_latency(trace->PC, SimPlatform::instance().cycles() - entry.start);
+				}
 			}
 		}
 		pending_loads_ -= lsu_rsp.mask.count();
@@ -288,6 +305,7 @@ void LsuUnit::tick() {
 					}
 				}
 				remain_addrs_ = pending_addrs_.size();
+				addrs_start_ = SimPlatform::instance().cycles();
 			}
 		}
 
@@ -299,6 +317,7 @@ void LsuUnit::tick() {
 			for (uint32_t i = 0; i < NUM_LSU_LANES; ++i) {
 				lsu_req.mask.set(i);
 				lsu_req.addrs.at(i) = pending_addrs_.at(t0 + i).addr;
+				lsu_req.sizes.at(i) = pending_addrs_.at(t0 + i).size;
 				--remain_addrs_;
 				if (remain_addrs_ == 0)
 					break;
@@ -309,15 +328,19 @@ void LsuUnit::tick() {
 
 			uint32_t tag = 0;
 			if (!is_write) {
-				tag = state.pending_rd_reqs.allocate({trace, count, is_eop});
+				tag = state.pending_rd_reqs.allocate({trace, count, is_eop, addrs_start_});
 			}
 			lsu_req.tag  = tag;
 			lsu_req.cid  = trace->cid;
+			lsu_req.wid  = trace->wid;
 			lsu_req.uuid = trace->uuid;
 
 			// send memory request
 			core_->lmem_switch_.at(block_idx)->ReqIn.push(lsu_req);
 			DT(3, this->name() << "-mem-req: " << lsu_req);
+			if (mem_trace_) {
+				mem_trace_->request(core_->id(), block_idx, lsu_req);
+			}
 
 			// update stats
 			if (is_write) {
@@ -362,35 +385,36 @@ void SfuUnit::tick() {
 			
 			if (dma_type == DmaType::SET_DST ||
 			    dma_type == DmaType::SET_SRC ||
-			    dma_type == DmaType::SET_SIZE) {
+			    dma_type == DmaType::SET_SIZE ||
+			    dma_type == DmaType::SET_PARAM) {
 				// Configuration instructions: fast pass through, 1 cycle
 				output.push(trace, 1);
 				DT(3, this->name() << ": op=" << dma_type << ", " << *trace);
 				
-			} else if (dma_type == DmaType::TRIGGER) {
+			} else if (dma_type == DmaType::TRIGGER || dma_type == DmaType::CHAIN) {
 				// Trigger instruction: slightly longer delay (access DMA Engine)
 				output.push(trace, 2 + delay);
-				DT(3, this->name() << ": op=DMA_TRIGGER, " << *trace);
-				
-			} else if (dma_type == DmaType::WAIT) {
+				DT(3, this->name() << ": op=" << dma_type << ", " << *trace);
+
+			} else if (dma_type == DmaType::WAIT || dma_type == DmaType::WAIT_GROUP) {
 				// Wait instruction: poll until completion
 				auto sfu_data = std::dynamic_pointer_cast<SfuTraceData>(trace->data);
 				
 				if (sfu_data) {
-					uint32_t dma_id = sfu_data->arg1;
+					uint32_t arg = sfu_data->arg1;
 					
-					// Check if DMA is completed
-					bool completed = core_->dma_engine()->is_completed(dma_id);
+					// Check if the DMA (or the whole group) is completed
+					bool completed = (dma_type == DmaType::WAIT)
+						? core_->dma_engine()->is_completed(arg)
+						: core_->dma_engine()->is_group_completed(arg);
 					
 					if (!completed) {
 						// Still in progress, do NOT pop input, keep stalling
 						DT(4, "DMA Wait stalling warp " << trace->wid 
-							<< " for DMA " << dma_id);
+							<< " for " << (dma_type == DmaType::WAIT ? "DMA " : "group ") << arg);
 						continue;  // Don't pop, don't push output
 					}
 					
-					// Completed! Acknowledge and release warp
-					core_->dma_engine()->acknowledge_completion(dma_id);
 					output.push(trace, 1 + delay);
 					
 					// IMPORTANT: Must resume warp here because continue below skips the check
@@ -399,7 +423,7 @@ void SfuUnit::tick() {
 					}
 					
 					DT(3, "DMA Wait complete: warp " << trace->wid 
-						<< ", DMA " << dma_id);
+						<< ", " << (dma_type == DmaType::WAIT ? "DMA " : "group ") << arg);
 				} else {
 					// No data? Just pass through and resume warp
 					output.push(trace, 1 + delay);
@@ -407,7 +431,7 @@ void SfuUnit::tick() {
 						core_->resume(trace->wid);
 					}
 				}
-				DT(3, this->name() << ": op=DMA_WAIT, " << *trace);
+				DT(3, this->name() << ": op=" << dma_type << ", " << *trace);
 			}
 			
 			input.pop();
@@ -16,6 +16,7 @@
 #include <simobject.h>
 #include <array>
 #include "instr_trace.h"
+#include "mem_trace.h"
 
 namespace vortex {
 
@@ -77,6 +78,7 @@ private:
 		instr_trace_t* trace;
 		uint32_t count;
 		bool eop;
+		uint64_t start;
 	};
 
 	struct lsu_state_t {
@@ -97,6 +99,8 @@ private:
 	uint64_t pending_loads_;
 	std::vector<mem_addr_size_t> pending_addrs_;
 	uint32_t remain_addrs_;
+	uint64_t addrs_start_;
+	MemTraceRecorder* mem_trace_; // nullptr when recording is disabled
 };
 
 ///////////////////////////////////////////////////////////////////////////////
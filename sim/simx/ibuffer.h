@@ -14,7 +14,7 @@
 #pragma once
 
 #include "instr_trace.h"
-#include <queue>
+#include <deque>
 
 namespace vortex {
 
@@ -32,25 +32,28 @@ public:
 		return (entries_.size() == capacity_);
 	}
 
+	uint32_t size() const {
+		return entries_.size();
+	}
+
 	instr_trace_t* top() const {
 		return entries_.front();
 	}
 
 	void push(instr_trace_t* trace) {
-		entries_.emplace(trace);
+		entries_.emplace_back(trace);
 	}
 
 	void pop() {
-		return entries_.pop();
+		return entries_.pop_front();
 	}
 
 	void reset() {
-		std::queue<instr_trace_t*> empty;
-		std::swap(entries_, empty );
+		entries_.clear();
 	}
 
 private:
-	std::queue<instr_trace_t*> entries_;
+	std::deque<instr_trace_t*> entries_;
 	uint32_t capacity_;
 };
 
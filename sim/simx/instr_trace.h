@@ -90,6 +90,11 @@ public:
 
   uint64_t issue_time ;
 
+  // in-flight list links (see TraceList)
+  instr_trace_t* pending_prev;
+  instr_trace_t* pending_next;
+  bool pending;
+
   instr_trace_t(uint64_t uuid, const Arch& arch)
     : uuid(uuid)
     , arch(arch)
@@ -108,6 +113,9 @@ public:
     , eop(true)
     , fetch_stall(false)
     , issue_time(SimPlatform::instance().cycles())
+    , pending_prev(nullptr)
+    , pending_next(nullptr)
+    , pending(false)
     , log_once_(false)
   {}
 
@@ -129,6 +137,9 @@ public:
     , eop(rhs.eop)
     , fetch_stall(rhs.fetch_stall)
     , issue_time(rhs.issue_time)
+    , pending_prev(nullptr)
+    , pending_next(nullptr)
+    , pending(false)
     , log_once_(false)
   {}
 
@@ -173,4 +184,69 @@ private:
 
 using TraceArbiter = TxArbiter<instr_trace_t*>;
 
+// Intrusive list of in-flight instructions with O(1) insertion and removal.
+// Split copies of a trace are never linked, so removal reports whether the
+// trace was the tracked original.
+class TraceList {
+public:
+  TraceList() : head_(nullptr), tail_(nullptr), size_(0) {}
+
+  void push_back(instr_trace_t* trace) {
+    assert(!trace->pending);
+    trace->pending = true;
+    trace->pending_prev = tail_;
+    trace->pending_next = nullptr;
+    if (tail_) {
+      tail_->pending_next = trace;
+    } else {
+      head_ = trace;
+    }
+    tail_ = trace;
+    ++size_;
+  }
+
+  bool remove(instr_trace_t* trace) {
+    if (!trace->pending)
+      return false;
+    if (trace->pending_prev) {
+      trace->pending_prev->pending_next = trace->pending_next;
+    } else {
+      head_ = trace->pending_next;
+    }
+    if (trace->pending_next) {
+      trace->pending_next->pending_prev = trace->pending_prev;
+    } else {
+      tail_ = trace->pending_prev;
+    }
+    trace->pending = false;
+    trace->pending_prev = nullptr;
+    trace->pending_next = nullptr;
+    --size_;
+    return true;
+  }
+
+  void clear() {
+    head_ = nullptr;
+    tail_ = nullptr;
+    size_ = 0;
+  }
+
+  instr_trace_t* front() const {
+    return head_;
+  }
+
+  bool empty() const {
+    return (size_ == 0);
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+private:
+  instr_trace_t* head_;
+  instr_trace_t* tail_;
+  size_t size_;
+};
+
 }
\ No newline at end of file
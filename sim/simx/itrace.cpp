@@ -0,0 +1,147 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <stdlib.h>
+#include "itrace.h"
+#include "instr_trace.h"
+#include "constants.h"
+
+using namespace vortex;
+
+ITraceWriter::ITraceWriter()
+  : file_(nullptr)
+  , buffer_size_(64 * 1024)
+  , fill_(&buffers_[0])
+  , pending_(nullptr)
+  , exit_(false)
+{
+  auto path_s = getenv("VORTEX_ITRACE");
+  if (path_s == nullptr || path_s[0] == '\0')
+    return;
+  file_ = fopen(path_s, "wb");
+  if (file_ == nullptr) {
+    std::cerr << "Error: cannot open instruction trace " << path_s << std::endl;
+    return;
+  }
+
+  itrace_header_t header;
+  header.magic       = ITRACE_MAGIC;
+  header.version     = ITRACE_VERSION;
+  header.record_size = sizeof(itrace_record_t);
+  header.xlen        = XLEN;
+  header.num_threads = NUM_THREADS;
+  header.reserved    = 0;
+  fwrite(&header, sizeof(header), 1, file_);
+
+  buffers_[0].reserve(buffer_size_);
+  buffers_[1].reserve(buffer_size_);
+  thread_ = std::thread(&ITraceWriter::run, this);
+}
+
+ITraceWriter::~ITraceWriter() {
+  if (file_ == nullptr)
+    return;
+  this->flush();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    exit_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+  fclose(file_);
+}
+
+void ITraceWriter::write(const instr_trace_t& trace, uint32_t code, uint64_t cycle) {
+  {
+    auto& rec = this->alloc();
+    rec.uuid  = trace.uuid;
+    rec.cycle = cycle;
+    rec.addr  = trace.PC;
+    rec.tmask = 0;
+    for (uint32_t t = 0, n = std::min<uint32_t>(trace.tmask.size(), 64); t < n; ++t) {
+      rec.tmask |= uint64_t(trace.tmask.test(t)) << t;
+    }
+    rec.code  = code;
+    rec.cid   = trace.cid;
+    rec.wid   = trace.wid;
+    rec.kind  = (uint8_t)ITraceKind::Instr;
+  }
+
+  // memory accesses
+  bool is_store = false;
+  if (auto lsu_type = std::get_if<LsuType>(&trace.op_type)) {
+    if (*lsu_type == LsuType::FENCE)
+      return;
+    is_store = (*lsu_type == LsuType::STORE);
+  } else if (auto amo_type = std::get_if<AmoType>(&trace.op_type)) {
+    is_store = (*amo_type != AmoType::LR);
+  } else {
+    return;
+  }
+  auto trace_data = std::dynamic_pointer_cast<LsuTraceData>(trace.data);
+  if (trace_data == nullptr)
+    return;
+  for (uint32_t t = 0; t < trace_data->mem_addrs.size(); ++t) {
+    if (!trace.tmask.test(t))
+      continue;
+    auto& mem_addr = trace_data->mem_addrs.at(t);
+    auto& rec = this->alloc();
+    rec.uuid  = trace.uuid;
+    rec.cycle = cycle;
+    rec.addr  = mem_addr.addr;
+    rec.tmask = t;
+    rec.code  = mem_addr.size;
+    rec.cid   = trace.cid;
+    rec.wid   = trace.wid;
+    rec.kind  = (uint8_t)(is_store ? ITraceKind::Store : ITraceKind::Load);
+  }
+}
+
+void ITraceWriter::submit() {
+  // wait for the writer to release the other buffer
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [&]() { return pending_ == nullptr; });
+  pending_ = fill_;
+  fill_ = (fill_ == &buffers_[0]) ? &buffers_[1] : &buffers_[0];
+  fill_->clear();
+  lock.unlock();
+  cv_.notify_all();
+}
+
+void ITraceWriter::flush() {
+  if (file_ == nullptr)
+    return;
+  if (!fill_->empty()) {
+    this->submit();
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [&]() { return pending_ == nullptr; });
+  fflush(file_);
+}
+
+void ITraceWriter::run() {
+  for (;;) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&]() { return pending_ != nullptr || exit_; });
+    if (pending_ == nullptr)
+      break;
+    auto buffer = pending_;
+    lock.unlock();
+    fwrite(buffer->data(), sizeof(itrace_record_t), buffer->size(), file_);
+    lock.lock();
+    pending_ = nullptr;
+    lock.unlock();
+    cv_.notify_all();
+  }
+}
@@ -0,0 +1,113 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdio>
+#include "types.h"
+
+namespace vortex {
+
+struct instr_trace_t;
+
+// Binary instruction trace file layout (little-endian):
+//   itrace_header_t, followed by fixed-size itrace_record_t entries.
+// Each executed instruction emits an Instr record, followed by one Load or
+// Store record per active thread for memory instructions.
+// Decode with ci/itrace_decode.py.
+
+#define ITRACE_MAGIC   0x54495856 // "VXIT"
+#define ITRACE_VERSION 1
+
+struct itrace_header_t {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t record_size;
+  uint16_t xlen;
+  uint16_t num_threads;
+  uint32_t reserved;
+};
+
+enum class ITraceKind : uint8_t {
+  Instr,
+  Load,
+  Store
+};
+
+struct itrace_record_t {
+  uint64_t uuid;
+  uint64_t cycle;  // schedule cycle
+  uint64_t addr;   // Instr: PC, Load/Store: memory address
+  uint64_t tmask;  // Instr: thread mask, Load/Store: thread index
+  uint32_t code;   // Instr: instruction word, Load/Store: access size
+  uint16_t cid;
+  uint8_t  wid;
+  uint8_t  kind;
+};
+
+static_assert(sizeof(itrace_record_t) == 40, "invalid itrace record size");
+
+// Shared trace writer, enabled by setting VORTEX_ITRACE to the output path.
+// Records are batched in a buffer that a background thread writes out
+// while the simulation fills the next one.
+class ITraceWriter {
+public:
+  static ITraceWriter& instance() {
+    static ITraceWriter s_inst;
+    return s_inst;
+  }
+
+  ~ITraceWriter();
+
+  bool enabled() const {
+    return (file_ != nullptr);
+  }
+
+  // record an executed instruction and its memory accesses
+  void write(const instr_trace_t& trace, uint32_t code, uint64_t cycle);
+
+  // wait until all records are on disk
+  void flush();
+
+private:
+
+  ITraceWriter();
+
+  itrace_record_t& alloc() {
+    if (fill_->size() == buffer_size_) {
+      this->submit();
+    }
+    fill_->emplace_back();
+    return fill_->back();
+  }
+
+  void submit();
+
+  void run();
+
+  FILE* file_;
+  size_t buffer_size_;
+  std::vector<itrace_record_t> buffers_[2];
+  std::vector<itrace_record_t>* fill_;
+  std::vector<itrace_record_t>* pending_;
+  bool exit_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread thread_;
+};
+
+}
@@ -15,6 +15,7 @@
 #include "core.h"
 #include <bitmanip.h>
 #include <vector>
+#include <algorithm>
 #include "types.h"
 
 using namespace vortex;
@@ -25,40 +26,150 @@ protected:
 	Config    config_;
 	RAM       ram_;
 	uint32_t 	line_bits_;
-	MemCrossBar::Ptr mem_xbar_;
+	uint32_t  lg2_line_size_;
+	IndexHash bank_hash_;
+	BitVector<> batch_mask_;   // lanes of warp accesses in progress
+	BitVector<> pending_mask_; // lanes of warp accesses starting this cycle
+	std::vector<std::vector<uint64_t>> bank_words_;
+	std::vector<std::vector<uint64_t>> batch_words_;
+	std::vector<bool> bank_stalled_;
 	mutable PerfStats perf_stats_;
 
 	uint64_t to_local_addr(uint64_t addr) {
 		return bit_getw(addr, 0, line_bits_-1);
 	}
 
+	uint64_t word_addr(const MemReq& req) const {
+		return bit_getw(req.addr, lg2_line_size_, lg2_line_size_ + line_bits_ - 1);
+	}
+
+	uint32_t bank_id(const MemReq& req) const {
+		return bank_hash_(this->word_addr(req));
+	}
+
+	// claim a bank port for the request, returns false on conflict
+	bool bank_grant(const MemReq& req, bool* shared) {
+		auto& words = bank_words_.at(this->bank_id(req));
+		auto word = this->word_addr(req);
+		*shared = false;
+		if (config_.broadcast && !req.write) {
+			for (auto w : words) {
+				if (w == word) {
+					*shared = true;
+					return true;
+				}
+			}
+		}
+		if (words.size() >= config_.num_ports)
+			return false;
+		// writes always occupy their own port
+		words.push_back(req.write ? ~0ull : word);
+		return true;
+	}
+
+	// open the warp access of the request at input head: gather its lanes among
+	// the pending inputs and record its bank conflict degree
+	void start_batch(uint32_t head) {
+		auto& head_req = simobject_->Inputs.at(head).front();
+
+		for (auto& words : batch_words_) {
+			words.clear();
+		}
+
+		uint32_t degree = 1;
+		for (uint32_t i = head; i < config_.num_reqs; ++i) {
+			if (!pending_mask_.test(i) || batch_mask_.test(i))
+				continue;
+			auto& req = simobject_->Inputs.at(i).front();
+			if (req.tag != head_req.tag
+			 || req.wid != head_req.wid
+			 || req.cid != head_req.cid
+			 || req.write != head_req.write)
+				continue;
+			batch_mask_.set(i);
+			auto& words = batch_words_.at(this->bank_id(req));
+			auto word = this->word_addr(req);
+			if (!config_.broadcast || req.write
+			 || std::find(words.begin(), words.end(), word) == words.end()) {
+				words.push_back(word);
+				uint32_t cycles = (words.size() + config_.num_ports - 1) / config_.num_ports;
+				degree = std::max(degree, cycles);
+			}
+		}
+
+		auto& histogram = perf_stats_.conflict_degree;
+		if (histogram.size() <= head_req.wid) {
+			histogram.resize(head_req.wid + 1);
+		}
+		auto& wid_histogram = histogram.at(head_req.wid);
+		if (wid_histogram.size() <= degree) {
+			wid_histogram.resize(degree + 1, 0);
+		}
+		++wid_histogram.at(degree);
+	}
+
+	// serve the lanes in mask that get a bank port this cycle
+	void serve_lanes(const BitVector<>& mask) {
+		for (uint32_t i = 0; i < config_.num_reqs; ++i) {
+			if (!mask.test(i))
+				continue;
+			auto& input = simobject_->Inputs.at(i);
+			auto& bank_req = input.front();
+
+			bool shared;
+			if (!this->bank_grant(bank_req, &shared)) {
+				bank_stalled_.at(this->bank_id(bank_req)) = true;
+				continue;
+			}
+			DT(4, simobject_->name() << "-bank" << this->bank_id(bank_req) << "-req" << i << ": " << bank_req);
+
+			if (!bank_req.write || config_.write_reponse) {
+				// request hop + bank access + response hop
+				MemRsp bank_rsp{bank_req.tag, bank_req.cid, bank_req.uuid};
+				simobject_->Outputs.at(i).push(bank_rsp, 3);
+			}
+
+			// update perf counters
+			perf_stats_.reads += !bank_req.write;
+			perf_stats_.writes += bank_req.write;
+			perf_stats_.broadcasts += shared;
+
+			// remove input
+			input.pop();
+			batch_mask_.reset(i);
+		}
+	}
+
 public:
 	Impl(LocalMem* simobject, const Config& config)
 		: simobject_(simobject)
 		, config_(config)
 		, ram_(config.capacity)
+		, bank_hash_(config.bank_hash, config.B)
+		, batch_mask_(config.num_reqs)
+		, pending_mask_(config.num_reqs)
+		, bank_words_(1 << config.B)
+		, batch_words_(1 << config.B)
+		, bank_stalled_(1 << config.B)
 	{
 		uint32_t total_lines = config.capacity / config.line_size;
 		line_bits_ = log2ceil(total_lines);
-
-		char sname[100];
-		snprintf(sname, 100, "%s-xbar", simobject->name().c_str());
-		uint32_t lg2_line_size = log2ceil(config_.line_size);
-		uint32_t num_banks = 1 << config.B;
-		mem_xbar_ = MemCrossBar::Create(sname, ArbiterType::Priority, config.num_reqs, num_banks,
-		 [lg2_line_size, num_banks](const MemCrossBar::ReqType& req) {
-    	// Custom logic to calculate the output index using bank interleaving
-			return (uint32_t)((req.addr >> lg2_line_size) & (num_banks-1));
-		});
-		for (uint32_t i = 0; i < config.num_reqs; ++i) {
-			simobject->Inputs.at(i).bind(&mem_xbar_->ReqIn.at(i));
-			mem_xbar_->RspIn.at(i).bind(&simobject->Outputs.at(i));
+		lg2_line_size_ = log2ceil(config.line_size);
+		if (config_.num_ports == 0) {
+			config_.num_ports = 1;
+		}
+		for (auto& words : bank_words_) {
+			words.reserve(config.num_reqs);
+		}
+		for (auto& words : batch_words_) {
+			words.reserve(config.num_reqs);
 		}
 	}
 
 	virtual ~Impl() {}
 
 	void reset() {
+		batch_mask_.reset();
 		perf_stats_ = PerfStats();
 	}
 
@@ -75,33 +186,38 @@ public:
 	}
 
 	void tick() {
-		// process bank requets from xbar
-		uint32_t num_banks = (1 << config_.B);
-		for (uint32_t i = 0; i < num_banks; ++i) {
-			auto& xbar_req_out = mem_xbar_->ReqOut.at(i);
-			if (xbar_req_out.empty())
-				continue;
+		// requests are served as warp accesses (one request per lane),
+		// lanes mapping to a busy bank retry on the next cycle.
+		pending_mask_.reset();
+		for (uint32_t i = 0; i < config_.num_reqs; ++i) {
+			if (!batch_mask_.test(i) && !simobject_->Inputs.at(i).empty()) {
+				pending_mask_.set(i);
+			}
+		}
+		if (batch_mask_.none() && pending_mask_.none())
+			return;
 
-			auto& bank_req = xbar_req_out.front();
-			DT(4, simobject_->name() << "-bank" << i << "-req : " << bank_req);
+		for (auto& words : bank_words_) {
+			words.clear();
+		}
+		std::fill(bank_stalled_.begin(), bank_stalled_.end(), false);
 
-			if (!bank_req.write || config_.write_reponse) {
-				// send xbar response
-				MemRsp bank_rsp{bank_req.tag, bank_req.cid, bank_req.uuid};
-				mem_xbar_->RspOut.at(i).push(bank_rsp);
+		// accesses in progress go first, new accesses from other warps
+		// use the bank ports left in the same cycle.
+		this->serve_lanes(batch_mask_);
+		for (uint32_t i = 0; i < config_.num_reqs; ++i) {
+			if (pending_mask_.test(i) && !batch_mask_.test(i)) {
+				this->start_batch(i);
 			}
+		}
+		this->serve_lanes(pending_mask_);
 
-			// update perf counters
-			perf_stats_.reads += !bank_req.write;
-			perf_stats_.writes += bank_req.write;
-
-			// remove input
-			xbar_req_out.pop();
+		for (auto stalled : bank_stalled_) {
+			perf_stats_.bank_stalls += stalled;
 		}
 	}
 
 	const PerfStats& perf_stats() const {
-		perf_stats_.bank_stalls = mem_xbar_->collisions();
 		return perf_stats_;
 	}
 };
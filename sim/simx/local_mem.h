@@ -26,23 +26,43 @@ public:
     uint32_t num_reqs;
     uint32_t B; // log2 number of banks
     bool write_reponse;
+    HashType bank_hash;
+    uint32_t num_ports; // accesses per bank per cycle (2: double-pumped)
+    bool broadcast;     // same-word reads share a single bank access
   };
 
   struct PerfStats {
     uint64_t reads;
     uint64_t writes;
     uint64_t bank_stalls;
+    uint64_t broadcasts;
+    std::vector<std::vector<uint64_t>> conflict_degree; // [wid][degree] request count
 
     PerfStats()
       : reads(0)
       , writes(0)
       , bank_stalls(0)
+      , broadcasts(0)
     {}
 
     PerfStats& operator+=(const PerfStats& rhs) {
       this->reads += rhs.reads;
       this->writes += rhs.writes;
       this->bank_stalls += rhs.bank_stalls;
+      this->broadcasts += rhs.broadcasts;
+      if (this->conflict_degree.size() < rhs.conflict_degree.size()) {
+        this->conflict_degree.resize(rhs.conflict_degree.size());
+      }
+      for (size_t w = 0; w < rhs.conflict_degree.size(); ++w) {
+        auto& dst = this->conflict_degree.at(w);
+        auto& src = rhs.conflict_degree.at(w);
+        if (dst.size() < src.size()) {
+          dst.resize(src.size(), 0);
+        }
+        for (size_t d = 0; d < src.size(); ++d) {
+          dst.at(d) += src.at(d);
+        }
+      }
       return *this;
     }
   };
@@ -29,7 +29,7 @@
 using namespace vortex;
 
 static void show_usage() {
-   std::cout << "Usage: [-c <cores>] [-w <warps>] [-t <threads>] [-v: vector-test] [-s: stats] [-h: help] <program>" << std::endl;
+   std::cout << "Usage: [-c <cores>] [-w <warps>] [-t <threads>] [-v: vector-test] [-s: stats] [-r <memtrace>: replay] [-h: help] <program>" << std::endl;
 }
 
 uint32_t num_threads = NUM_THREADS;
@@ -38,10 +38,11 @@ uint32_t num_cores = NUM_CORES;
 bool showStats = false;
 bool vector_test = false;
 const char* program = nullptr;
+const char* memtrace = nullptr;
 
 static void parse_args(int argc, char **argv) {
   	int c;
-  	while ((c = getopt(argc, argv, "t:w:c:vsh")) != -1) {
+  	while ((c = getopt(argc, argv, "t:w:c:r:vsh")) != -1) {
     	switch (c) {
       case 't':
         num_threads = atoi(optarg);
@@ -58,6 +59,9 @@ static void parse_args(int argc, char **argv) {
       case 's':
         showStats = true;
         break;
+      case 'r':
+        memtrace = optarg;
+        break;
     	case 'h':
       	show_usage();
       	exit(0);
@@ -71,6 +75,8 @@ static void parse_args(int argc, char **argv) {
 	if (optind < argc) {
 		program = argv[optind];
     std::cout << "Running " << program << "..." << std::endl;
+	} else if (memtrace) {
+    std::cout << "Replaying " << memtrace << "..." << std::endl;
 	} else {
 		show_usage();
     exit(-1);
@@ -95,6 +101,11 @@ int main(int argc, char **argv) {
     // attach memory module
     processor.attach_ram(&ram);
 
+    // replay a memory trace without executing instructions
+    if (program == nullptr) {
+      return processor.replay(memtrace);
+    }
+
 	  // setup base DCRs
     const uint64_t startup_addr(STARTUP_ADDR);
     processor.dcr_write(VX_DCR_BASE_STARTUP_ADDR0, startup_addr & 0xffffffff);
@@ -97,6 +97,7 @@ void MemCoalescer::tick() {
 
   BitVector<> out_mask(output_size_);
   std::vector<uint64_t> out_addrs(output_size_);
+  std::vector<uint32_t> out_sizes(output_size_);
 
   BitVector<> cur_mask(input_size_);
 
@@ -109,6 +110,10 @@ void MemCoalescer::tick() {
       uint64_t seed_addr = in_req.addrs.at(i) & addr_mask;
       cur_mask.set(i);
 
+      // track the byte span touched within the line
+      uint64_t span_start = in_req.addrs.at(i);
+      uint64_t span_end = span_start + this->access_size(in_req, i);
+
       // coalesce matching requests
       for (uint32_t s = r + 1; s < output_ratio_; ++s) {
         uint32_t j = o * output_ratio_ + s;
@@ -117,11 +122,16 @@ void MemCoalescer::tick() {
         uint64_t match_addr = in_req.addrs.at(j) & addr_mask;
         if (match_addr == seed_addr) {
           cur_mask.set(j);
+          span_start = std::min(span_start, in_req.addrs.at(j));
+          span_end = std::max(span_end, in_req.addrs.at(j) + this->access_size(in_req, j));
         }
       }
 
+      span_end = std::min(span_end, seed_addr + line_size_);
+
       out_mask.set(o);
-      out_addrs.at(o) = seed_addr;
+      out_addrs.at(o) = span_start;
+      out_sizes.at(o) = span_end - span_start;
       break;
     }
   }
@@ -140,7 +150,9 @@ void MemCoalescer::tick() {
   out_req.tag = tag;
   out_req.write = in_req.write;
   out_req.addrs = out_addrs;
+  out_req.sizes = out_sizes;
   out_req.cid = in_req.cid;
+  out_req.wid = in_req.wid;
   out_req.uuid = in_req.uuid;
 
   // send memory request
@@ -158,6 +170,11 @@ void MemCoalescer::tick() {
   }
 }
 
+uint32_t MemCoalescer::access_size(const LsuReq& req, uint32_t index) const {
+  uint32_t size = req.sizes.at(index);
+  return (size != 0) ? size : LSU_WORD_SIZE;
+}
+
 const MemCoalescer::PerfStats& MemCoalescer::perf_stats() const {
   return perf_stats_;
 }
\ No newline at end of file
@@ -54,6 +54,8 @@ public:
 
 private:
 
+  uint32_t access_size(const LsuReq& req, uint32_t index) const;
+
   struct pending_req_t {
     uint32_t tag;
     BitVector<> mask;
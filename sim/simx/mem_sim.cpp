@@ -45,9 +45,9 @@ public:
 		char sname[100];
 		snprintf(sname, 100, "%s-xbar", simobject->name().c_str());
 		mem_xbar_ = MemCrossBar::Create(sname, ArbiterType::RoundRobin, config.num_ports, config.num_banks,
-			[lg2_block_size = log2ceil(config.block_size), num_banks = config.num_banks](const MemCrossBar::ReqType& req) {
+			[lg2_block_size = log2ceil(config.block_size), bank_hash = IndexHash(config.bank_hash, log2ceil(config.num_banks))](const MemCrossBar::ReqType& req) {
     	// Custom logic to calculate the output index using bank interleaving
-			return (uint32_t)((req.addr >> lg2_block_size) & (num_banks-1));
+			return bank_hash(req.addr >> lg2_block_size);
 		});
 		for (uint32_t i = 0; i < config.num_ports; ++i) {
 			simobject->MemReqPorts.at(i).bind(&mem_xbar_->ReqIn.at(i));
@@ -66,6 +66,7 @@ public:
 
 	void reset() {
 		dram_sim_.reset();
+		perf_stats_ = PerfStats();
 	}
 
 	void tick() {
@@ -77,6 +78,17 @@ public:
 
 			auto& mem_req = mem_xbar_->ReqOut.at(i).front();
 
+			// sectored fills and write-backs transfer partial blocks,
+			// other requests (e.g. write-through) keep full-block bursts
+			uint32_t req_bytes = mem_req.sectored ? std::min(mem_req.size, config_.block_size) : config_.block_size;
+			if (mem_req.write) {
+				++perf_stats_.writes;
+				perf_stats_.write_bytes += req_bytes;
+			} else {
+				++perf_stats_.reads;
+				perf_stats_.read_bytes += req_bytes;
+			}
+
 			// enqueue the request to the memory system
 			auto req_args = new DramCallbackArgs{this, mem_req, i};
 			dram_sim_.send_request(
@@ -92,7 +104,8 @@ public:
 					}
 					delete rsp_args;
 				},
-				req_args
+				req_args,
+				req_bytes
 			);
 
 			DT(3, simobject_->name() << "-mem-req" << i << ": " << mem_req);
@@ -25,16 +25,29 @@ public:
 		uint32_t num_ports;
 		uint32_t block_size;
 		float clock_ratio;
+		HashType bank_hash;
 	};
 
 	struct PerfStats {
+		uint64_t reads;
+		uint64_t writes;
+		uint64_t read_bytes;
+		uint64_t write_bytes;
 		uint64_t bank_stalls;
 
 		PerfStats()
-			: bank_stalls(0)
+			: reads(0)
+			, writes(0)
+			, read_bytes(0)
+			, write_bytes(0)
+			, bank_stalls(0)
 		{}
 
 		PerfStats& operator+=(const PerfStats& rhs) {
+			this->reads += rhs.reads;
+			this->writes += rhs.writes;
+			this->read_bytes += rhs.read_bytes;
+			this->write_bytes += rhs.write_bytes;
 			this->bank_stalls += rhs.bank_stalls;
 			return *this;
 		}
@@ -0,0 +1,280 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <limits>
+#include <stdlib.h>
+#include "mem_trace.h"
+#include "debug.h"
+
+using namespace vortex;
+
+static uint64_t read_key(uint32_t cid, uint32_t block, uint32_t tag) {
+  return (uint64_t(cid) << 40) | (uint64_t(block) << 32) | tag;
+}
+
+static uint64_t warp_key(uint32_t cid, uint32_t wid) {
+  return (uint64_t(cid) << 32) | wid;
+}
+
+MemTraceRecorder::MemTraceRecorder()
+  : file_(nullptr)
+  , num_records_(0)
+  , base_(0)
+{
+  auto path_s = getenv("VORTEX_MEMTRACE");
+  if (path_s == nullptr || path_s[0] == '\0')
+    return;
+  file_ = fopen(path_s, "wb");
+  if (file_ == nullptr) {
+    std::cerr << "Error: cannot open memory trace " << path_s << std::endl;
+    return;
+  }
+
+  memtrace_header_t header;
+  header.magic       = MEMTRACE_MAGIC;
+  header.version     = MEMTRACE_VERSION;
+  header.record_size = sizeof(memtrace_record_t);
+  header.num_lanes   = NUM_LSU_LANES;
+  header.num_blocks  = NUM_LSU_BLOCKS;
+  header.reserved    = 0;
+  fwrite(&header, sizeof(header), 1, file_);
+}
+
+MemTraceRecorder::~MemTraceRecorder() {
+  if (file_ == nullptr)
+    return;
+  fclose(file_);
+}
+
+void MemTraceRecorder::request(uint32_t cid, uint32_t block, const LsuReq& req) {
+  auto cycle = SimPlatform::instance().cycles();
+  auto index = num_records_++;
+
+  memtrace_record_t rec;
+  rec.cycle    = base_ + cycle;
+  rec.dep      = MEMTRACE_NO_DEP;
+  rec.gap      = 0;
+  rec.cid      = cid;
+  rec.block    = block;
+  rec.wid      = req.wid;
+  rec.write    = req.write;
+  rec.count    = req.mask.count();
+  rec.reserved = 0;
+
+  auto it = last_reads_.find(warp_key(cid, req.wid));
+  if (it != last_reads_.end()) {
+    rec.dep = it->second.index;
+    rec.gap = std::min<uint64_t>(cycle - it->second.cycle, std::numeric_limits<uint32_t>::max());
+  }
+
+  fwrite(&rec, sizeof(rec), 1, file_);
+  for (uint32_t i = 0; i < req.mask.size(); ++i) {
+    if (!req.mask.test(i))
+      continue;
+    memtrace_addr_t entry{req.addrs.at(i), req.sizes.at(i), i};
+    fwrite(&entry, sizeof(entry), 1, file_);
+  }
+
+  if (!req.write) {
+    pending_reads_[read_key(cid, block, req.tag)] = {index, rec.count, req.wid};
+  }
+}
+
+void MemTraceRecorder::response(uint32_t cid, uint32_t block, const LsuRsp& rsp) {
+  auto it = pending_reads_.find(read_key(cid, block, rsp.tag));
+  if (it == pending_reads_.end())
+    return;
+  auto& entry = it->second;
+  entry.count -= rsp.mask.count();
+  if (entry.count != 0)
+    return;
+  last_reads_[warp_key(cid, entry.wid)] = {entry.index, SimPlatform::instance().cycles()};
+  pending_reads_.erase(it);
+}
+
+void MemTraceRecorder::flush() {
+  if (file_ == nullptr)
+    return;
+  // dependencies do not carry across kernel launches
+  pending_reads_.clear();
+  last_reads_.clear();
+  base_ += SimPlatform::instance().cycles();
+  fflush(file_);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+MemTraceReplayer::MemTraceReplayer(uint32_t num_cores)
+  : num_cores_(num_cores)
+  , streams_(num_cores * NUM_LSU_BLOCKS)
+{}
+
+bool MemTraceReplayer::load(const std::string& path) {
+  auto file = fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    std::cerr << "Error: cannot open memory trace " << path << std::endl;
+    return false;
+  }
+
+  memtrace_header_t header;
+  if (fread(&header, sizeof(header), 1, file) != 1
+   || header.magic != MEMTRACE_MAGIC) {
+    std::cerr << "Error: invalid memory trace " << path << std::endl;
+    fclose(file);
+    return false;
+  }
+  if (header.version != MEMTRACE_VERSION
+   || header.record_size != sizeof(memtrace_record_t)) {
+    std::cerr << "Error: unsupported memory trace version " << header.version << std::endl;
+    fclose(file);
+    return false;
+  }
+  if (header.num_lanes != NUM_LSU_LANES
+   || header.num_blocks != NUM_LSU_BLOCKS) {
+    std::cerr << "Error: memory trace recorded with " << header.num_blocks << " LSU blocks of "
+              << header.num_lanes << " lanes, expected " << NUM_LSU_BLOCKS << " of " << NUM_LSU_LANES << std::endl;
+    fclose(file);
+    return false;
+  }
+
+  records_.clear();
+  addrs_.clear();
+  for (auto& stream : streams_) {
+    stream.requests.clear();
+  }
+
+  memtrace_record_t rec;
+  while (fread(&rec, sizeof(rec), 1, file) == 1) {
+    if (rec.cid >= num_cores_
+     || rec.block >= NUM_LSU_BLOCKS
+     || rec.count > NUM_LSU_LANES
+     || (rec.dep != MEMTRACE_NO_DEP && rec.dep >= records_.size())) {
+      std::cerr << "Error: invalid memory trace record #" << records_.size()
+                << " (cid=" << rec.cid << ", block=" << uint32_t(rec.block) << ")" << std::endl;
+      fclose(file);
+      return false;
+    }
+    uint64_t index = records_.size();
+    records_.push_back({rec, addrs_.size()});
+    addrs_.resize(addrs_.size() + rec.count);
+    if (fread(&addrs_.at(addrs_.size() - rec.count), sizeof(memtrace_addr_t), rec.count, file) != rec.count) {
+      std::cerr << "Error: truncated memory trace " << path << std::endl;
+      fclose(file);
+      return false;
+    }
+    streams_.at(rec.cid * NUM_LSU_BLOCKS + rec.block).requests.push_back(index);
+  }
+  fclose(file);
+
+  this->reset();
+  return true;
+}
+
+void MemTraceReplayer::reset() {
+  for (auto& stream : streams_) {
+    stream.next = 0;
+    stream.last_issue = 0;
+    stream.last_cycle = 0;
+    stream.pending_reads.clear();
+  }
+  completions_.assign(records_.size(), std::numeric_limits<uint64_t>::max());
+  perf_stats_ = PerfStats();
+}
+
+void MemTraceReplayer::tick(uint32_t cid, uint32_t block, SimPort<LsuReq>& req_port, SimPort<LsuRsp>& rsp_port) {
+  auto& stream = streams_.at(cid * NUM_LSU_BLOCKS + block);
+  auto cycle = SimPlatform::instance().cycles();
+
+  // handle memory responses
+  if (!rsp_port.empty()) {
+    auto& lsu_rsp = rsp_port.front();
+    auto& entry = stream.pending_reads.at(lsu_rsp.tag);
+    assert(entry.count != 0);
+    entry.count -= lsu_rsp.mask.count();
+    if (entry.count == 0) {
+      completions_.at(entry.index) = cycle;
+      perf_stats_.read_latency += cycle - entry.issue;
+      stream.pending_reads.release(lsu_rsp.tag);
+    }
+    rsp_port.pop();
+  }
+
+  if (stream.next == stream.requests.size())
+    return;
+
+  auto index = stream.requests.at(stream.next);
+  auto& request = records_.at(index);
+  auto& rec = request.record;
+
+  // issue when the producing read has completed, otherwise keep the recorded spacing
+  uint64_t ready;
+  if (rec.dep != MEMTRACE_NO_DEP) {
+    auto completion = completions_.at(rec.dep);
+    if (completion == std::numeric_limits<uint64_t>::max()) {
+      ++perf_stats_.dep_stalls;
+      return;
+    }
+    ready = completion + rec.gap;
+  } else if (stream.next == 0) {
+    ready = rec.cycle;
+  } else {
+    ready = stream.last_issue + (rec.cycle - stream.last_cycle);
+  }
+  if (cycle < ready)
+    return;
+
+  if (!rec.write && stream.pending_reads.full()) {
+    ++perf_stats_.queue_stalls;
+    return;
+  }
+
+  LsuReq lsu_req(NUM_LSU_LANES);
+  lsu_req.write = rec.write;
+  for (uint32_t i = 0; i < rec.count; ++i) {
+    auto& entry = addrs_.at(request.first_addr + i);
+    lsu_req.mask.set(entry.lane);
+    lsu_req.addrs.at(entry.lane) = entry.addr;
+    lsu_req.sizes.at(entry.lane) = entry.size;
+  }
+  if (!rec.write) {
+    lsu_req.tag = stream.pending_reads.allocate({index, rec.count, cycle});
+  }
+  lsu_req.cid  = cid;
+  lsu_req.wid  = rec.wid;
+  lsu_req.uuid = index;
+
+  req_port.push(lsu_req);
+  DT(3, "mem-replay-req: " << lsu_req);
+
+  if (rec.write) {
+    completions_.at(index) = cycle;
+    ++perf_stats_.writes;
+  } else {
+    ++perf_stats_.reads;
+  }
+
+  stream.last_issue = cycle;
+  stream.last_cycle = rec.cycle;
+  ++stream.next;
+}
+
+bool MemTraceReplayer::done(uint32_t cid) const {
+  for (uint32_t b = 0; b < NUM_LSU_BLOCKS; ++b) {
+    auto& stream = streams_.at(cid * NUM_LSU_BLOCKS + b);
+    if (stream.next != stream.requests.size()
+     || !stream.pending_reads.empty())
+      return false;
+  }
+  return true;
+}
@@ -0,0 +1,185 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdio>
+#include <simobject.h>
+#include "types.h"
+
+namespace vortex {
+
+// Memory trace file layout (little-endian):
+//   memtrace_header_t, followed by one memtrace_record_t per LSU request,
+//   each followed by 'count' memtrace_addr_t entries (one per active lane).
+// Requests are captured at the LSU <-> local memory switch boundary, i.e. the
+// stream that enters the L1 data cache / local memory path.
+// A request's 'dep' is the most recent read of the same warp that completed
+// before it was issued, and 'gap' the cycles between that completion and the
+// issue; replay uses them to re-time requests against a different memory system.
+
+#define MEMTRACE_MAGIC   0x544d5856 // "VXMT"
+#define MEMTRACE_VERSION 1
+#define MEMTRACE_NO_DEP  uint64_t(-1)
+
+struct memtrace_header_t {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t record_size;
+  uint16_t num_lanes;
+  uint16_t num_blocks;
+  uint32_t reserved;
+};
+
+struct memtrace_record_t {
+  uint64_t cycle;   // issue cycle
+  uint64_t dep;     // index of the producing read (MEMTRACE_NO_DEP if none)
+  uint32_t gap;     // cycles from dep completion to issue
+  uint32_t cid;
+  uint8_t  block;   // LSU block
+  uint8_t  wid;
+  uint8_t  write;
+  uint8_t  count;   // number of memtrace_addr_t entries that follow
+  uint32_t reserved;
+};
+
+struct memtrace_addr_t {
+  uint64_t addr;
+  uint32_t size;
+  uint32_t lane;
+};
+
+static_assert(sizeof(memtrace_record_t) == 32, "invalid memtrace record size");
+static_assert(sizeof(memtrace_addr_t) == 16, "invalid memtrace address size");
+
+// Shared recorder, enabled by setting VORTEX_MEMTRACE to the output path.
+class MemTraceRecorder {
+public:
+  static MemTraceRecorder& instance() {
+    static MemTraceRecorder s_inst;
+    return s_inst;
+  }
+
+  ~MemTraceRecorder();
+
+  bool enabled() const {
+    return (file_ != nullptr);
+  }
+
+  // record a request sent by an LSU block
+  void request(uint32_t cid, uint32_t block, const LsuReq& req);
+
+  // record a response received by an LSU block
+  void response(uint32_t cid, uint32_t block, const LsuRsp& rsp);
+
+  // flush pending records and rebase cycles for the next run
+  void flush();
+
+private:
+
+  MemTraceRecorder();
+
+  struct pending_read_t {
+    uint64_t index;
+    uint32_t count;
+    uint32_t wid;
+  };
+
+  struct last_read_t {
+    uint64_t index;
+    uint64_t cycle;
+  };
+
+  FILE* file_;
+  uint64_t num_records_;
+  uint64_t base_;
+  std::unordered_map<uint64_t, pending_read_t> pending_reads_; // by (cid, block, tag)
+  std::unordered_map<uint64_t, last_read_t> last_reads_;       // by (cid, wid)
+};
+
+// Replays a recorded memory trace into the LSU ports of each core,
+// preserving per-block request order and read-to-request dependencies.
+class MemTraceReplayer {
+public:
+  struct PerfStats {
+    uint64_t reads;
+    uint64_t writes;
+    uint64_t read_latency;
+    uint64_t dep_stalls;
+    uint64_t queue_stalls;
+
+    PerfStats()
+      : reads(0)
+      , writes(0)
+      , read_latency(0)
+      , dep_stalls(0)
+      , queue_stalls(0)
+    {}
+  };
+
+  MemTraceReplayer(uint32_t num_cores);
+
+  // load a trace file, returns false on error
+  bool load(const std::string& path);
+
+  void reset();
+
+  // drive one LSU block of a core for the current cycle
+  void tick(uint32_t cid, uint32_t block, SimPort<LsuReq>& req_port, SimPort<LsuRsp>& rsp_port);
+
+  // all requests of a core have been issued and answered
+  bool done(uint32_t cid) const;
+
+  uint64_t num_requests() const {
+    return records_.size();
+  }
+
+  const PerfStats& perf_stats() const {
+    return perf_stats_;
+  }
+
+private:
+
+  struct request_t {
+    memtrace_record_t record;
+    uint64_t first_addr;
+  };
+
+  struct pending_read_t {
+    uint64_t index;
+    uint32_t count;
+    uint64_t issue;
+  };
+
+  struct stream_t {
+    std::vector<uint64_t> requests;
+    uint64_t next;
+    uint64_t last_issue;
+    uint64_t last_cycle;
+    HashTable<pending_read_t> pending_reads;
+
+    stream_t() : pending_reads(LSUQ_IN_SIZE) {}
+  };
+
+  uint32_t num_cores_;
+  std::vector<request_t> records_;
+  std::vector<memtrace_addr_t> addrs_;
+  std::vector<uint64_t> completions_;
+  std::vector<stream_t> streams_;
+  PerfStats perf_stats_;
+};
+
+}
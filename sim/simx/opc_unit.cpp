@@ -16,52 +16,223 @@
 
 using namespace vortex;
 
-OpcUnit::OpcUnit(const SimContext &ctx)
+static_assert(NUM_GPR_BANKS <= 32, "invalid NUM_GPR_BANKS value");
+
+RegFileBanks::RegFileBanks(uint32_t num_banks, uint32_t num_ports)
+  : num_banks_(num_banks)
+  , num_ports_(num_ports)
+  , cycles_(num_banks)
+  , used_ports_(num_banks) {
+  this->reset();
+}
+
+void RegFileBanks::reset() {
+  std::fill(cycles_.begin(), cycles_.end(), uint64_t(-1));
+  std::fill(used_ports_.begin(), used_ports_.end(), 0);
+}
+
+bool RegFileBanks::acquire(uint32_t bank_id) {
+  auto cycle = SimPlatform::instance().cycles();
+  if (cycles_.at(bank_id) != cycle) {
+    cycles_.at(bank_id) = cycle;
+    used_ports_.at(bank_id) = 0;
+  }
+  if (used_ports_.at(bank_id) >= num_ports_)
+    return false;
+  ++used_ports_.at(bank_id);
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+OpcUnit::OpcUnit(const SimContext &ctx, RegFileBanks* rf_banks, RegFileBanks* vrf_banks)
   : SimObject<OpcUnit>(ctx, "opc-unit")
-  , Input(this)
-  , Output(this) {
+  , Inputs(WARP_ISSUE_WIDTH, this)
+  , Outputs(WARP_ISSUE_WIDTH, this)
+  , rf_banks_(rf_banks)
+  , vrf_banks_(vrf_banks ? vrf_banks : rf_banks)
+  , collectors_(std::max<uint32_t>(OPC_NUM_CUS, WARP_ISSUE_WIDTH))
+  , rf_cache_(OPC_RF_CACHE_SIZE) {
   this->reset();
 }
 
 OpcUnit::~OpcUnit() {}
 
 void OpcUnit::reset() {
+  for (auto& cu : collectors_) {
+    cu.trace = nullptr;
+  }
+  for (auto& entry : rf_cache_) {
+    entry.valid = false;
+  }
+  order_ = 0;
+  lru_ = 0;
+  perf_stats_ = PerfStats();
   total_stalls_ = 0;
 }
 
 void OpcUnit::tick() {
-  if (Input.empty())
-    return;
-  auto trace = Input.front();
-
-  uint32_t stalls = 0;
+  // allocate a collector unit per issue slot
+  for (uint32_t k = 0; k < WARP_ISSUE_WIDTH; ++k) {
+    auto& input = Inputs.at(k);
+    if (input.empty())
+      continue;
+    collector_t* free_cu = nullptr;
+    for (auto& cu : collectors_) {
+      if (cu.trace == nullptr) {
+        free_cu = &cu;
+        break;
+      }
+    }
+    if (free_cu) {
+      auto trace = input.front();
+      uint32_t pending = 0;
+      for (uint32_t i = 0; i < NUM_SRC_REGS; ++i) {
+        auto& reg = trace->src_regs[i];
+        if (reg.type == RegType::None)
+          continue;
+        if (reg.type == RegType::Integer && reg.id() == 0)
+          continue; // skip x0
+        bool duplicate = false;
+        for (uint32_t j = 0; j < i; ++j) {
+          duplicate |= (trace->src_regs[j].id() == reg.id());
+        }
+        if (duplicate)
+          continue; // operand read once
+        if (this->rf_cache_lookup(trace->wid, reg.id())) {
+          ++perf_stats_.rf_cache_hits;
+          continue;
+        }
+        pending |= (1 << i);
+      }
+      free_cu->trace = trace;
+      free_cu->order = order_++;
+      free_cu->pending = pending;
+      input.pop();
+    } else {
+      ++perf_stats_.cu_stalls;
+      break;
+    }
+  }
 
-  // calculate bank conflict stalls
-  for (uint32_t i = 0; i < NUM_SRC_REGS; ++i) {
-    for (uint32_t j = i + 1; j < NUM_SRC_REGS; ++j) {
-      if ((trace->src_regs[i].type == RegType::None)
-       || (trace->src_regs[j].type == RegType::None))
+  // read operands, oldest collector first
+  uint64_t last_order = 0;
+  for (uint32_t n = 0; n < collectors_.size(); ++n) {
+    collector_t* next_cu = nullptr;
+    for (auto& cu : collectors_) {
+      if (cu.trace == nullptr || (n != 0 && cu.order <= last_order))
         continue;
-      if ((trace->src_regs[i].type == RegType::Integer && trace->src_regs[i].id() == 0)
-       || (trace->src_regs[j].type == RegType::Integer && trace->src_regs[j].id() == 0))
-        continue; // skip x0
-      // bank conflict
-      uint32_t bank_i = trace->src_regs[i].idx % NUM_GPR_BANKS;
-      uint32_t bank_j = trace->src_regs[j].idx % NUM_GPR_BANKS;
-      if (bank_i == bank_j)
-        ++stalls;
+      if (next_cu == nullptr || cu.order < next_cu->order) {
+        next_cu = &cu;
+      }
     }
+    if (next_cu == nullptr)
+      break;
+    this->collect(*next_cu);
+    last_order = next_cu->order;
   }
 
-  total_stalls_ += stalls;
+  // dispatch the oldest completed collectors, preserving warp order
+  // (slots may be allocated out of order, so compare schedule times)
+  for (uint32_t k = 0; k < WARP_ISSUE_WIDTH; ++k) {
+    collector_t* ready_cu = nullptr;
+    for (auto& cu : collectors_) {
+      if (cu.trace == nullptr || cu.pending != 0)
+        continue;
+      bool blocked = false;
+      for (auto& other : collectors_) {
+        blocked |= (other.trace != nullptr
+                 && other.trace->wid == cu.trace->wid
+                 && other.trace->issue_time < cu.trace->issue_time);
+      }
+      if (blocked)
+        continue;
+      if (ready_cu == nullptr || cu.order < ready_cu->order) {
+        ready_cu = &cu;
+      }
+    }
+    if (ready_cu == nullptr)
+      break;
+    auto trace = ready_cu->trace;
+    Outputs.at(k).push(trace, 2);
+    DT(3, "pipeline-operands: " << *trace);
+    ready_cu->trace = nullptr;
+  }
+}
 
-  Output.push(trace, 2 + stalls);
+void OpcUnit::collect(collector_t& cu) {
+  if (cu.pending == 0)
+    return;
+  auto trace = cu.trace;
+  uint64_t read_banks = 0;
+  bool bank_conflict = false;
+  for (uint32_t i = 0; i < NUM_SRC_REGS; ++i) {
+    if (!(cu.pending & (1 << i)))
+      continue;
+    auto& reg = trace->src_regs[i];
+    auto rf_banks = rf_banks_;
+    uint32_t bank_base = 0;
+  #ifdef EXT_V_ENABLE
+    if (reg.type == RegType::Vector && vrf_banks_ != rf_banks_) {
+      // vector register banks in the upper half of read_banks
+      rf_banks = vrf_banks_;
+      bank_base = 32;
+    }
+  #endif
+    uint32_t bank_id = rf_banks->bank_id(reg);
+    uint64_t bank_bit = 1ull << (bank_base + bank_id);
+    if (rf_banks->acquire(bank_id)) {
+      read_banks |= bank_bit;
+      cu.pending &= ~(1 << i);
+      ++perf_stats_.bank_reads;
+      this->rf_cache_insert(trace->wid, reg.id());
+    } else {
+      bank_conflict |= ((read_banks & bank_bit) != 0);
+    }
+  }
+  if (cu.pending != 0) {
+    if (bank_conflict) {
+      ++perf_stats_.bank_stalls;
+    } else {
+      ++perf_stats_.port_stalls;
+    }
+    ++total_stalls_;
+  }
+}
 
-  DT(3, "pipeline-operands: " << *trace);
+bool OpcUnit::rf_cache_lookup(uint32_t wid, uint32_t reg_id) {
+  for (auto& entry : rf_cache_) {
+    if (entry.valid && entry.wid == wid && entry.reg_id == reg_id) {
+      entry.lru = ++lru_;
+      return true;
+    }
+  }
+  return false;
+}
 
-  Input.pop();
+void OpcUnit::rf_cache_insert(uint32_t wid, uint32_t reg_id) {
+  if (rf_cache_.empty())
+    return;
+  rf_cache_entry_t* victim = nullptr;
+  for (auto& entry : rf_cache_) {
+    if (entry.valid && entry.wid == wid && entry.reg_id == reg_id) {
+      victim = &entry;
+      break;
+    }
+    if (victim == nullptr
+     || (victim->valid && (!entry.valid || entry.lru < victim->lru))) {
+      victim = &entry;
+    }
+  }
+  victim->wid = wid;
+  victim->reg_id = reg_id;
+  victim->lru = ++lru_;
+  victim->valid = true;
 }
 
 void OpcUnit::writeback(instr_trace_t* trace) {
-  __unused(trace);
-}
\ No newline at end of file
+  // results are written through the register file cache
+  if (trace->dst_reg.type != RegType::None) {
+    this->rf_cache_insert(trace->wid, trace->dst_reg.id());
+  }
+}
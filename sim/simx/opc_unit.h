@@ -19,12 +19,60 @@ namespace vortex {
 
 class Core;
 
+// Register file read ports shared by all the operand collectors of a core.
+// Ports are granted on a first-come basis within a cycle.
+class RegFileBanks {
+public:
+  RegFileBanks(uint32_t num_banks, uint32_t num_ports);
+
+  void reset();
+
+  uint32_t bank_id(const RegOpd& reg) const {
+    return reg.idx % num_banks_;
+  }
+
+  // claim a read port of the bank for the current cycle
+  bool acquire(uint32_t bank_id);
+
+private:
+  uint32_t num_banks_;
+  uint32_t num_ports_;
+  std::vector<uint64_t> cycles_;
+  std::vector<uint32_t> used_ports_;
+};
+
 class OpcUnit : public SimObject<OpcUnit> {
 public:
-  SimPort<instr_trace_t *> Input;
-  SimPort<instr_trace_t *> Output;
+  struct PerfStats {
+    uint64_t cu_stalls;     // cycles an instruction waited for a free collector
+    uint64_t bank_stalls;   // collector cycles lost to conflicts within the instruction
+    uint64_t port_stalls;   // collector cycles lost to reads from other collectors
+    uint64_t bank_reads;
+    uint64_t rf_cache_hits;
+
+    PerfStats()
+      : cu_stalls(0)
+      , bank_stalls(0)
+      , port_stalls(0)
+      , bank_reads(0)
+      , rf_cache_hits(0)
+    {}
 
-  OpcUnit(const SimContext &ctx);
+    PerfStats& operator+=(const PerfStats& rhs) {
+      this->cu_stalls += rhs.cu_stalls;
+      this->bank_stalls += rhs.bank_stalls;
+      this->port_stalls += rhs.port_stalls;
+      this->bank_reads += rhs.bank_reads;
+      this->rf_cache_hits += rhs.rf_cache_hits;
+      return *this;
+    }
+  };
+
+  std::vector<SimPort<instr_trace_t*>> Inputs;  // one per issue slot
+  std::vector<SimPort<instr_trace_t*>> Outputs;
+
+  // vrf_banks: separate banks for vector registers (nullptr: shared with GPRs)
+  OpcUnit(const SimContext &ctx, RegFileBanks* rf_banks, RegFileBanks* vrf_banks = nullptr);
   virtual ~OpcUnit();
 
   virtual void reset();
@@ -37,7 +85,38 @@ public:
     return total_stalls_;
   }
 
+  const PerfStats& perf_stats() const {
+    return perf_stats_;
+  }
+
 private:
+
+  struct collector_t {
+    instr_trace_t* trace;
+    uint64_t       order;
+    uint32_t       pending; // source operands left to read
+  };
+
+  struct rf_cache_entry_t {
+    uint32_t wid;
+    uint32_t reg_id;
+    uint64_t lru;
+    bool     valid;
+  };
+
+  bool rf_cache_lookup(uint32_t wid, uint32_t reg_id);
+
+  void rf_cache_insert(uint32_t wid, uint32_t reg_id);
+
+  void collect(collector_t& cu);
+
+  RegFileBanks* rf_banks_;
+  RegFileBanks* vrf_banks_;
+  std::vector<collector_t> collectors_;
+  std::vector<rf_cache_entry_t> rf_cache_;
+  uint64_t order_;
+  uint64_t lru_;
+  PerfStats perf_stats_;
   uint32_t total_stalls_ = 0;
 };
 
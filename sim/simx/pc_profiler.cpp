@@ -0,0 +1,228 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <elf.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pc_profiler.h"
+
+using namespace vortex;
+
+namespace {
+
+struct symbol_t {
+  std::string name;
+  uint64_t size;
+};
+
+typedef std::map<uint64_t, symbol_t> SymbolTable;
+
+template <typename Ehdr, typename Shdr, typename Sym>
+bool read_symbols(const std::vector<char>& image, SymbolTable& symbols) {
+  if (image.size() < sizeof(Ehdr))
+    return false;
+  auto ehdr = reinterpret_cast<const Ehdr*>(image.data());
+  if (ehdr->e_shoff == 0
+   || ehdr->e_shoff + ehdr->e_shnum * sizeof(Shdr) > image.size())
+    return false;
+  auto shdrs = reinterpret_cast<const Shdr*>(image.data() + ehdr->e_shoff);
+  for (uint32_t i = 0; i < ehdr->e_shnum; ++i) {
+    auto& shdr = shdrs[i];
+    if (shdr.sh_type != SHT_SYMTAB || shdr.sh_link >= ehdr->e_shnum)
+      continue;
+    auto& strtab = shdrs[shdr.sh_link];
+    if (shdr.sh_offset + shdr.sh_size > image.size()
+     || strtab.sh_offset + strtab.sh_size > image.size())
+      return false;
+    auto syms = reinterpret_cast<const Sym*>(image.data() + shdr.sh_offset);
+    auto strs = image.data() + strtab.sh_offset;
+    for (uint64_t s = 0, n = shdr.sh_size / sizeof(Sym); s < n; ++s) {
+      auto& sym = syms[s];
+      uint32_t type = sym.st_info & 0xf;
+      if (type != STT_FUNC || sym.st_name >= strtab.sh_size)
+        continue;
+      symbols[sym.st_value] = {strs + sym.st_name, sym.st_size};
+    }
+  }
+  return true;
+}
+
+bool load_symbols(const std::string& path, SymbolTable& symbols) {
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs)
+    return false;
+  std::vector<char> image((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+  if (image.size() < EI_NIDENT || memcmp(image.data(), ELFMAG, SELFMAG) != 0)
+    return false;
+  if (image[EI_CLASS] == ELFCLASS64)
+    return read_symbols<Elf64_Ehdr, Elf64_Shdr, Elf64_Sym>(image, symbols);
+  return read_symbols<Elf32_Ehdr, Elf32_Shdr, Elf32_Sym>(image, symbols);
+}
+
+// returns the enclosing function, or nullptr
+const std::pair<const uint64_t, symbol_t>* lookup(const SymbolTable& symbols, uint64_t pc) {
+  auto it = symbols.upper_bound(pc);
+  if (it == symbols.begin())
+    return nullptr;
+  --it;
+  if (it->second.size != 0 && pc >= it->first + it->second.size)
+    return nullptr;
+  return &*it;
+}
+
+uint64_t total_cycles(const PcProfiler::pc_stats_t& stats) {
+  uint64_t cycles = stats.issues;
+  for (auto stall : stats.stalls) {
+    cycles += stall;
+  }
+  return cycles;
+}
+
+void accumulate(PcProfiler::pc_stats_t& dst, const PcProfiler::pc_stats_t& src) {
+  dst.issues += src.issues;
+  dst.threads += src.threads;
+  for (int i = 0; i < (int)PcStall::Count; ++i) {
+    dst.stalls[i] += src.stalls[i];
+  }
+  dst.dcache_misses += src.dcache_misses;
+  dst.mem_requests += src.mem_requests;
+  dst.mem_latency += src.mem_latency;
+  dst.divergences += src.divergences;
+}
+
+void print_row(std::ostream& os, const PcProfiler::pc_stats_t& stats) {
+  uint64_t avg_lat = stats.mem_requests ? (stats.mem_latency / stats.mem_requests) : 0;
+  os << std::setw(10) << stats.issues
+     << std::setw(10) << stats.threads
+     << std::setw(10) << stats.stalls[(int)PcStall::Mem]
+     << std::setw(10) << stats.stalls[(int)PcStall::Dep]
+     << std::setw(10) << stats.stalls[(int)PcStall::Sync]
+     << std::setw(10) << stats.stalls[(int)PcStall::IBuf]
+     << std::setw(10) << stats.dcache_misses
+     << std::setw(10) << avg_lat
+     << std::setw(10) << stats.divergences;
+}
+
+void print_header(std::ostream& os) {
+  os << std::setw(10) << "issues"
+     << std::setw(10) << "threads"
+     << std::setw(10) << "stl.mem"
+     << std::setw(10) << "stl.dep"
+     << std::setw(10) << "stl.sync"
+     << std::setw(10) << "stl.ibuf"
+     << std::setw(10) << "misses"
+     << std::setw(10) << "mem.lat"
+     << std::setw(10) << "diverge";
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+PcProfiler::PcProfiler()
+  : enabled_(false)
+  , elf_path_("kernel.elf")
+{
+  auto report_s = getenv("VORTEX_PC_PROFILE");
+  if (report_s && report_s[0] != '\0') {
+    enabled_ = true;
+    report_path_ = report_s;
+  }
+  auto elf_s = getenv("VORTEX_PC_PROFILE_ELF");
+  if (elf_s && elf_s[0] != '\0') {
+    elf_path_ = elf_s;
+  }
+}
+
+void PcProfiler::dump() const {
+  if (!enabled_)
+    return;
+
+  std::ofstream ofs(report_path_);
+  if (!ofs) {
+    std::cerr << "Error: cannot open PC profile " << report_path_ << std::endl;
+    return;
+  }
+
+  SymbolTable symbols;
+  if (!load_symbols(elf_path_, symbols)) {
+    std::cerr << "Warning: PC profile not symbolized, cannot read " << elf_path_ << std::endl;
+  }
+
+  // order by cycles spent at each PC
+  std::vector<std::pair<Word, const pc_stats_t*>> pcs;
+  pcs.reserve(pcs_.size());
+  for (auto& entry : pcs_) {
+    pcs.emplace_back(entry.first, &entry.second);
+  }
+  std::sort(pcs.begin(), pcs.end(), [](const auto& a, const auto& b) {
+    auto ca = total_cycles(*a.second);
+    auto cb = total_cycles(*b.second);
+    return (ca != cb) ? (ca > cb) : (a.first < b.first);
+  });
+
+  // per-function summary
+  std::map<std::string, pc_stats_t> funcs;
+  for (auto& pc : pcs) {
+    auto sym = lookup(symbols, pc.first);
+    accumulate(funcs[sym ? sym->second.name : "??"], *pc.second);
+  }
+  std::vector<std::pair<std::string, const pc_stats_t*>> func_list;
+  for (auto& func : funcs) {
+    func_list.emplace_back(func.first, &func.second);
+  }
+  std::sort(func_list.begin(), func_list.end(), [](const auto& a, const auto& b) {
+    return total_cycles(*a.second) > total_cycles(*b.second);
+  });
+
+  ofs << "# issues: warp instructions issued, threads: active threads issued" << std::endl;
+  ofs << "# stl.*: cycles the instruction waited at the ibuffer head (mem/dep/sync) or decode (ibuf)" << std::endl;
+  ofs << "# misses: L1 data cache misses, mem.lat: average load latency in cycles" << std::endl;
+  ofs << "# diverge: divergent splits" << std::endl;
+  ofs << std::endl;
+
+  ofs << std::left << std::setw(40) << "function" << std::right;
+  print_header(ofs);
+  ofs << std::endl;
+  for (auto& func : func_list) {
+    ofs << std::left << std::setw(40) << func.first << std::right;
+    print_row(ofs, *func.second);
+    ofs << std::endl;
+  }
+  ofs << std::endl;
+
+  ofs << std::left << std::setw(12) << "pc" << std::setw(28) << "location" << std::right;
+  print_header(ofs);
+  ofs << std::endl;
+  for (auto& pc : pcs) {
+    std::stringstream loc;
+    auto sym = lookup(symbols, pc.first);
+    if (sym) {
+      loc << sym->second.name << "+0x" << std::hex << (pc.first - sym->first);
+    } else {
+      loc << "??";
+    }
+    std::stringstream addr;
+    addr << "0x" << std::hex << pc.first;
+    ofs << std::left << std::setw(12) << addr.str() << std::setw(28) << loc.str() << std::right;
+    print_row(ofs, *pc.second);
+    ofs << std::endl;
+  }
+}
@@ -0,0 +1,106 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include "types.h"
+
+namespace vortex {
+
+enum class PcStall {
+  Mem,  // scoreboard wait on a load
+  Dep,  // scoreboard wait on an ALU/FPU/VPU/TCU result
+  Sync, // scoreboard wait on a CSR or warp-control result
+  IBuf, // decoded instruction blocked on a full ibuffer
+  Count
+};
+
+// Per-static-instruction profile shared by all cores.
+// Enabled by setting VORTEX_PC_PROFILE to the report path; the report is
+// symbolized with the kernel ELF given by VORTEX_PC_PROFILE_ELF
+// (default: kernel.elf in the working directory, if present).
+class PcProfiler {
+public:
+  struct pc_stats_t {
+    uint64_t issues;
+    uint64_t threads;
+    uint64_t stalls[(int)PcStall::Count];
+    uint64_t dcache_misses;
+    uint64_t mem_requests;
+    uint64_t mem_latency;
+    uint64_t divergences;
+
+    pc_stats_t()
+      : issues(0)
+      , threads(0)
+      , stalls{}
+      , dcache_misses(0)
+      , mem_requests(0)
+      , mem_latency(0)
+      , divergences(0)
+    {}
+  };
+
+  static PcProfiler& instance() {
+    static PcProfiler s_inst;
+    return s_inst;
+  }
+
+  bool enabled() const {
+    return enabled_;
+  }
+
+  void issue(Word pc, uint32_t threads) {
+    auto& stats = pcs_[pc];
+    ++stats.issues;
+    stats.threads += threads;
+  }
+
+  void stall(Word pc, PcStall reason) {
+    ++pcs_[pc].stalls[(int)reason];
+  }
+
+  void dcache_miss(Word pc) {
+    ++pcs_[pc].dcache_misses;
+  }
+
+  void mem_latency(Word pc, uint64_t cycles) {
+    auto& stats = pcs_[pc];
+    ++stats.mem_requests;
+    stats.mem_latency += cycles;
+  }
+
+  void divergence(Word pc) {
+    ++pcs_[pc].divergences;
+  }
+
+  void clear() {
+    pcs_.clear();
+  }
+
+  // write the symbolized report to the configured path
+  void dump() const;
+
+private:
+
+  PcProfiler();
+
+  bool enabled_;
+  std::string report_path_;
+  std::string elf_path_;
+  std::unordered_map<Word, pc_stats_t> pcs_;
+};
+
+}
@@ -29,7 +29,8 @@ ProcessorImpl::ProcessorImpl(const Arch& arch)
     PLATFORM_MEMORY_NUM_BANKS,
     L3_MEM_PORTS,
     MEM_BLOCK_SIZE,
-    MEM_CLOCK_RATIO
+    MEM_CLOCK_RATIO,
+    HashType(MEM_BANK_HASH)
   });
 
   // create clusters
@@ -42,6 +43,7 @@ ProcessorImpl::ProcessorImpl(const Arch& arch)
     !L3_ENABLED,
     log2ceil(L3_CACHE_SIZE),  // C
     log2ceil(MEM_BLOCK_SIZE), // L
+    log2ceil(L3_SECTOR_SIZE), // S
     log2ceil(L2_LINE_SIZE),   // W
     log2ceil(L3_NUM_WAYS),    // A
     log2ceil(L3_NUM_BANKS),   // B
@@ -52,6 +54,12 @@ ProcessorImpl::ProcessorImpl(const Arch& arch)
     false,                    // write response
     L3_MSHR_SIZE,             // mshr size
     2,                        // pipeline latency
+    L3_VICTIM_SIZE,           // victim buffer size
+    L3_INCLUSION,             // inclusion policy
+    L3_MSHR_TARGETS,          // mshr targets
+    L3_MSHR_SHARED,           // shared mshr
+    HashType(L3_BANK_HASH),   // bank hash
+    HashType(L3_SET_HASH),    // set hash
     }
   );
 
@@ -63,12 +71,36 @@ ProcessorImpl::ProcessorImpl(const Arch& arch)
     }
   }
 
+  // register upper caches for inclusion enforcement
+  if (L3_ENABLED) {
+    for (auto cluster : clusters_) {
+      cluster->bind_lower_cache(l3cache_.get());
+    }
+  }
+
+  // DMA writes enter below the L1 caches and through their own cluster's L2,
+  // snoop all other data caches that may hold a stale copy
+  for (auto cluster : clusters_) {
+    std::vector<SimPort<MemReq>*> snoop_ports;
+    for (auto other : clusters_) {
+      other->add_snoop_ports(snoop_ports, other != cluster);
+    }
+    cluster->attach_dma_snoops(snoop_ports);
+  }
+
   // connect L3 memory interfaces
   for (uint32_t i = 0; i < L3_MEM_PORTS; ++i) {
     l3cache_->MemReqPorts.at(i).bind(&memsim_->MemReqPorts.at(i));
     memsim_->MemRspPorts.at(i).bind(&l3cache_->MemRspPorts.at(i));
   }
 
+  // sample MSHR occupancy on the timeline
+  auto& timeline = Timeline::instance();
+  if (timeline.enabled()) {
+    auto l3cache = l3cache_.get();
+    timeline.add_counter("processor", "l3cache mshr", [l3cache]() { return l3cache->mshr_size(); });
+  }
+
   // set up memory profiling
   for (uint32_t i = 0; i < L3_MEM_PORTS; ++i) {
     memsim_->MemReqPorts.at(i).tx_callback([&](const MemReq& req, uint64_t cycle){
@@ -100,6 +132,7 @@ ProcessorImpl::ProcessorImpl(const Arch& arch)
 }
 
 ProcessorImpl::~ProcessorImpl() {
+  Timeline::instance().clear();
   SimPlatform::instance().finalize();
 }
 
@@ -124,6 +157,7 @@ int ProcessorImpl::run() {
   int exitcode = 0;
   do {
     SimPlatform::instance().tick();
+    Timeline::instance().tick();
     done = true;
     for (auto cluster : clusters_) {
       if (cluster->running()) {
@@ -135,9 +169,50 @@ int ProcessorImpl::run() {
     perf_mem_latency_ += perf_mem_pending_reads_;
   } while (!done);
 
+#ifdef PERF_ENABLE
+  this->dump_perf(std::cout);
+#endif
+
+  // cumulative across kernel launches
+  PcProfiler::instance().dump();
+  Timeline::instance().flush();
+  ITraceWriter::instance().flush();
+  MemTraceRecorder::instance().flush();
+
   return exitcode;
 }
 
+int ProcessorImpl::replay(const std::string& memtrace) {
+  MemTraceReplayer replayer(arch_.num_cores());
+  if (!replayer.load(memtrace))
+    return -1;
+
+  for (auto cluster : clusters_) {
+    cluster->attach_mem_replay(&replayer);
+  }
+  this->run();
+  for (auto cluster : clusters_) {
+    cluster->attach_mem_replay(nullptr);
+  }
+
+  auto& perf = replayer.perf_stats();
+  uint64_t cycles = SimPlatform::instance().cycles();
+  uint64_t read_latency = perf.reads ? (perf.read_latency / perf.reads) : 0;
+  std::cout << "PERF: replay requests=" << replayer.num_requests()
+            << ", reads=" << perf.reads
+            << ", writes=" << perf.writes
+            << ", cycles=" << cycles
+            << ", avg read latency=" << read_latency << " cycles" << std::endl;
+  std::cout << "PERF: replay dependency stalls=" << perf.dep_stalls
+            << ", queue stalls=" << perf.queue_stalls << std::endl;
+  if (perf.reads + perf.writes != replayer.num_requests()) {
+    std::cerr << "Error: replay issued " << (perf.reads + perf.writes)
+              << " of " << replayer.num_requests() << " requests" << std::endl;
+    return -1;
+  }
+  return 0;
+}
+
 void ProcessorImpl::reset() {
   perf_mem_reads_ = 0;
   perf_mem_writes_ = 0;
@@ -159,6 +234,153 @@ ProcessorImpl::PerfStats ProcessorImpl::perf_stats() const {
   return perf;
 }
 
+void ProcessorImpl::dump_perf(std::ostream& os) const {
+  auto perf = this->perf_stats();
+
+  CacheSim::PerfStats icache;
+  CacheSim::PerfStats dcache;
+  CacheSim::PerfStats l2cache;
+  LocalMem::PerfStats lmem;
+  OpcUnit::PerfStats opc;
+  Core::IssueStats issue;
+  Core::FetchStats fetch;
+  DmaEngine::PerfStats dma;
+#ifdef EXT_TCU_ENABLE
+  TensorUnit::PerfStats tcu;
+#endif
+  for (auto cluster : clusters_) {
+    auto cluster_perf = cluster->perf_stats();
+    icache  += cluster_perf.icache;
+    dcache  += cluster_perf.dcache;
+    l2cache += cluster_perf.l2cache;
+    lmem    += cluster_perf.lmem;
+    opc     += cluster_perf.opc;
+    issue   += cluster_perf.issue;
+    fetch   += cluster_perf.fetch;
+    dma     += cluster_perf.dma;
+  #ifdef EXT_TCU_ENABLE
+    tcu     += cluster_perf.tcu;
+  #endif
+  }
+
+  // sectored caches
+  os << "PERF: dcache sector misses=" << dcache.sector_misses << std::endl;
+  os << "PERF: l2cache sector misses=" << l2cache.sector_misses << std::endl;
+  os << "PERF: l3cache sector misses=" << perf.l3cache.sector_misses << std::endl;
+
+  // eviction flow
+  auto dump_evictions = [&](const char* name, const CacheSim::PerfStats& cache) {
+    os << "PERF: " << name << " evictions=" << cache.evictions
+       << ", victim hits=" << cache.victim_hits
+       << ", victim fills=" << cache.victim_fills
+       << ", back-invalidations=" << cache.back_invals
+       << ", exclusive fills=" << cache.excl_fills << std::endl;
+  };
+  auto dump_snoops = [&](const char* name, const CacheSim::PerfStats& cache) {
+    os << "PERF: " << name << " snoops=" << cache.snoops
+       << ", snoop invalidations=" << cache.snoop_invals << std::endl;
+  };
+  dump_evictions("icache", icache);
+  dump_evictions("dcache", dcache);
+  dump_evictions("l2cache", l2cache);
+  dump_evictions("l3cache", perf.l3cache);
+  dump_snoops("dcache", dcache);
+  dump_snoops("l2cache", l2cache);
+
+  // MSHR usage
+  auto dump_mshr = [&](const char* name, const CacheSim::PerfStats& cache) {
+    os << "PERF: " << name << " primary misses=" << cache.primary_misses
+       << ", secondary misses=" << cache.secondary_misses
+       << ", mshr stalls=" << cache.mshr_stalls
+       << ", target stalls=" << cache.mshr_target_stalls << std::endl;
+    os << "PERF: " << name << " mshr occupancy:";
+    for (size_t i = 0; i < cache.mshr_occupancy.size(); ++i) {
+      if (cache.mshr_occupancy.at(i) != 0) {
+        os << " " << i << "=" << cache.mshr_occupancy.at(i);
+      }
+    }
+    os << std::endl;
+  };
+  dump_mshr("dcache", dcache);
+  dump_mshr("l2cache", l2cache);
+  dump_mshr("l3cache", perf.l3cache);
+
+  // front-end
+  os << "PERF: fetch branches=" << fetch.branches
+     << ", mispredicts=" << fetch.mispredicts
+     << ", btb misses=" << fetch.btb_misses
+     << ", unpredicted=" << fetch.resolve_stalls
+     << ", queue stalls=" << fetch.queue_stalls
+     << ", branch stalls=" << fetch.branch_stalls << std::endl;
+  os << "PERF: fetch loop-buffer hits=" << fetch.lbuf_hits
+     << ", prefetches=" << fetch.prefetches
+     << ", useful prefetches=" << fetch.prefetch_hits << std::endl;
+
+  // multi-issue
+  os << "PERF: issue multi-issue=" << issue.multi_issues
+     << ", opportunities=" << issue.opportunities
+     << ", fu conflicts=" << issue.fu_conflicts
+     << ", dependency stalls=" << issue.dep_stalls << std::endl;
+
+  // operand collectors
+  os << "PERF: operands bank reads=" << opc.bank_reads
+     << ", rf cache hits=" << opc.rf_cache_hits
+     << ", collector stalls=" << opc.cu_stalls
+     << ", bank conflict stalls=" << opc.bank_stalls
+     << ", port conflict stalls=" << opc.port_stalls << std::endl;
+
+  // local memory banks
+  os << "PERF: lmem bank stalls=" << lmem.bank_stalls
+     << ", broadcasts=" << lmem.broadcasts << std::endl;
+  for (size_t w = 0; w < lmem.conflict_degree.size(); ++w) {
+    auto& histogram = lmem.conflict_degree.at(w);
+    if (histogram.empty())
+      continue;
+    os << "PERF: lmem warp" << w << " conflict degree:";
+    for (size_t d = 0; d < histogram.size(); ++d) {
+      if (histogram.at(d) != 0) {
+        os << " " << d << "=" << histogram.at(d);
+      }
+    }
+    os << std::endl;
+  }
+
+  // DMA engines
+  uint64_t dma_latency = dma.transfers ? (dma.total_latency / dma.transfers) : 0;
+  os << "PERF: dma transfers=" << dma.transfers
+     << ", bytes=" << dma.bytes_written
+     << ", avg latency=" << dma_latency << " cycles"
+     << ", mem reads=" << dma.mem_reads
+     << ", mem writes=" << dma.mem_writes
+     << ", pending stalls=" << dma.pending_stalls
+     << ", chains=" << dma.chains
+     << ", descriptor reads=" << dma.desc_reads
+     << ", multicasts=" << dma.mcast_transfers
+     << ", multicast bytes=" << dma.mcast_bytes << std::endl;
+
+#ifdef EXT_TCU_ENABLE
+  // tensor core units (utilization: issued uops per block-cycle)
+  uint64_t tcu_slots = tcu.cycles * ISSUE_WIDTH;
+  uint64_t tcu_util = tcu_slots ? (tcu.uops * 100 / tcu_slots) : 0;
+  uint64_t tcu_latency = tcu.uops ? (tcu.latency / tcu.uops) : 0;
+  os << "PERF: tcu uops=" << tcu.uops
+     << ", utilization=" << tcu_util << "%"
+     << ", avg latency=" << tcu_latency << " cycles"
+     << ", forwarded=" << tcu.fwd_uops
+     << ", sparse=" << tcu.sparse_uops
+     << ", ii stalls=" << tcu.ii_stalls
+     << ", rf stalls=" << tcu.rf_stalls << std::endl;
+#endif
+
+  // memory traffic (only sectored requests transfer partial blocks, so saved= is their savings)
+  uint64_t full_read_bytes = perf.memsim.reads * MEM_BLOCK_SIZE;
+  uint64_t full_write_bytes = perf.memsim.writes * MEM_BLOCK_SIZE;
+  os << "PERF: memory read bytes=" << perf.memsim.read_bytes
+     << " (saved=" << (full_read_bytes - perf.memsim.read_bytes) << ")" << std::endl;
+  os << "PERF: memory write bytes=" << perf.memsim.write_bytes
+     << " (saved=" << (full_write_bytes - perf.memsim.write_bytes) << ")" << std::endl;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 Processor::Processor(const Arch& arch)
@@ -192,6 +414,17 @@ int Processor::run() {
   return -1;
 }
 
+int Processor::replay(const char* memtrace) {
+  try {
+    return impl_->replay(memtrace);
+  } catch (const std::exception& e) {
+    std::cerr << "Error: exception: " << e.what() << std::endl;
+  } catch (...) {
+    std::cerr << "Error: unknown exception." << std::endl;
+  }
+  return -1;
+}
+
 void Processor::dcr_write(uint32_t addr, uint32_t value) {
   return impl_->dcr_write(addr, value);
 }
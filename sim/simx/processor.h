@@ -35,6 +35,9 @@ public:
 
   int run();
 
+  // replay a recorded memory trace (VORTEX_MEMTRACE) instead of running a program
+  int replay(const char* memtrace);
+
   void dcr_write(uint32_t addr, uint32_t value);
 #ifdef VM_ENABLE
   bool is_satp_unset();
@@ -38,6 +38,8 @@ public:
 
   int run();
 
+  int replay(const std::string& memtrace);
+
   void dcr_write(uint32_t addr, uint32_t value);
 
 #ifdef VM_ENABLE
@@ -46,6 +48,8 @@ public:
 
   PerfStats perf_stats() const;
 
+  void dump_perf(std::ostream& os) const;
+
 private:
 
   void reset();
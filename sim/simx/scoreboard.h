@@ -14,7 +14,7 @@
 #pragma once
 
 #include "instr_trace.h"
-#include <unordered_map>
+#include <algorithm>
 #include <vector>
 
 namespace vortex {
@@ -31,7 +31,8 @@ public:
 	};
 
 	Scoreboard(const Arch &arch)
-	: in_use_regs_(arch.num_warps()) {
+	: in_use_regs_(arch.num_warps())
+	, owners_(arch.num_warps() << RegOpd::ID_BITS, nullptr) {
 		for (auto& in_use_reg : in_use_regs_) {
 			in_use_reg.resize((int)RegType::Count);
 		}
@@ -44,7 +45,7 @@ public:
 				mask.reset();
 			}
 		}
-		owners_.clear();
+		std::fill(owners_.begin(), owners_.end(), nullptr);
 	}
 
 	bool in_use(instr_trace_t* trace) const {
@@ -64,34 +65,34 @@ public:
 		return false;
 	}
 
-	std::vector<reg_use_t> get_uses(instr_trace_t* trace) const {
-		std::vector<reg_use_t> out;
+	// visit the in-flight owners of the registers used by the instruction
+	template <typename F>
+	void for_each_use(instr_trace_t* trace, const F& visitor) const {
 		if (trace->wb) {
 			assert(trace->dst_reg.type != RegType::None);
 			if (in_use_regs_.at(trace->wid).at((int)trace->dst_reg.type).test(trace->dst_reg.idx)) {
-				uint32_t reg_id = get_reg_id(trace->dst_reg, trace->wid);
-				auto owner = owners_.at(reg_id);
-				out.push_back({trace->dst_reg.type, trace->dst_reg.idx, owner->fu_type, owner->op_type, owner->uuid});
+				auto owner = owners_.at(get_reg_id(trace->dst_reg, trace->wid));
+				assert(owner != nullptr);
+				visitor(reg_use_t{trace->dst_reg.type, trace->dst_reg.idx, owner->fu_type, owner->op_type, owner->uuid});
 			}
 		}
 		for (uint32_t i = 0; i < trace->src_regs.size(); ++i) {
 			if (trace->src_regs[i].type != RegType::None) {
 				if (in_use_regs_.at(trace->wid).at((int)trace->src_regs[i].type).test(trace->src_regs[i].idx)) {
-					uint32_t reg_id = get_reg_id(trace->src_regs[i], trace->wid);
-					auto owner = owners_.at(reg_id);
-					out.push_back({trace->src_regs[i].type, trace->src_regs[i].idx, owner->fu_type, owner->op_type, owner->uuid});
+					auto owner = owners_.at(get_reg_id(trace->src_regs[i], trace->wid));
+					assert(owner != nullptr);
+					visitor(reg_use_t{trace->src_regs[i].type, trace->src_regs[i].idx, owner->fu_type, owner->op_type, owner->uuid});
 				}
 			}
 		}
-		return out;
 	}
 
 	void reserve(instr_trace_t* trace) {
 		uint32_t reg_id = get_reg_id(trace->dst_reg, trace->wid);
 		assert(trace->wb);
 		in_use_regs_.at(trace->wid).at((int)trace->dst_reg.type).set(trace->dst_reg.idx);
-		assert(owners_.count(reg_id) == 0);
-		owners_[reg_id] = trace;
+		assert(owners_.at(reg_id) == nullptr);
+		owners_.at(reg_id) = trace;
 	}
 
 	void release(instr_trace_t* trace) {
@@ -99,8 +100,8 @@ public:
 		assert(trace->wb);
 		assert(in_use_regs_.at(trace->wid).at((int)trace->dst_reg.type).test(trace->dst_reg.idx));
 		in_use_regs_.at(trace->wid).at((int)trace->dst_reg.type).reset(trace->dst_reg.idx);
-		assert(owners_.count(reg_id) != 0);
-		owners_.erase(reg_id);
+		assert(owners_.at(reg_id) != nullptr);
+		owners_.at(reg_id) = nullptr;
 	}
 
 private:
@@ -110,7 +111,7 @@ private:
   }
 
 	std::vector<std::vector<RegMask>> in_use_regs_;
-	std::unordered_map<uint32_t, instr_trace_t*> owners_;
+	std::vector<instr_trace_t*> owners_; // indexed by warp and register id
 };
 
 }
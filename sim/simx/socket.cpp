@@ -36,6 +36,7 @@ Socket::Socket(const SimContext& ctx,
     !ICACHE_ENABLED,
     log2ceil(ICACHE_SIZE),  // C
     log2ceil(L1_LINE_SIZE), // L
+    log2ceil(L1_LINE_SIZE), // S
     log2ceil(sizeof(uint32_t)), // W
     log2ceil(ICACHE_NUM_WAYS),// A
     log2ceil(1),            // B
@@ -46,6 +47,12 @@ Socket::Socket(const SimContext& ctx,
     false,                  // write response
     ICACHE_MSHR_SIZE,       // mshr size
     2,                      // pipeline latency
+    ICACHE_VICTIM_SIZE,     // victim buffer size
+    CacheSim::NINE,         // inclusion policy
+    0,                      // mshr targets
+    false,                  // shared mshr
+    HashType::Linear,       // bank hash
+    HashType::Linear,       // set hash
   });
 
   snprintf(sname, 100, "%s-dcaches", this->name().c_str());
@@ -53,6 +60,7 @@ Socket::Socket(const SimContext& ctx,
     !DCACHE_ENABLED,
     log2ceil(DCACHE_SIZE),  // C
     log2ceil(L1_LINE_SIZE), // L
+    log2ceil(DCACHE_SECTOR_SIZE), // S
     log2ceil(DCACHE_WORD_SIZE), // W
     log2ceil(DCACHE_NUM_WAYS),// A
     log2ceil(DCACHE_NUM_BANKS), // B
@@ -63,11 +71,23 @@ Socket::Socket(const SimContext& ctx,
     false,                  // write response
     DCACHE_MSHR_SIZE,       // mshr size
     2,                      // pipeline latency
+    DCACHE_VICTIM_SIZE,     // victim buffer size
+    CacheSim::NINE,         // inclusion policy
+    DCACHE_MSHR_TARGETS,    // mshr targets
+    DCACHE_MSHR_SHARED,     // shared mshr
+    HashType(DCACHE_BANK_HASH), // bank hash
+    HashType(DCACHE_SET_HASH),  // set hash
   });
 
   // find overlap
   uint32_t overlap = MIN(ICACHE_MEM_PORTS, L1_MEM_PORTS);
 
+  // the cores' DMA engines share the first outgoing memory interface with the l1 caches
+  snprintf(sname, 100, "%s-dma_arb", this->name().c_str());
+  auto dma_arb = MemArbiter::Create(sname, ArbiterType::RoundRobin, 1 + cores_per_socket, 1);
+  dma_arb->ReqOut.at(0).bind(&this->mem_req_ports.at(0));
+  this->mem_rsp_ports.at(0).bind(&dma_arb->RspOut.at(0));
+
   // connect l1 caches to outgoing memory interfaces
   for (uint32_t i = 0; i < L1_MEM_PORTS; ++i) {
     snprintf(sname, 100, "%s-l1_arb%d", this->name().c_str(), i);
@@ -80,8 +100,13 @@ Socket::Socket(const SimContext& ctx,
       dcaches_->MemReqPorts.at(i).bind(&l1_arb->ReqIn.at(overlap + i));
       l1_arb->RspIn.at(overlap + i).bind(&dcaches_->MemRspPorts.at(i));
 
-      l1_arb->ReqOut.at(i).bind(&this->mem_req_ports.at(i));
-      this->mem_rsp_ports.at(i).bind(&l1_arb->RspOut.at(i));
+      if (i == 0) {
+        l1_arb->ReqOut.at(i).bind(&dma_arb->ReqIn.at(0));
+        dma_arb->RspIn.at(0).bind(&l1_arb->RspOut.at(i));
+      } else {
+        l1_arb->ReqOut.at(i).bind(&this->mem_req_ports.at(i));
+        this->mem_rsp_ports.at(i).bind(&l1_arb->RspOut.at(i));
+      }
     } else {
       if (L1_MEM_PORTS > ICACHE_MEM_PORTS) {
         // if more dcache ports
@@ -111,6 +136,27 @@ Socket::Socket(const SimContext& ctx,
       dcaches_->CoreRspPorts.at(i).at(j).bind(&cores_.at(i)->dcache_rsp_ports.at(j));
     }
   }
+
+  // connect DMA engines to global memory
+  for (uint32_t i = 0; i < cores_per_socket; ++i) {
+    auto dma_engine = cores_.at(i)->dma_engine();
+    dma_engine->MemReqPort.bind(&dma_arb->ReqIn.at(1 + i));
+    dma_arb->RspIn.at(1 + i).bind(&dma_engine->MemRspPort);
+  }
+
+  // notify data cache misses to the cores' warp schedulers
+  dcaches_->set_miss_handler([this](uint32_t cid, uint32_t wid, uint64_t addr) {
+    cores_.at(cid % cores_.size())->dcache_miss(wid, addr);
+  });
+
+  // sample MSHR occupancy on the timeline
+  auto& timeline = Timeline::instance();
+  if (timeline.enabled()) {
+    auto icaches = icaches_.get();
+    auto dcaches = dcaches_.get();
+    timeline.add_counter(this->name(), "icache mshr", [icaches]() { return icaches->mshr_size(); });
+    timeline.add_counter(this->name(), "dcache mshr", [dcaches]() { return dcaches->mshr_size(); });
+  }
 }
 
 Socket::~Socket() {
@@ -125,6 +171,11 @@ void Socket::tick() {
   // DMA engines are now per-core, tick handled in Core::tick()
 }
 
+void Socket::bind_lower_cache(CacheSim* cache) {
+  icaches_->bind_lower(cache);
+  dcaches_->bind_lower(cache);
+}
+
 void Socket::attach_ram(RAM* ram) {
   for (auto core : cores_) {
     core->attach_ram(ram);
@@ -132,6 +183,22 @@ void Socket::attach_ram(RAM* ram) {
   }
 }
 
+void Socket::attach_mem_replay(MemTraceReplayer* replayer) {
+  for (auto core : cores_) {
+    core->attach_mem_replay(replayer);
+  }
+}
+
+void Socket::add_snoop_ports(std::vector<SimPort<MemReq>*>& ports) const {
+  dcaches_->add_snoop_ports(ports);
+}
+
+void Socket::attach_dma_snoops(const std::vector<SimPort<MemReq>*>& ports) {
+  for (auto core : cores_) {
+    core->dma_engine()->attach_snoops(ports);
+  }
+}
+
 #ifdef VM_ENABLE
 void Socket::set_satp(uint64_t satp) {
   for (auto core : cores_) {
@@ -168,5 +235,15 @@ Socket::PerfStats Socket::perf_stats() const {
   PerfStats perf_stats;
   perf_stats.icache = icaches_->perf_stats();
   perf_stats.dcache = dcaches_->perf_stats();
+  for (auto& core : cores_) {
+    perf_stats.lmem += core->local_mem()->perf_stats();
+    perf_stats.opc += core->opc_perf_stats();
+    perf_stats.issue += core->issue_stats();
+    perf_stats.fetch += core->fetch_stats();
+    perf_stats.dma += core->dma_engine()->perf_stats();
+  #ifdef EXT_TCU_ENABLE
+    perf_stats.tcu += core->tensor_unit()->perf_stats();
+  #endif
+  }
   return perf_stats;
 }
\ No newline at end of file
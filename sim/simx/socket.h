@@ -30,6 +30,14 @@ public:
   struct PerfStats {
     CacheSim::PerfStats icache;
     CacheSim::PerfStats dcache;
+    LocalMem::PerfStats lmem;
+    OpcUnit::PerfStats opc;
+    Core::IssueStats issue;
+    Core::FetchStats fetch;
+    DmaEngine::PerfStats dma;
+  #ifdef EXT_TCU_ENABLE
+    TensorUnit::PerfStats tcu;
+  #endif
   };
 
   std::vector<SimPort<MemReq>> mem_req_ports;
@@ -51,12 +59,31 @@ public:
     return cluster_;
   }
 
+  uint32_t num_cores() const {
+    return cores_.size();
+  }
+
+  Core* core(uint32_t index) const {
+    return cores_.at(index).get();
+  }
+
   void reset();
 
   void tick();
 
+  // register this level's caches as uppers of the given cache
+  void bind_lower_cache(CacheSim* cache);
+
   void attach_ram(RAM* ram);
 
+  void attach_mem_replay(MemTraceReplayer* replayer);
+
+  // collect the snoop ports of this level's data caches
+  void add_snoop_ports(std::vector<SimPort<MemReq>*>& ports) const;
+
+  // caches to invalidate on the DMA engines' global writes
+  void attach_dma_snoops(const std::vector<SimPort<MemReq>*>& ports);
+
 #ifdef VM_ENABLE
   void set_satp(uint64_t satp);
 #endif
@@ -15,6 +15,11 @@
 #include "tensor_unit.h"
 #include "tensor_cfg.h"
 #include <rvfloats.h>
+#include <cmath>
+#include <cstring>
+#ifdef __F16C__
+#include <immintrin.h>
+#endif
 #include "core.h"
 
 using namespace vortex;
@@ -26,6 +31,25 @@ inline uint64_t nan_box(uint32_t value) {
   return value | 0xffffffff00000000;
 }
 
+// fp8 to fp32 conversions are exact
+inline uint32_t e4m3_to_f32(uint8_t x) {
+  uint32_t sign = uint32_t(x & 0x80) << 24;
+  uint32_t exp  = (x >> 3) & 0xf;
+  uint32_t man  = x & 0x7;
+  if (exp == 0xf && man == 0x7)
+    return 0x7fc00000;
+  if (exp == 0) {
+    // subnormal (or zero): man * 2^-9 is exact
+    return sign | bit_cast<uint32_t>(float(man) * 0x1p-9f);
+  }
+  return sign | ((exp + 120) << 23) | (man << 20);
+}
+
+// E5M2 is the upper half of an fp16
+inline uint32_t e5m2_to_f32(uint8_t x) {
+  return rv_htof_s(uint16_t(x) << 8, 0, nullptr);
+}
+
 template <typename It, typename Ot>
 struct FMA {
   using itype = typename It::dtype;
@@ -83,6 +107,30 @@ struct FMA<vt::bf16, vt::bf16> {
   }
 };
 
+template <>
+struct FMA<vt::fp8, vt::fp32> {
+  static float eval(uint8_t a, uint8_t b, float c) {
+    auto xa = e4m3_to_f32(a);
+    auto xb = e4m3_to_f32(b);
+    auto xab= rv_fmul_s(xa, xb, 0, nullptr);
+    auto xc = bit_cast<uint32_t>(c);
+    auto xd = rv_fadd_s(xab, xc, 0, nullptr);
+    return bit_cast<float>(xd);
+  }
+};
+
+template <>
+struct FMA<vt::bf8, vt::fp32> {
+  static float eval(uint8_t a, uint8_t b, float c) {
+    auto xa = e5m2_to_f32(a);
+    auto xb = e5m2_to_f32(b);
+    auto xab= rv_fmul_s(xa, xb, 0, nullptr);
+    auto xc = bit_cast<uint32_t>(c);
+    auto xd = rv_fadd_s(xab, xc, 0, nullptr);
+    return bit_cast<float>(xd);
+  }
+};
+
 template <typename It, typename Ot>
 struct FEDP {
   using itype = typename It::dtype;
@@ -152,6 +200,10 @@ static PFN_FEDP select_FEDP(uint32_t IT, uint32_t OT) {
       return FEDP<vt::fp16, vt::fp32>::eval;
     case vt::bf16::id:
       return FEDP<vt::bf16, vt::fp32>::eval;
+    case vt::fp8::id:
+      return FEDP<vt::fp8, vt::fp32>::eval;
+    case vt::bf8::id:
+      return FEDP<vt::bf8, vt::fp32>::eval;
     default:
       std::cout << "Error: unsupported mma format: " << IT << " -> " << OT << "!" << std::endl;
       std::abort();
@@ -196,15 +248,314 @@ static PFN_FEDP select_FEDP(uint32_t IT, uint32_t OT) {
   }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Host FEDP kernels
+//
+// A WMMA uop computes tcM x tcN independent dot products. These kernels run
+// them side by side (one array lane per output, so the compiler can vectorize
+// across outputs) on the host FPU instead of softfloat. Each dot product keeps
+// the reference evaluation order and per-product rounding, so results are
+// bit-exact: IEEE fp32 in round-to-nearest-even without contraction
+// (the Makefile builds with -ffp-contract=off), and NaNs are canonicalized
+// on output as the RISC-V softfloat specialization does.
+
+namespace host {
+
+inline float h2f(uint16_t h) {
+#ifdef __F16C__
+  return _cvtsh_ss(h);
+#else
+  uint32_t sign = uint32_t(h & 0x8000) << 16;
+  uint32_t exp  = (h >> 10) & 0x1f;
+  uint32_t man  = h & 0x3ff;
+  if (exp == 0x1f)
+    return bit_cast<float>(sign | 0x7f800000 | (man << 13));
+  if (exp == 0) {
+    // subnormal (or zero): man * 2^-24 is exact
+    float value = float(man) * 0x1p-24f;
+    return sign ? -value : value;
+  }
+  return bit_cast<float>(sign | ((exp + 112) << 23) | (man << 13));
+#endif
+}
+
+inline uint16_t f2h(float f) {
+#ifdef __F16C__
+  return _cvtss_sh(f, _MM_FROUND_TO_NEAREST_INT);
+#else
+  uint32_t u = bit_cast<uint32_t>(f);
+  uint16_t sign = (u >> 16) & 0x8000;
+  uint32_t a = u & 0x7fffffff;
+  if (a > 0x7f800000)
+    return sign | 0x7e00;
+  if (a >= 0x477ff000) // rounds to infinity
+    return sign | 0x7c00;
+  if (a < 0x38800000) {
+    // subnormal result: let the FPU round at the 2^-24 position
+    constexpr uint32_t magic = (127 - 15 + 23 - 10 + 1) << 23;
+    float x = bit_cast<float>(a) + bit_cast<float>(magic);
+    return sign | uint16_t(bit_cast<uint32_t>(x) - magic);
+  }
+  uint32_t odd = (a >> 13) & 1;
+  a += (uint32_t(15 - 127) << 23) + 0xfff + odd;
+  return sign | uint16_t(a >> 13);
+#endif
+}
+
+inline float b2f(uint16_t b) {
+  return bit_cast<float>(uint32_t(b) << 16);
+}
+
+inline uint16_t f2b(float f) {
+  uint32_t u = bit_cast<uint32_t>(f);
+  if ((u & 0x7fffffff) > 0x7f800000)
+    return 0x7fc0;
+  u += 0x7fff + ((u >> 16) & 1);
+  return uint16_t(u >> 16);
+}
+
+inline uint32_t canonical_f32(float f) {
+  return std::isnan(f) ? 0x7fc00000 : bit_cast<uint32_t>(f);
+}
+
+// element e of a packed register word
+template <uint32_t Bits>
+inline uint32_t element(uint32_t word, uint32_t e) {
+  return (word >> (e * Bits)) & ((1u << Bits) - 1);
+}
+
+// Per-format policies: compute type, unpacking, multiply-accumulate step,
+// accumulator load/store.
+template <typename It, typename Ot>
+struct policy;
+
+template <>
+struct policy<vt::fp16, vt::fp32> {
+  using ctype = float;
+  static constexpr uint32_t ratio = 2;
+  static float unpack(uint32_t w, uint32_t e) { return h2f(element<16>(w, e)); }
+  static float madd(float a, float b, float c) { float p = a * b; return p + c; }
+  static float load(uint32_t c) { return bit_cast<float>(c); }
+  static uint32_t store(float d) { return canonical_f32(d); }
+};
+
+template <>
+struct policy<vt::bf16, vt::fp32> {
+  using ctype = float;
+  static constexpr uint32_t ratio = 2;
+  static float unpack(uint32_t w, uint32_t e) { return b2f(element<16>(w, e)); }
+  static float madd(float a, float b, float c) { float p = a * b; return p + c; }
+  static float load(uint32_t c) { return bit_cast<float>(c); }
+  static uint32_t store(float d) { return canonical_f32(d); }
+};
+
+template <>
+struct policy<vt::fp8, vt::fp32> {
+  using ctype = float;
+  static constexpr uint32_t ratio = 4;
+  static float unpack(uint32_t w, uint32_t e) { return bit_cast<float>(e4m3_to_f32(element<8>(w, e))); }
+  static float madd(float a, float b, float c) { float p = a * b; return p + c; }
+  static float load(uint32_t c) { return bit_cast<float>(c); }
+  static uint32_t store(float d) { return canonical_f32(d); }
+};
+
+template <>
+struct policy<vt::bf8, vt::fp32> {
+  using ctype = float;
+  static constexpr uint32_t ratio = 4;
+  static float unpack(uint32_t w, uint32_t e) { return h2f(uint16_t(element<8>(w, e) << 8)); }
+  static float madd(float a, float b, float c) { float p = a * b; return p + c; }
+  static float load(uint32_t c) { return bit_cast<float>(c); }
+  static uint32_t store(float d) { return canonical_f32(d); }
+};
+
+// 16-bit accumulators are rounded back to their format after each product
+template <>
+struct policy<vt::fp16, vt::fp16> {
+  using ctype = float;
+  static constexpr uint32_t ratio = 2;
+  static float unpack(uint32_t w, uint32_t e) { return h2f(element<16>(w, e)); }
+  static float madd(float a, float b, float c) { return h2f(f2h(std::fma(a, b, c))); }
+  static float load(uint32_t c) { return h2f(uint16_t(c)); }
+  static uint32_t store(float d) { return std::isnan(d) ? 0x7e00 : f2h(d); }
+};
+
+template <>
+struct policy<vt::bf16, vt::bf16> {
+  using ctype = float;
+  static constexpr uint32_t ratio = 2;
+  static float unpack(uint32_t w, uint32_t e) { return b2f(element<16>(w, e)); }
+  static float madd(float a, float b, float c) { return b2f(f2b(std::fma(a, b, c))); }
+  static float load(uint32_t c) { return b2f(uint16_t(c)); }
+  static uint32_t store(float d) { return f2b(d); }
+};
+
+// integer accumulation wraps modulo 2^32
+template <uint32_t Bits, bool Signed>
+struct int_policy {
+  using ctype = uint32_t;
+  static constexpr uint32_t ratio = 32 / Bits;
+  static uint32_t unpack(uint32_t w, uint32_t e) {
+    uint32_t value = element<Bits>(w, e);
+    if (Signed && (value >> (Bits - 1))) {
+      value |= ~((1u << Bits) - 1);
+    }
+    return value;
+  }
+  static uint32_t madd(uint32_t a, uint32_t b, uint32_t c) { return a * b + c; }
+  static uint32_t load(uint32_t c) { return c; }
+  static uint32_t store(uint32_t d) { return d; }
+};
+
+template <> struct policy<vt::int8, vt::int32>  : int_policy<8, true> {};
+template <> struct policy<vt::uint8, vt::int32> : int_policy<8, false> {};
+template <> struct policy<vt::int4, vt::int32>  : int_policy<4, true> {};
+template <> struct policy<vt::uint4, vt::int32> : int_policy<4, false> {};
+
+// all dot products of a uop: a rows and b columns are tcK words apart,
+// c and d are indexed by output (i * tcN + j)
+template <typename It, typename Ot>
+void fedp_uop(const reg_data_t* a, const reg_data_t* b, const reg_data_t* c, reg_data_t* d) {
+  using P = policy<It, Ot>;
+  using ctype = typename P::ctype;
+  constexpr uint32_t NO = cfg::tcM * cfg::tcN;
+  ctype acc[NO];
+  for (uint32_t o = 0; o < NO; ++o) {
+    acc[o] = P::load(c[o].u32);
+  }
+  for (uint32_t z = 0; z < cfg::tcK; ++z) {
+    for (uint32_t e = 0; e < P::ratio; ++e) {
+      ctype xa[cfg::tcM], xb[cfg::tcN];
+      for (uint32_t i = 0; i < cfg::tcM; ++i) {
+        xa[i] = P::unpack(a[i * cfg::tcK + z].u32, e);
+      }
+      for (uint32_t j = 0; j < cfg::tcN; ++j) {
+        xb[j] = P::unpack(b[j * cfg::tcK + z].u32, e);
+      }
+      for (uint32_t o = 0; o < NO; ++o) {
+        acc[o] = P::madd(xa[o / cfg::tcN], xb[o % cfg::tcN], acc[o]);
+      }
+    }
+  }
+  for (uint32_t o = 0; o < NO; ++o) {
+    d[o].u64 = nan_box(P::store(acc[o]));
+  }
+}
+
+} // namespace host
+
+using PFN_FEDP_UOP = void (*)(const reg_data_t*, const reg_data_t*, const reg_data_t*, reg_data_t*);
+
+static PFN_FEDP_UOP select_host_FEDP(uint32_t IT, uint32_t OT) {
+  switch (OT) {
+  case vt::fp32::id:
+    switch (IT) {
+    case vt::fp16::id: return host::fedp_uop<vt::fp16, vt::fp32>;
+    case vt::bf16::id: return host::fedp_uop<vt::bf16, vt::fp32>;
+    case vt::fp8::id:  return host::fedp_uop<vt::fp8, vt::fp32>;
+    case vt::bf8::id:  return host::fedp_uop<vt::bf8, vt::fp32>;
+    default: break;
+    }
+    break;
+  case vt::fp16::id:
+    if (IT == vt::fp16::id)
+      return host::fedp_uop<vt::fp16, vt::fp16>;
+    break;
+  case vt::bf16::id:
+    if (IT == vt::bf16::id)
+      return host::fedp_uop<vt::bf16, vt::bf16>;
+    break;
+  case vt::int32::id:
+    switch (IT) {
+    case vt::int8::id:  return host::fedp_uop<vt::int8, vt::int32>;
+    case vt::uint8::id: return host::fedp_uop<vt::uint8, vt::int32>;
+    case vt::int4::id:  return host::fedp_uop<vt::int4, vt::int32>;
+    case vt::uint4::id: return host::fedp_uop<vt::uint4, vt::int32>;
+    default: break;
+    }
+    break;
+  default:
+    break;
+  }
+  return nullptr;
+}
+
+// bits of an output format written to the register
+static uint32_t output_mask(uint32_t OT) {
+  switch (OT) {
+  case vt::fp16::id:
+  case vt::bf16::id:
+    return 0xffff;
+  default:
+    return 0xffffffff;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// FEDP pipeline timing of an input format:
+// multiply stage, adder tree over the products of a dot product, then the
+// accumulate stage that adds C (RTL: VX_tcu_fp.sv / VX_tcu_int.sv).
+// A 2:4 sparse uop covers two K steps but only multiplies the kept half of
+// A, so it uses the same tree as a dense uop.
+struct fedp_timing_t {
+  uint32_t latency;   // issue to result
+  uint32_t acc_delay; // accumulate stage to result
+  uint32_t ii;        // initiation interval
+};
+
+static fedp_timing_t fedp_timing(uint32_t fmt_s) {
+  uint32_t bits, ii;
+  bool is_float;
+  switch (fmt_s) {
+  case vt::fp16::id:  bits = vt::fp16::bits; ii = TCU_FP16_II; is_float = true; break;
+  case vt::bf16::id:  bits = vt::bf16::bits; ii = TCU_BF16_II; is_float = true; break;
+  case vt::fp8::id:   bits = vt::fp8::bits;  ii = TCU_FP8_II;  is_float = true; break;
+  case vt::bf8::id:   bits = vt::bf8::bits;  ii = TCU_FP8_II;  is_float = true; break;
+  case vt::int8::id:  bits = vt::int8::bits; ii = TCU_INT8_II; is_float = false; break;
+  case vt::uint8::id: bits = vt::uint8::bits; ii = TCU_INT8_II; is_float = false; break;
+  case vt::int4::id:  bits = vt::int4::bits; ii = TCU_INT4_II; is_float = false; break;
+  case vt::uint4::id: bits = vt::uint4::bits; ii = TCU_INT4_II; is_float = false; break;
+  default:
+    std::cout << "Error: unsupported mma format: " << fmt_s << "!" << std::endl;
+    std::abort();
+  }
+  uint32_t products = (32 / bits) * cfg::tcK;
+  fedp_timing_t timing;
+  if (is_float) {
+    // the accumulator joins the tree as one more input
+    uint32_t levels = log2ceil(products + 1);
+    timing.acc_delay = TCU_FADD_LATENCY + 1;
+    timing.latency = TCU_FMUL_LATENCY + 1 + levels * TCU_FADD_LATENCY + 1;
+  } else {
+    uint32_t levels = log2ceil(products);
+    timing.acc_delay = TCU_IADD_LATENCY + 1;
+    timing.latency = TCU_IMUL_LATENCY + levels * TCU_IADD_LATENCY + TCU_IADD_LATENCY + 1;
+  }
+  timing.ii = std::max<uint32_t>(ii, 1);
+  return timing;
+}
+
 class TensorUnit::Impl {
 public:
   Impl(TensorUnit* simobject, const Arch& arch, Core* core)
     : simobject_(simobject)
     , core_(core)
     , arch_(arch)
+    , blocks_(ISSUE_WIDTH)
+    , fedp_mode_(FedpMode::Host)
     , perf_stats_()
   {
-    //--
+    // VORTEX_TCU_FEDP=softfloat selects the reference kernels,
+    // VORTEX_TCU_FEDP=check runs both and aborts on any mismatch
+    auto mode_s = getenv("VORTEX_TCU_FEDP");
+    if (mode_s != nullptr) {
+      if (strcmp(mode_s, "softfloat") == 0) {
+        fedp_mode_ = FedpMode::Softfloat;
+      } else if (strcmp(mode_s, "check") == 0) {
+        fedp_mode_ = FedpMode::Check;
+      }
+    }
   }
 
   ~Impl() {
@@ -212,26 +563,63 @@ public:
   }
 
   void reset() {
+    for (auto& block : blocks_) {
+      block = block_t();
+    }
     perf_stats_ = PerfStats();
   }
 
   void tick() {
+    auto cycle = SimPlatform::instance().cycles();
+    ++perf_stats_.cycles;
     for (uint32_t iw = 0; iw < ISSUE_WIDTH; ++iw) {
       auto& input = simobject_->Inputs.at(iw);
       if (input.empty())
         continue;
+      auto& block = blocks_.at(iw);
+      if (cycle < block.next_issue) {
+        if (block.rf_bound) {
+          ++perf_stats_.rf_stalls;
+        } else {
+          ++perf_stats_.ii_stalls;
+        }
+        continue;
+      }
       auto trace = input.front();
       auto tcu_type = std::get<TcuType>(trace->op_type);
-      int delay = 0;
+      uint32_t delay = 0;
       switch (tcu_type) {
       case TcuType::WMMA:
-        delay = 4;
-        break;
+      case TcuType::WMMA_SP: {
+        auto trace_data = std::dynamic_pointer_cast<ExeTraceData>(trace->data);
+        assert(trace_data);
+        auto timing = fedp_timing(trace_data->fmt_s);
+        // with forwarding, K steps after the first take C from the accumulate stage
+        // and their partial sum is only consumed there by the next K step
+        // (a sparse uop covers a K pair and reads two B registers, its metadata
+        // comes from the integer register file)
+        uint32_t k_uops = trace_data->sparse ? (cfg::k_steps / 2) : cfg::k_steps;
+        bool fwd_in  = TCU_ACC_FWD && trace_data->step_k != 0;
+        bool fwd_out = TCU_ACC_FWD && (trace_data->step_k + 1) < k_uops;
+        uint32_t rf_reads = (trace_data->sparse ? 3 : 2) + (fwd_in ? 0 : 1);
+        uint32_t rf_cycles = (rf_reads + TCU_RF_PORTS - 1) / TCU_RF_PORTS;
+        block.rf_bound = (rf_cycles > timing.ii);
+        block.next_issue = cycle + std::max(timing.ii, rf_cycles);
+        delay = fwd_out ? timing.acc_delay : timing.latency;
+        perf_stats_.latency += delay;
+        ++perf_stats_.uops;
+        if (fwd_in) {
+          ++perf_stats_.fwd_uops;
+        }
+        if (trace_data->sparse) {
+          ++perf_stats_.sparse_uops;
+        }
+      } break;
       default:
         std::abort();
       }
       simobject_->Outputs.at(iw).push(trace, 2 + delay);
-      DT(3, simobject_->name() << ": op=" << tcu_type << ", " << *trace);
+      DT(3, simobject_->name() << ": op=" << tcu_type << ", delay=" << delay << ", " << *trace);
       input.pop();
     }
   }
@@ -246,22 +634,78 @@ public:
             const std::vector<reg_data_t>& rs3_data,
             std::vector<reg_data_t>& rd_data,
             ExeTraceData* trace_data) {
-    __unused(wid);
     __unused(trace_data);
+    auto a_tile = rs1_data.data() + (step_m % cfg::a_sub_blocks) * cfg::a_block_size;
+    this->mma_tile(wid, fmt_s, fmt_d, step_m, step_n, a_tile, rs2_data, rs3_data, rd_data);
+  }
+
+  void wmma_sp(uint32_t wid,
+               uint32_t fmt_s,
+               uint32_t fmt_d,
+               uint32_t step_m,
+               uint32_t step_n,
+               uint32_t step_k,
+               const std::vector<reg_data_t>& rs1_data,
+               const std::vector<reg_data_t>& rs2_data,
+               const std::vector<reg_data_t>& rs3_data,
+               const std::vector<reg_data_t>& rs4_data,
+               const std::vector<reg_data_t>& rs5_data,
+               std::vector<reg_data_t>& rd_data,
+               ExeTraceData* trace_data) {
+    __unused(trace_data);
+    // expand the K pair, then accumulate its two K steps in order,
+    // matching the dense uops on the pruned matrix bit for bit
+    this->decompress_a(fmt_s, step_m, step_k, rs1_data, rs4_data);
+    acc_.resize(rd_data.size());
+    this->mma_tile(wid, fmt_s, fmt_d, step_m, step_n, a_dense_.data(), rs2_data, rs5_data, acc_);
+    this->mma_tile(wid, fmt_s, fmt_d, step_m, step_n, a_dense_.data() + cfg::tcM * cfg::tcK, rs3_data, acc_, rd_data);
+  }
+
+  const PerfStats& perf_stats() const {
+    return perf_stats_;
+  }
 
-    auto fedp = select_FEDP(fmt_s, fmt_d);
+private:
 
-    uint32_t a_off = (step_m % cfg::a_sub_blocks) * cfg::a_block_size;
+  void mma_tile(uint32_t wid,
+                uint32_t fmt_s,
+                uint32_t fmt_d,
+                uint32_t step_m,
+                uint32_t step_n,
+                const reg_data_t* a_tile,
+                const std::vector<reg_data_t>& b_data,
+                const std::vector<reg_data_t>& c_data,
+                std::vector<reg_data_t>& rd_data) {
+    __unused(wid);
     uint32_t b_off = (step_n % cfg::b_sub_blocks) * cfg::b_block_size;
 
+    auto host_fedp = (fedp_mode_ != FedpMode::Softfloat) ? select_host_FEDP(fmt_s, fmt_d) : nullptr;
+    if (host_fedp) {
+      host_fedp(a_tile, b_data.data() + b_off, c_data.data(), rd_data.data());
+    }
+    bool reference = (host_fedp == nullptr || fedp_mode_ == FedpMode::Check);
+    auto fedp = reference ? select_FEDP(fmt_s, fmt_d) : nullptr;
+
     for (uint32_t i = 0; i < cfg::tcM; ++i) {
       for (uint32_t j = 0; j < cfg::tcN; ++j) {
-        auto a_row = rs1_data.data() + a_off + i * cfg::tcK;
-        auto b_col = rs2_data.data() + b_off + j * cfg::tcK;
-        auto c_val = rs3_data.at(i * cfg::tcN + j).u32;
-        auto d_val = fedp(a_row, b_col, c_val);
-        rd_data.at(i * cfg::tcN + j).u64 = nan_box(d_val);
-
+        auto a_row = a_tile + i * cfg::tcK;
+        auto b_col = b_data.data() + b_off + j * cfg::tcK;
+        auto c_val = c_data.at(i * cfg::tcN + j).u32;
+        auto& d_reg = rd_data.at(i * cfg::tcN + j);
+        if (fedp) {
+          auto d_val = fedp(a_row, b_col, c_val);
+          if (host_fedp) {
+            auto mask = output_mask(fmt_d);
+            if ((d_reg.u32 & mask) != (d_val & mask)) {
+              std::cout << "Error: host FEDP mismatch: fmt=" << vt::fmt_string(fmt_s) << "->" << vt::fmt_string(fmt_d)
+                        << ", i=" << i << ", j=" << j << std::hex << ", expected=0x" << (d_val & mask)
+                        << ", actual=0x" << (d_reg.u32 & mask) << std::dec << std::endl;
+              std::abort();
+            }
+          } else {
+            d_reg.u64 = nan_box(d_val);
+          }
+        }
         DTH(3, "FEDP: wid=" << wid << ", i=" << i << ", j=" << j << ", m=" << step_m << ", n=" << step_n << ", a_row={" << std::hex);
         for (uint32_t q = 0; q < cfg::tcK; ++q) {
           if (q) DTN(3, ", ");
@@ -272,20 +716,70 @@ public:
           if (q) DTN(3, ", ");
           DTN(3, "0x" << b_col[q].u32);
         }
-        DTN(3, "}, c_val=0x" << c_val << ", d_val=0x" << d_val << std::dec << std::endl);
+        DTN(3, "}, c_val=0x" << c_val << ", d_val=0x" << d_reg.u32 << std::dec << std::endl);
       }
     }
   }
 
-  const PerfStats& perf_stats() const {
-    return perf_stats_;
+  // Expands the 2:4 sparse A of row block step_m and K pair step_k into
+  // a_dense_, as the dense micro-tiles of K steps 2*step_k and 2*step_k+1.
+  // The values register is laid out like a dense A register, each row holding
+  // the kept elements of its K pair. The metadata register holds one nibble per
+  // group of 4 dense elements (idx0 in bits [1:0], idx1 in bits [3:2]), 8 per
+  // lane, ordered by value register, row, then group.
+  void decompress_a(uint32_t fmt_s,
+                    uint32_t step_m,
+                    uint32_t step_k,
+                    const std::vector<reg_data_t>& rs1_data,
+                    const std::vector<reg_data_t>& rs4_data) {
+    uint32_t bits = vt::fmt_bits(fmt_s);
+    uint32_t ratio = 32 / bits;
+    uint32_t mask = (bits < 32) ? ((1u << bits) - 1) : ~0u;
+    if ((cfg::k_steps % 2) != 0 || ((2 * cfg::tcK * ratio) % 4) != 0) {
+      std::cout << "Error: sparse mma requires K steps in pairs of whole groups!" << std::endl;
+      std::abort();
+    }
+    uint32_t groups = (2 * cfg::tcK * ratio) / 4;
+    uint32_t m_groups = cfg::a_sub_blocks * cfg::tcM * groups;
+    uint32_t sb = step_m % cfg::a_sub_blocks;
+    uint32_t r = (step_m / cfg::a_sub_blocks) * (cfg::k_steps / 2) + step_k;
+    auto values = rs1_data.data() + sb * cfg::a_block_size;
+    a_dense_.fill(reg_data_t{});
+    for (uint32_t i = 0; i < cfg::tcM; ++i) {
+      for (uint32_t g = 0; g < groups; ++g) {
+        uint32_t q = r * m_groups + (sb * cfg::tcM + i) * groups + g;
+        uint32_t meta = (rs4_data.at(q / 8).u32 >> ((q % 8) * 4)) & 0xf;
+        for (uint32_t s = 0; s < 2; ++s) {
+          uint32_t v = 2 * g + s;
+          uint32_t value = (values[i * cfg::tcK + v / ratio].u32 >> ((v % ratio) * bits)) & mask;
+          uint32_t d = 4 * g + ((meta >> (2 * s)) & 0x3);
+          uint32_t w = d / ratio;
+          auto& a_word = a_dense_[(w / cfg::tcK) * cfg::tcM * cfg::tcK + i * cfg::tcK + (w % cfg::tcK)];
+          a_word.u32 |= value << ((d % ratio) * bits);
+        }
+      }
+    }
   }
 
-private:
+  struct block_t {
+    uint64_t next_issue;
+    bool     rf_bound;
+    block_t() : next_issue(0), rf_bound(false) {}
+  };
 
   TensorUnit*   simobject_;
   Core*         core_;
   Arch          arch_;
+  enum class FedpMode {
+    Host,
+    Softfloat,
+    Check
+  };
+
+  std::vector<block_t> blocks_;
+  std::array<reg_data_t, 2 * cfg::tcM * cfg::tcK> a_dense_;
+  std::vector<reg_data_t> acc_;
+  FedpMode      fedp_mode_;
   PerfStats     perf_stats_;
 };
 
@@ -294,7 +788,8 @@ private:
 op_string_t vortex::op_string(TcuType tcu_type, IntrTcuArgs args) {
   switch (tcu_type) {
   case TcuType::WMMA:
-    return {"WMMA." + std::string(vt::fmt_string(args.fmt_s)) + "." + std::string(vt::fmt_string(args.fmt_d))
+  case TcuType::WMMA_SP:
+    return {(tcu_type == TcuType::WMMA_SP ? "WMMA_SP." : "WMMA.") + std::string(vt::fmt_string(args.fmt_s)) + "." + std::string(vt::fmt_string(args.fmt_d))
              + "." + std::to_string(args.step_m) + "." + std::to_string(args.step_n), ""};
   default:
     std::abort();
@@ -337,4 +832,20 @@ void TensorUnit::wmma(uint32_t wid,
                       std::vector<reg_data_t>& rd_data,
                       ExeTraceData* trace_data) {
   impl_->wmma(wid, fmt_s, fmt_d, step_m, step_n, rs1_data, rs2_data, rs3_data, rd_data, trace_data);
-}
\ No newline at end of file
+}
+
+void TensorUnit::wmma_sp(uint32_t wid,
+                         uint32_t fmt_s,
+                         uint32_t fmt_d,
+                         uint32_t step_m,
+                         uint32_t step_n,
+                         uint32_t step_k,
+                         const std::vector<reg_data_t>& rs1_data,
+                         const std::vector<reg_data_t>& rs2_data,
+                         const std::vector<reg_data_t>& rs3_data,
+                         const std::vector<reg_data_t>& rs4_data,
+                         const std::vector<reg_data_t>& rs5_data,
+                         std::vector<reg_data_t>& rd_data,
+                         ExeTraceData* trace_data) {
+  impl_->wmma_sp(wid, fmt_s, fmt_d, step_m, step_n, step_k, rs1_data, rs2_data, rs3_data, rs4_data, rs5_data, rd_data, trace_data);
+}
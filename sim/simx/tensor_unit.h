@@ -27,17 +27,39 @@ public:
 
   struct ExeTraceData : public ITraceData {
     using Ptr = std::shared_ptr<ExeTraceData>;
+    uint32_t fmt_s;
+    uint32_t fmt_d;
+    uint32_t step_k;
+    bool     sparse;
   };
 
 	struct PerfStats {
 		uint64_t latency;
+		uint64_t cycles;
+		uint64_t uops;
+		uint64_t fwd_uops;
+		uint64_t sparse_uops;
+		uint64_t ii_stalls;
+		uint64_t rf_stalls;
 
 		PerfStats()
 			: latency(0)
+			, cycles(0)
+			, uops(0)
+			, fwd_uops(0)
+			, sparse_uops(0)
+			, ii_stalls(0)
+			, rf_stalls(0)
 		{}
 
 		PerfStats& operator+=(const PerfStats& rhs) {
-			this->latency += rhs.latency;
+			this->latency   += rhs.latency;
+			this->cycles    += rhs.cycles;
+			this->uops      += rhs.uops;
+			this->fwd_uops  += rhs.fwd_uops;
+			this->sparse_uops += rhs.sparse_uops;
+			this->ii_stalls += rhs.ii_stalls;
+			this->rf_stalls += rhs.rf_stalls;
 			return *this;
 		}
 	};
@@ -63,6 +85,22 @@ public:
 					  std::vector<reg_data_t>& rd_data,
 					  ExeTraceData* trace_data);
 
+	// 2:4 sparse A: rs1 holds the A values of a K pair, rs2/rs3 the B
+	// micro-tiles of its two K steps, rs4 the metadata and rs5 the accumulator
+	void wmma_sp(uint32_t wid,
+	             uint32_t fmt_s,
+	             uint32_t fmt_d,
+	             uint32_t step_m,
+	             uint32_t step_n,
+	             uint32_t step_k,
+	             const std::vector<reg_data_t>& rs1_data,
+	             const std::vector<reg_data_t>& rs2_data,
+	             const std::vector<reg_data_t>& rs3_data,
+	             const std::vector<reg_data_t>& rs4_data,
+	             const std::vector<reg_data_t>& rs5_data,
+	             std::vector<reg_data_t>& rd_data,
+	             ExeTraceData* trace_data);
+
 	const PerfStats& perf_stats() const;
 
 private:
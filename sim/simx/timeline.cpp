@@ -0,0 +1,146 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <limits>
+#include <stdlib.h>
+#include "timeline.h"
+
+using namespace vortex;
+
+static uint64_t env_u64(const char* name, uint64_t default_value) {
+  auto value_s = getenv(name);
+  if (value_s == nullptr || value_s[0] == '\0')
+    return default_value;
+  return strtoull(value_s, nullptr, 0);
+}
+
+Timeline::Timeline()
+  : enabled_(false)
+  , start_(0)
+  , end_(std::numeric_limits<uint64_t>::max())
+  , period_(16)
+  , base_(0)
+  , first_event_(true)
+{
+  auto path_s = getenv("VORTEX_TIMELINE");
+  if (path_s == nullptr || path_s[0] == '\0')
+    return;
+  ofs_.open(path_s);
+  if (!ofs_) {
+    std::cerr << "Error: cannot open timeline " << path_s << std::endl;
+    return;
+  }
+  start_  = env_u64("VORTEX_TIMELINE_START", start_);
+  end_    = env_u64("VORTEX_TIMELINE_END", end_);
+  period_ = std::max<uint64_t>(env_u64("VORTEX_TIMELINE_PERIOD", period_), 1);
+  enabled_ = true;
+  ofs_ << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+}
+
+Timeline::~Timeline() {
+  if (!enabled_)
+    return;
+  ofs_ << "\n]}\n";
+}
+
+uint32_t Timeline::get_pid(const std::string& group) {
+  auto it = pids_.find(group);
+  if (it != pids_.end())
+    return it->second;
+  uint32_t pid = pids_.size();
+  pids_[group] = pid;
+  num_tids_.push_back(0);
+  ofs_ << (first_event_ ? "\n" : ",\n");
+  ofs_ << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+       << ",\"args\":{\"name\":\"" << group << "\"}}";
+  ofs_ << ",\n{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":" << pid
+       << ",\"args\":{\"sort_index\":" << pid << "}}";
+  first_event_ = false;
+  return pid;
+}
+
+uint32_t Timeline::add_track(const std::string& group, const std::string& name) {
+  if (!enabled_)
+    return 0;
+  auto pid = this->get_pid(group);
+  uint32_t tid = num_tids_.at(pid)++;
+  ofs_ << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << tid
+       << ",\"args\":{\"name\":\"" << name << "\"}}";
+  ofs_ << ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << tid
+       << ",\"args\":{\"sort_index\":" << tid << "}}";
+  tracks_.push_back({pid, tid, nullptr, 0});
+  return tracks_.size() - 1;
+}
+
+void Timeline::add_counter(const std::string& group, const std::string& name, const Probe& probe) {
+  if (!enabled_)
+    return;
+  auto pid = this->get_pid(group);
+  counters_.push_back({pid, name, probe, std::numeric_limits<uint64_t>::max()});
+}
+
+void Timeline::clear() {
+  tracks_.clear();
+  counters_.clear();
+  std::fill(num_tids_.begin(), num_tids_.end(), 0);
+}
+
+void Timeline::change_state(track_t& track, const char* state) {
+  auto cycle = SimPlatform::instance().cycles();
+  if (track.state) {
+    this->emit_slice(track.pid, track.tid, track.state, base_ + track.start, base_ + cycle);
+  }
+  track.state = state;
+  track.start = cycle;
+}
+
+void Timeline::slice(uint32_t track, const std::string& name, uint64_t start, uint64_t end) {
+  auto& t = tracks_.at(track);
+  this->emit_slice(t.pid, t.tid, name.c_str(), base_ + start, base_ + end);
+}
+
+void Timeline::emit_slice(uint32_t pid, uint32_t tid, const char* name, uint64_t start, uint64_t end) {
+  // clip to the recording window
+  start = std::max(start, start_);
+  end = std::min(end, end_);
+  if (start >= end)
+    return;
+  ofs_ << ",\n{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << tid
+       << ",\"ts\":" << start << ",\"dur\":" << (end - start) << "}";
+}
+
+void Timeline::sample(uint64_t cycle) {
+  for (auto& counter : counters_) {
+    auto value = counter.probe();
+    if (value == counter.value)
+      continue;
+    counter.value = value;
+    ofs_ << ",\n{\"name\":\"" << counter.name << "\",\"ph\":\"C\",\"pid\":" << counter.pid
+         << ",\"ts\":" << (base_ + cycle) << ",\"args\":{\"value\":" << value << "}}";
+  }
+}
+
+void Timeline::flush() {
+  if (!enabled_)
+    return;
+  auto cycle = SimPlatform::instance().cycles();
+  for (auto& track : tracks_) {
+    this->change_state(track, nullptr);
+  }
+  for (auto& counter : counters_) {
+    counter.value = std::numeric_limits<uint64_t>::max();
+  }
+  base_ += cycle;
+  ofs_.flush();
+}
@@ -0,0 +1,123 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <functional>
+#include <unordered_map>
+#include <simobject.h>
+
+namespace vortex {
+
+// Chrome trace-event / Perfetto timeline of the simulation.
+// Enabled by setting VORTEX_TIMELINE to the output .json path.
+//   VORTEX_TIMELINE_START/END: cycle window to record (default: whole run)
+//   VORTEX_TIMELINE_PERIOD: counter sampling period in cycles (default: 16)
+// Timestamps are in cycles; consecutive runs are appended back to back.
+class Timeline {
+public:
+  typedef std::function<uint64_t()> Probe;
+
+  static Timeline& instance() {
+    static Timeline s_inst;
+    return s_inst;
+  }
+
+  ~Timeline();
+
+  bool enabled() const {
+    return enabled_;
+  }
+
+  // create a named track (thread) under a named group (process)
+  uint32_t add_track(const std::string& group, const std::string& name);
+
+  // switch a track to a new state, closing the previous interval.
+  // a null state leaves the track idle.
+  void set_state(uint32_t track, const char* state) {
+    auto& t = tracks_.at(track);
+    if (t.state == state)
+      return;
+    this->change_state(t, state);
+  }
+
+  // record a completed interval [start, end) on a track
+  void slice(uint32_t track, const std::string& name, uint64_t start, uint64_t end);
+
+  // register a counter sampled every period, emitted when it changes
+  void add_counter(const std::string& group, const std::string& name, const Probe& probe);
+
+  // drop all tracks and counters (their owners are going away)
+  void clear();
+
+  // sample counters
+  void tick() {
+    if (!enabled_)
+      return;
+    auto cycle = SimPlatform::instance().cycles();
+    if (0 == (cycle % period_) && this->in_window(cycle)) {
+      this->sample(cycle);
+    }
+  }
+
+  // close open intervals at the end of a run
+  void flush();
+
+private:
+
+  struct track_t {
+    uint32_t pid;
+    uint32_t tid;
+    const char* state;
+    uint64_t start;
+  };
+
+  struct counter_t {
+    uint32_t pid;
+    std::string name;
+    Probe probe;
+    uint64_t value;
+  };
+
+  Timeline();
+
+  uint32_t get_pid(const std::string& group);
+
+  void change_state(track_t& track, const char* state);
+
+  void sample(uint64_t cycle);
+
+  void emit_slice(uint32_t pid, uint32_t tid, const char* name, uint64_t start, uint64_t end);
+
+  bool in_window(uint64_t cycle) const {
+    auto ts = base_ + cycle;
+    return ts >= start_ && ts < end_;
+  }
+
+  bool enabled_;
+  std::ofstream ofs_;
+  uint64_t start_;
+  uint64_t end_;
+  uint64_t period_;
+  uint64_t base_;
+  bool first_event_;
+  std::unordered_map<std::string, uint32_t> pids_;
+  std::vector<uint32_t> num_tids_;
+  std::vector<track_t> tracks_;
+  std::vector<counter_t> counters_;
+};
+
+}
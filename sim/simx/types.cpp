@@ -54,6 +54,7 @@ void LocalMemSwitch::tick() {
     out_dc_req.write = in_req.write;
     out_dc_req.tag   = in_req.tag;
     out_dc_req.cid   = in_req.cid;
+    out_dc_req.wid   = in_req.wid;
     out_dc_req.uuid  = in_req.uuid;
 
     LsuReq out_lmem_req(out_dc_req);
@@ -64,9 +65,11 @@ void LocalMemSwitch::tick() {
         if (type == AddrType::Shared) {
           out_lmem_req.mask.set(i);
           out_lmem_req.addrs.at(i) = in_req.addrs.at(i);
+          out_lmem_req.sizes.at(i) = in_req.sizes.at(i);
         } else {
           out_dc_req.mask.set(i);
           out_dc_req.addrs.at(i) = in_req.addrs.at(i);
+          out_dc_req.sizes.at(i) = in_req.sizes.at(i);
         }
       }
     }
@@ -147,9 +150,11 @@ void LsuMemAdapter::tick() {
         MemReq out_req;
         out_req.write = in_req.write;
         out_req.addr  = in_req.addrs.at(i);
+        out_req.size  = in_req.sizes.at(i);
         out_req.type  = get_addr_type(in_req.addrs.at(i));
         out_req.tag   = in_req.tag;
         out_req.cid   = in_req.cid;
+        out_req.wid   = in_req.wid;
         out_req.uuid  = in_req.uuid;
         // send memory request
         ReqOut.at(i).push(out_req, delay_);
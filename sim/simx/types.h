@@ -641,6 +641,7 @@ inline std::ostream &operator<<(std::ostream &os, const VpuOpType& type) {
 
 enum class TcuType {
   WMMA,
+  WMMA_SP,  // A operand is 2:4 structured-sparse
 };
 
 struct IntrTcuArgs {
@@ -648,11 +649,13 @@ struct IntrTcuArgs {
   uint32_t fmt_d  : 4;
   uint32_t step_m : 4;
   uint32_t step_n : 4;
+  uint32_t step_k : 4;
 };
 
 inline std::ostream &operator<<(std::ostream &os, const TcuType& type) {
   switch (type) {
   case TcuType::WMMA: os << "WMMA"; break;
+  case TcuType::WMMA_SP: os << "WMMA_SP"; break;
   default:
     assert(false);
   }
@@ -668,13 +671,67 @@ enum class DmaType {
   SET_SIZE,  // Set transfer size
   TRIGGER,   // Trigger DMA transfer
   WAIT,      // Wait for DMA completion
+  SET_PARAM, // Set a multi-dimensional descriptor parameter (VX_DMA_PARAM_*)
+  CHAIN,     // Start a linked descriptor chain
+  WAIT_GROUP,// Wait for a completion group
 };
 
 struct IntrDmaArgs {
   int direction;  // 0=G2L, 1=L2G
+  uint32_t param; // SET_PARAM: parameter index
   
-  IntrDmaArgs() : direction(0) {}
-  explicit IntrDmaArgs(int dir) : direction(dir) {}
+  IntrDmaArgs() : direction(0), param(0) {}
+  explicit IntrDmaArgs(int dir, uint32_t _param = 0) : direction(dir), param(_param) {}
+};
+
+// Multi-dimensional DMA descriptor: count[2] x count[1] rows of count[0]
+// elements of elem_size bytes. Rows are placed at the given byte strides in
+// the source and destination. Elements at or beyond valid[d] in any dimension
+// lie outside the source tile: G2L transfers zero-fill them in local memory,
+// L2G transfers skip them.
+struct DmaShape {
+  uint32_t elem_size;
+  uint32_t count[3];
+  uint32_t valid[3];
+  uint64_t src_stride[2]; // dimensions 1 and 2
+  uint64_t dst_stride[2];
+
+  DmaShape(uint64_t size = 0)
+    : elem_size(1)
+    , count{uint32_t(size), 1, 1}
+    , valid{UINT32_MAX, UINT32_MAX, UINT32_MAX}
+    , src_stride{0, 0}
+    , dst_stride{0, 0}
+  {}
+
+  uint64_t row_bytes() const {
+    return uint64_t(count[0]) * elem_size;
+  }
+
+  uint64_t num_rows() const {
+    return uint64_t(count[1]) * count[2];
+  }
+
+  uint64_t row_valid_bytes(uint64_t row) const {
+    uint64_t i1 = row % count[1];
+    uint64_t i2 = row / count[1];
+    if (i1 >= valid[1] || i2 >= valid[2])
+      return 0;
+    return uint64_t(std::min(count[0], valid[0])) * elem_size;
+  }
+
+  uint64_t src_offset(uint64_t row) const {
+    return (row % count[1]) * src_stride[0] + (row / count[1]) * src_stride[1];
+  }
+
+  uint64_t dst_offset(uint64_t row) const {
+    return (row % count[1]) * dst_stride[0] + (row / count[1]) * dst_stride[1];
+  }
+
+  uint64_t valid_bytes() const {
+    uint64_t rows = uint64_t(std::min(count[1], valid[1])) * std::min(count[2], valid[2]);
+    return rows * std::min(count[0], valid[0]) * elem_size;
+  }
 };
 
 inline std::ostream &operator<<(std::ostream &os, const DmaType& type) {
@@ -684,6 +741,9 @@ inline std::ostream &operator<<(std::ostream &os, const DmaType& type) {
   case DmaType::SET_SIZE: os << "DMA_SET_SIZE"; break;
   case DmaType::TRIGGER: os << "DMA_TRIGGER"; break;
   case DmaType::WAIT: os << "DMA_WAIT"; break;
+  case DmaType::SET_PARAM: os << "DMA_SET_PARAM"; break;
+  case DmaType::CHAIN: os << "DMA_CHAIN"; break;
+  case DmaType::WAIT_GROUP: os << "DMA_WAIT_GROUP"; break;
   default:
     assert(false);
   }
@@ -766,6 +826,83 @@ inline std::ostream &operator<<(std::ostream &os, const AddrType& type) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+enum class HashType {
+  Linear, // low-order index bits
+  Xor,    // xor-fold of all index bits
+  Prime,  // modulo the largest prime within range
+  Skew    // low-order bits skewed by the row number
+};
+
+inline std::ostream &operator<<(std::ostream &os, const HashType& type) {
+  switch (type) {
+  case HashType::Linear: os << "Linear"; break;
+  case HashType::Xor:    os << "Xor"; break;
+  case HashType::Prime:  os << "Prime"; break;
+  case HashType::Skew:   os << "Skew"; break;
+  default: assert(false);
+  }
+  return os;
+}
+
+// maps an index (e.g. a line address) onto [0, 2^lg2_range)
+class IndexHash {
+public:
+  IndexHash(HashType type = HashType::Linear, uint32_t lg2_range = 0)
+    : type_(type)
+    , lg2_range_(lg2_range)
+    , mask_((uint64_t(1) << lg2_range) - 1)
+    , prime_(1 << lg2_range) {
+    if (type == HashType::Prime) {
+      while (prime_ > 2 && !is_prime(prime_)) {
+        --prime_;
+      }
+    }
+  }
+
+  HashType type() const {
+    return type_;
+  }
+
+  uint32_t operator()(uint64_t index) const {
+    if (0 == lg2_range_)
+      return 0;
+    switch (type_) {
+    case HashType::Linear:
+      return index & mask_;
+    case HashType::Xor: {
+      uint64_t hash = 0;
+      while (index != 0) {
+        hash ^= index & mask_;
+        index >>= lg2_range_;
+      }
+      return hash;
+    }
+    case HashType::Prime:
+      return index % prime_;
+    case HashType::Skew:
+      return (index + (index >> lg2_range_)) & mask_;
+    default:
+      std::abort();
+    }
+  }
+
+private:
+  static bool is_prime(uint32_t n) {
+    for (uint32_t d = 2; d * d <= n; ++d) {
+      if (0 == (n % d))
+        return false;
+    }
+    return true;
+  }
+
+  HashType type_;
+  uint32_t lg2_range_;
+  uint64_t mask_;
+  uint32_t prime_;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 struct mem_addr_size_t {
   uint64_t addr;
   uint32_t size;
@@ -938,17 +1075,21 @@ private:
 struct LsuReq {
   BitVector<> mask;
   std::vector<uint64_t> addrs;
+  std::vector<uint32_t> sizes;  // access size in bytes (0: full word)
   bool     write;
   uint32_t tag;
   uint32_t cid;
+  uint32_t wid;
   uint64_t uuid;
 
   LsuReq(uint32_t size)
     : mask(size)
     , addrs(size, 0)
+    , sizes(size, 0)
     , write(false)
     , tag(0)
     , cid(0)
+    , wid(0)
     , uuid(0)
   {}
 
@@ -996,29 +1137,44 @@ struct LsuRsp {
 
 struct MemReq {
   uint64_t addr;
+  uint32_t size;  // request size in bytes (0: full word)
   bool     write;
   AddrType type;
   uint32_t tag;
   uint32_t cid;
+  uint32_t wid;   // issuing warp (local memory statistics)
   uint64_t uuid;
+  bool     evict; // victim line insertion into an exclusive cache
+  bool     sectored; // partial line fill or sector write-back
 
   MemReq(uint64_t _addr = 0,
           bool _write = false,
           AddrType _type = AddrType::Global,
           uint64_t _tag = 0,
           uint32_t _cid = 0,
-          uint64_t _uuid = 0
+          uint64_t _uuid = 0,
+          uint32_t _size = 0
   ) : addr(_addr)
+    , size(_size)
     , write(_write)
     , type(_type)
     , tag(_tag)
     , cid(_cid)
+    , wid(0)
     , uuid(_uuid)
+    , evict(false)
+    , sectored(false)
   {}
 
   friend std::ostream &operator<<(std::ostream &os, const MemReq& req) {
     os << "rw=" << req.write << ", ";
+    if (req.evict) {
+      os << "evict=1, ";
+    }
     os << "addr=0x" << std::hex << req.addr << std::dec << ", type=" << req.type;
+    if (req.size != 0) {
+      os << ", size=" << req.size;
+    }
     os << ", tag=0x" << std::hex << req.tag << std::dec << ", cid=" << req.cid;
     os << " (#" << req.uuid << ")";
     return os;
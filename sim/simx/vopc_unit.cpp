@@ -18,66 +18,28 @@ using namespace vortex;
 
 VOpcUnit::VOpcUnit(const SimContext &ctx, Core* core)
   : SimObject<VOpcUnit>(ctx, "vopc-unit")
-  , Input(this)
-  , Output(this)
-  , core_(core) {
-  this->reset();
+  , Inputs(WARP_ISSUE_WIDTH, this)
+  , Outputs(WARP_ISSUE_WIDTH, this)
+  , opc_unit_(OpcUnit::Create(core->rf_banks(), core->vrf_banks())) {
+  for (uint32_t k = 0; k < WARP_ISSUE_WIDTH; ++k) {
+    this->Inputs.at(k).bind(&opc_unit_->Inputs.at(k));
+    opc_unit_->Outputs.at(k).bind(&this->Outputs.at(k));
+    this->Outputs.at(k).tx_callback([](instr_trace_t* const& trace, uint64_t) {
+      if (trace->fu_type == FUType::VPU) {
+        translate(trace);
+      }
+    });
+  }
 }
 
 VOpcUnit::~VOpcUnit() {}
 
 void VOpcUnit::reset() {
-  total_stalls_ = 0;
+  //--
 }
 
 void VOpcUnit::tick() {
-  // process incoming instructions
-  if (Input.empty())
-    return;
-  auto trace = Input.front();
-
-  uint32_t scalar_stalls = 0;
-  uint32_t vector_stalls = 0;
-
-  // calculate bank conflict stalls
-  for (uint32_t i = 0; i < NUM_SRC_REGS; ++i) {
-    for (uint32_t j = i + 1; j < NUM_SRC_REGS; ++j) {
-      if ((trace->src_regs[i].type == RegType::None)
-       || (trace->src_regs[j].type == RegType::None))
-        continue;
-      if ((trace->src_regs[i].type == RegType::Integer && trace->src_regs[i].id() == 0)
-       || (trace->src_regs[j].type == RegType::Integer && trace->src_regs[j].id() == 0))
-        continue; // skip x0
-      // bank conflict
-      uint32_t bank_i = trace->src_regs[i].idx % NUM_GPR_BANKS;
-      uint32_t bank_j = trace->src_regs[j].idx % NUM_GPR_BANKS;
-      if (bank_i == bank_j) {
-        if (trace->src_regs[i].type == RegType::Vector
-         && trace->src_regs[j].type == RegType::Vector) {
-          ++scalar_stalls;
-        } else
-        if ((trace->src_regs[i].type != RegType::Vector
-          && trace->src_regs[j].type != RegType::Vector)) {
-          ++vector_stalls;
-        }
-      }
-    }
-  }
-
-  auto stalls  = std::max(scalar_stalls, vector_stalls);
-
-  total_stalls_ += stalls;
-
-  if (trace->fu_type == FUType::VPU) {
-    // translate VPU instructions
-    this->translate(trace);
-  }
-
-  this->Output.push(trace, 2 + stalls);
-
-  DT(3, "pipeline-operands: " << *trace);
-
-  Input.pop();
+  //--
 }
 
 void VOpcUnit::translate(instr_trace_t* trace) {
@@ -127,6 +89,6 @@ void VOpcUnit::translate(instr_trace_t* trace) {
   }
 }
 
-void VOpcUnit::writeback(instr_trace_t* /*trace*/) {
-  //--
+void VOpcUnit::writeback(instr_trace_t* trace) {
+  opc_unit_->writeback(trace);
 }
\ No newline at end of file
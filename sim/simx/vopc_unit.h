@@ -14,15 +14,19 @@
 #pragma once
 
 #include "instr_trace.h"
+#include "opc_unit.h"
 
 namespace vortex {
 
 class Core;
 
+// Vector operand collection: a banked OpcUnit whose vector registers live in
+// their own banks (Core::vrf_banks). VPU instructions are translated to the
+// functional unit executing them as they leave the collectors.
 class VOpcUnit : public SimObject<VOpcUnit> {
 public:
-  SimPort<instr_trace_t*> Input;
-  SimPort<instr_trace_t*> Output;
+  std::vector<SimPort<instr_trace_t*>> Inputs;  // one per issue slot
+  std::vector<SimPort<instr_trace_t*>> Outputs;
 
   VOpcUnit(const SimContext &ctx, Core* core);
 
@@ -35,15 +39,18 @@ public:
   void writeback(instr_trace_t* trace);
 
   uint32_t total_stalls() const {
-    return total_stalls_;
+    return opc_unit_->total_stalls();
+  }
+
+  const OpcUnit::PerfStats& perf_stats() const {
+    return opc_unit_->perf_stats();
   }
 
 private:
 
-  void translate(instr_trace_t* trace);
+  static void translate(instr_trace_t* trace);
 
-  Core*    core_;
-  uint32_t total_stalls_ = 0;
+  OpcUnit::Ptr opc_unit_;
 };
 
 } // namespace vortex
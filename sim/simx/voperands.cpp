@@ -18,8 +18,8 @@ using namespace vortex;
 
 Operands::Operands(const SimContext &ctx, Core* core)
     : SimObject<Operands>(ctx, "operands")
-    , Input(this)
-    , Output(this)
+    , Inputs(WARP_ISSUE_WIDTH, this)
+    , Outputs(WARP_ISSUE_WIDTH, this)
     , opc_units_(NUM_OPCS) {
   static_assert(NUM_OPCS <= PER_ISSUE_WARPS, "invalid NUM_OPCS value");
   // create OPC units
@@ -30,15 +30,19 @@ Operands::Operands(const SimContext &ctx, Core* core)
   if (NUM_OPCS >= 2) {
     char sname[100];
     snprintf(sname, 100, "%s-rsp_arb", this->name().c_str());
-    rsp_arb_ = TraceArbiter::Create(sname, ArbiterType::RoundRobin, NUM_OPCS, 1);
-    for (uint32_t i = 0; i < NUM_OPCS; ++i) {
-      opc_units_.at(i)->Output.bind(&rsp_arb_->Inputs.at(i));
+    rsp_arb_ = TraceArbiter::Create(sname, ArbiterType::RoundRobin, NUM_OPCS * WARP_ISSUE_WIDTH, WARP_ISSUE_WIDTH);
+    for (uint32_t k = 0; k < WARP_ISSUE_WIDTH; ++k) {
+      for (uint32_t i = 0; i < NUM_OPCS; ++i) {
+        opc_units_.at(i)->Outputs.at(k).bind(&rsp_arb_->Inputs.at(k * NUM_OPCS + i));
+      }
+      rsp_arb_->Outputs.at(k).bind(&this->Outputs.at(k));
     }
-    rsp_arb_->Outputs.at(0).bind(&this->Output);
   } else {
     // pass-thru
-    this->Input.bind(&opc_units_.at(0)->Input);
-    opc_units_.at(0)->Output.bind(&this->Output);
+    for (uint32_t k = 0; k < WARP_ISSUE_WIDTH; ++k) {
+      this->Inputs.at(k).bind(&opc_units_.at(0)->Inputs.at(k));
+      opc_units_.at(0)->Outputs.at(k).bind(&this->Outputs.at(k));
+    }
   }
 }
 
@@ -55,15 +59,15 @@ void Operands::tick() {
     return; // pass-thru
 
   // process requests
-  if (Input.empty())
-    return;
-  auto trace = this->Input.front();
-  for (uint32_t i = 0; i < NUM_OPCS; i++) {
+  for (uint32_t k = 0; k < WARP_ISSUE_WIDTH; ++k) {
+    auto& input = Inputs.at(k);
+    if (input.empty())
+      continue;
+    auto trace = input.front();
     uint32_t wis = trace->wid / ISSUE_WIDTH;
     uint32_t index = wis % NUM_OPCS;
-    opc_units_.at(index)->Input.push(trace);
-    Input.pop();
-    break;
+    opc_units_.at(index)->Inputs.at(k).push(trace);
+    input.pop();
   }
 }
 
@@ -75,6 +79,14 @@ uint32_t Operands::total_stalls() const {
   return total;
 }
 
+OpcUnit::PerfStats Operands::perf_stats() const {
+  OpcUnit::PerfStats perf;
+  for (const auto& opc_unit : opc_units_) {
+    perf += opc_unit->perf_stats();
+  }
+  return perf;
+}
+
 void Operands::writeback(instr_trace_t* trace) {
   uint32_t wis = trace->wid / ISSUE_WIDTH;
   uint32_t index = wis % NUM_OPCS;
@@ -22,8 +22,8 @@ class Core;
 
 class Operands : public SimObject<Operands> {
 public:
-  SimPort<instr_trace_t*> Input;
-  SimPort<instr_trace_t*> Output;
+  std::vector<SimPort<instr_trace_t*>> Inputs;  // one per issue slot
+  std::vector<SimPort<instr_trace_t*>> Outputs;
 
   Operands(const SimContext &ctx, Core* core);
 
@@ -37,6 +37,8 @@ public:
 
   uint32_t total_stalls() const;
 
+  OpcUnit::PerfStats perf_stats() const;
+
 private:
   std::vector<VOpcUnit::Ptr> opc_units_;
   TraceArbiter::Ptr rsp_arb_;
@@ -0,0 +1,249 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "warp_sched.h"
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+using namespace vortex;
+
+namespace {
+
+// Priority and LRR are the fixed-priority and round-robin arbiters
+class ArbiterWarpSched : public IWarpSchedImpl {
+public:
+  ArbiterWarpSched(ArbiterType type, uint32_t size) : arbiter_(type, size) {}
+
+  uint32_t select(const BitVector<>& ready) override {
+    return arbiter_.grant(ready);
+  }
+
+  void reset() override {
+    arbiter_.reset();
+  }
+
+private:
+  Arbiter arbiter_;
+};
+
+class GTOWarpSched : public IWarpSchedImpl {
+public:
+  GTOWarpSched(uint32_t size) : size_(size) {
+    this->reset();
+  }
+
+  uint32_t select(const BitVector<>& ready) override {
+    assert(ready.size() == size_);
+    return this->select_gto(ready, nullptr);
+  }
+
+  void reset() override {
+    last_grant_ = -1;
+  }
+
+protected:
+  // keep issuing from the last warp, else fall back to the oldest one.
+  // warps are launched in index order, so the oldest is the lowest index.
+  uint32_t select_gto(const BitVector<>& ready, const BitVector<>* eligible) {
+    auto allowed = [&](uint32_t w) {
+      return ready.test(w) && (eligible == nullptr || eligible->test(w));
+    };
+    if (last_grant_ != uint32_t(-1) && allowed(last_grant_))
+      return last_grant_;
+    for (uint32_t i = 0; i < size_; ++i) {
+      if (allowed(i)) {
+        last_grant_ = i;
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  uint32_t size_;
+  uint32_t last_grant_;
+};
+
+class TwoLevelWarpSched : public IWarpSchedImpl {
+public:
+  TwoLevelWarpSched(uint32_t size, uint32_t active_size)
+    : size_(size)
+    , active_size_(active_size ? std::min(active_size, size) : std::max<uint32_t>(size / 2, 1))
+    , active_(size) {
+    this->reset();
+  }
+
+  uint32_t select(const BitVector<>& ready) override {
+    assert(ready.size() == size_);
+    auto grant = this->select_active(ready);
+    if (grant != uint32_t(-1))
+      return grant;
+
+    // no active warp can issue: demote them and promote ready pending warps
+    for (uint32_t i = 0; i < size_; ++i) {
+      if (active_.test(i) && !ready.test(i)) {
+        active_.reset(i);
+        --active_count_;
+      }
+    }
+    for (uint32_t i = 0; i < size_ && active_count_ < active_size_; ++i) {
+      uint32_t idx = (next_promote_ + i) % size_;
+      if (!active_.test(idx) && ready.test(idx)) {
+        active_.set(idx);
+        ++active_count_;
+        next_promote_ = (idx + 1) % size_;
+      }
+    }
+    return this->select_active(ready);
+  }
+
+  void reset() override {
+    active_.reset();
+    active_count_ = 0;
+    next_promote_ = 0;
+    last_grant_ = 0;
+  }
+
+private:
+  uint32_t select_active(const BitVector<>& ready) {
+    uint32_t start = (last_grant_ + 1) % size_;
+    for (uint32_t i = 0; i < size_; ++i) {
+      uint32_t idx = (start + i) % size_;
+      if (active_.test(idx) && ready.test(idx)) {
+        last_grant_ = idx;
+        return idx;
+      }
+    }
+    return -1;
+  }
+
+  uint32_t size_;
+  uint32_t active_size_;
+  BitVector<> active_;
+  uint32_t active_count_;
+  uint32_t next_promote_;
+  uint32_t last_grant_;
+};
+
+// Cache-conscious wavefront scheduling: warps that lose intra-warp locality
+// raise their lost-locality score (LLS), and warps with the lowest scores are
+// throttled until the total fits within the cutoff (num_warps * base score).
+// The per-warp victim tag array records the lines each warp missed on, so
+// a repeated miss to one of them stands for a line evicted before reuse.
+class CCWSWarpSched : public GTOWarpSched {
+public:
+  CCWSWarpSched(uint32_t size, uint32_t vta_size, uint32_t lls_score)
+    : GTOWarpSched(size)
+    , vta_size_(std::max<uint32_t>(vta_size, 1))
+    , base_score_(std::max<uint32_t>(lls_score, 1))
+    , vta_(size * vta_size_)
+    , vta_next_(size)
+    , lls_(size)
+    , order_(size)
+    , eligible_(size) {
+    this->reset();
+  }
+
+  uint32_t select(const BitVector<>& ready) override {
+    assert(ready.size() == size_);
+    bool throttling = false;
+    for (uint32_t w = 0; w < size_; ++w) {
+      if (lls_.at(w) != 0) {
+        --lls_.at(w); // scores decay back to the base
+        throttling = true;
+      }
+    }
+    if (!throttling)
+      return this->select_gto(ready, nullptr);
+
+    // keep the highest-scoring warps within the cutoff
+    std::iota(order_.begin(), order_.end(), 0);
+    std::sort(order_.begin(), order_.end(), [&](uint32_t a, uint32_t b) {
+      auto sa = lls_.at(a), sb = lls_.at(b);
+      return (sa > sb) || (sa == sb && a < b);
+    });
+    uint64_t cutoff = uint64_t(size_) * base_score_;
+    uint64_t total = 0;
+    eligible_.reset();
+    for (uint32_t i = 0; i < size_; ++i) {
+      uint32_t w = order_.at(i);
+      total += base_score_ + lls_.at(w);
+      if (i != 0 && total > cutoff)
+        break;
+      eligible_.set(w);
+    }
+    auto grant = this->select_gto(ready, &eligible_);
+    if (grant == uint32_t(-1)) {
+      // never leave the core idle because of throttling
+      grant = this->select_gto(ready, nullptr);
+    }
+    return grant;
+  }
+
+  void dcache_miss(uint32_t wid, uint64_t addr) override {
+    if (wid >= size_)
+      return;
+    auto vta = vta_.begin() + wid * vta_size_;
+    if (std::find(vta, vta + vta_size_, addr) != vta + vta_size_) {
+      lls_.at(wid) += base_score_;
+      return;
+    }
+    auto& next = vta_next_.at(wid);
+    *(vta + next) = addr;
+    next = (next + 1) % vta_size_;
+  }
+
+  void reset() override {
+    GTOWarpSched::reset();
+    std::fill(vta_.begin(), vta_.end(), uint64_t(-1));
+    std::fill(vta_next_.begin(), vta_next_.end(), 0);
+    std::fill(lls_.begin(), lls_.end(), 0);
+  }
+
+private:
+  uint32_t vta_size_;
+  uint32_t base_score_;
+  std::vector<uint64_t> vta_;
+  std::vector<uint32_t> vta_next_;
+  std::vector<uint32_t> lls_;
+  std::vector<uint32_t> order_;
+  BitVector<> eligible_;
+};
+
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+WarpScheduler::WarpScheduler(const Config& config) {
+  switch (config.type) {
+  case WarpSchedType::Priority:
+    impl_ = std::make_shared<ArbiterWarpSched>(ArbiterType::Priority, config.num_warps);
+    break;
+  case WarpSchedType::LRR:
+    impl_ = std::make_shared<ArbiterWarpSched>(ArbiterType::RoundRobin, config.num_warps);
+    break;
+  case WarpSchedType::GTO:
+    impl_ = std::make_shared<GTOWarpSched>(config.num_warps);
+    break;
+  case WarpSchedType::TwoLevel:
+    impl_ = std::make_shared<TwoLevelWarpSched>(config.num_warps, config.active_warps);
+    break;
+  case WarpSchedType::CCWS:
+    impl_ = std::make_shared<CCWSWarpSched>(config.num_warps, config.vta_size, config.lls_score);
+    break;
+  default:
+    assert(false);
+  }
+}
+
+WarpScheduler::~WarpScheduler() {}
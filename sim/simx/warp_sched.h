@@ -0,0 +1,84 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include "types.h"
+
+namespace vortex {
+
+enum class WarpSchedType {
+  Priority, // lowest-numbered ready warp
+  LRR,      // loose round-robin
+  GTO,      // greedy-then-oldest
+  TwoLevel, // round-robin within an active set
+  CCWS      // cache-conscious throttling over GTO
+};
+
+inline std::ostream &operator<<(std::ostream &os, const WarpSchedType& type) {
+  switch (type) {
+  case WarpSchedType::Priority: os << "Priority"; break;
+  case WarpSchedType::LRR:      os << "LRR"; break;
+  case WarpSchedType::GTO:      os << "GTO"; break;
+  case WarpSchedType::TwoLevel: os << "TwoLevel"; break;
+  case WarpSchedType::CCWS:     os << "CCWS"; break;
+  default: assert(false);
+  }
+  return os;
+}
+
+class IWarpSchedImpl {
+public:
+  IWarpSchedImpl() {}
+  virtual ~IWarpSchedImpl() {}
+  virtual uint32_t select(const BitVector<>& ready) = 0;
+  virtual void dcache_miss(uint32_t /*wid*/, uint64_t /*addr*/) {}
+  virtual void reset() = 0;
+};
+
+// Warp selection policy shared by the schedule and issue stages.
+// Warp indices are local to the scheduler (0..num_warps-1).
+class WarpScheduler {
+public:
+  struct Config {
+    WarpSchedType type;
+    uint32_t num_warps;
+    uint32_t active_warps; // two-level active set size (0: half of the warps)
+    uint32_t vta_size;     // CCWS victim tag array entries per warp
+    uint32_t lls_score;    // CCWS lost-locality score increment
+  };
+
+  WarpScheduler(const Config& config);
+
+  ~WarpScheduler();
+
+  // return the selected warp from the ready set, -1 if none
+  uint32_t select(const BitVector<>& ready) {
+    return impl_->select(ready);
+  }
+
+  // notify an L1 data cache miss issued by the given warp
+  void dcache_miss(uint32_t wid, uint64_t addr) {
+    impl_->dcache_miss(wid, addr);
+  }
+
+  void reset() {
+    impl_->reset();
+  }
+
+private:
+  std::shared_ptr<IWarpSchedImpl> impl_;
+};
+
+}
@@ -0,0 +1,23 @@
+#ifndef _COMMON_H_
+#define _COMMON_H_
+
+#ifndef TYPE
+#define TYPE int
+#endif
+
+#define CHUNK_SIZE 64  // elements per step
+
+// groups of the two halves of the write-back
+#define GROUP_LO 1
+#define GROUP_HI 2
+
+typedef struct {
+  uint32_t num_points;
+  uint32_t bar_id;     // local barrier signaled by the DMA engine
+  uint64_t src_addr;
+  uint64_t dst_addr;   // src * 2, through a chain and two groups
+  uint64_t dst2_addr;  // src + 1, through a barrier signal
+  uint64_t dst3_addr;  // src + 3, through two signals of one barrier phase
+} kernel_arg_t;
+
+#endif
@@ -0,0 +1,98 @@
+#include <vx_spawn.h>
+#include <vx_intrinsics.h>
+#include "common.h"
+
+void kernel_body(kernel_arg_t* __UNIFORM__ arg) {
+	auto src  = reinterpret_cast<TYPE*>(arg->src_addr);
+	auto dst  = reinterpret_cast<TYPE*>(arg->dst_addr);
+	auto dst2 = reinterpret_cast<TYPE*>(arg->dst2_addr);
+	auto dst3 = reinterpret_cast<TYPE*>(arg->dst3_addr);
+
+	int tid = threadIdx.x;
+	int num_threads = blockDim.x;
+	bool leader = (threadIdx.x == 0);
+
+	TYPE* local_buf = (TYPE*)__local_mem(2 * CHUNK_SIZE * sizeof(TYPE));
+	TYPE* local_buf2 = local_buf + CHUNK_SIZE;
+
+	constexpr uint32_t half = CHUNK_SIZE / 2;
+
+	for (uint32_t offset = 0; offset < arg->num_points; offset += CHUNK_SIZE) {
+		// chain: load the chunk as two 8-column tiles of half-chunk rows
+		if (leader) {
+			vx_dma_desc_t desc;
+			vx_dma_desc_2d(&desc, sizeof(TYPE), 8, half / 8, 8 * sizeof(TYPE), 8 * sizeof(TYPE));
+			vx_dma_node_t nodes[2];
+			vx_dma_node_init(&nodes[1], local_buf + half, src + offset + half, DMA_DIR_G2L, &desc, nullptr);
+			vx_dma_node_init(&nodes[0], local_buf, src + offset, DMA_DIR_G2L, &desc, &nodes[1]);
+			dma_id_t id;
+			do {
+				id = vx_dma_chain(&nodes[0]);
+			} while (id < 0);
+			vx_dma_wait(id);
+		}
+		__syncthreads();
+
+		for (uint32_t i = tid; i < CHUNK_SIZE; i += num_threads) {
+			local_buf[i] = local_buf[i] * 2;
+		}
+		__syncthreads();
+
+		// groups: write back each half in its own completion group
+		if (leader) {
+			dma_id_t id;
+			do {
+				vx_dma_set_group(GROUP_LO);
+				id = vx_dma_l2g(dst + offset, local_buf, half * sizeof(TYPE));
+			} while (id < 0);
+			do {
+				vx_dma_set_group(GROUP_HI);
+				id = vx_dma_l2g(dst + offset + half, local_buf + half, half * sizeof(TYPE));
+			} while (id < 0);
+			vx_dma_wait_group(GROUP_HI);
+			vx_dma_wait_group(GROUP_LO);
+		}
+
+		// barrier signal: the warps sleep until the transfer arrives
+		if (leader) {
+			dma_id_t id;
+			do {
+				vx_dma_set_barrier(arg->bar_id);
+				id = vx_dma_g2l(local_buf2, src + offset, CHUNK_SIZE * sizeof(TYPE));
+			} while (id < 0);
+		}
+		vx_barrier(arg->bar_id, __warps_per_group + 1);
+
+		for (uint32_t i = tid; i < CHUNK_SIZE; i += num_threads) {
+			dst2[offset + i] = local_buf2[i] + 1;
+		}
+		__syncthreads();
+
+		// two transfers signal the same barrier phase, each one stands for an arrival
+		if (leader) {
+			dma_id_t id;
+			do {
+				vx_dma_set_barrier(arg->bar_id);
+				id = vx_dma_g2l(local_buf2, src + offset, half * sizeof(TYPE));
+			} while (id < 0);
+			do {
+				vx_dma_set_barrier(arg->bar_id);
+				id = vx_dma_g2l(local_buf2 + half, src + offset + half, half * sizeof(TYPE));
+			} while (id < 0);
+		}
+		vx_barrier(arg->bar_id, __warps_per_group + 2);
+
+		for (uint32_t i = tid; i < CHUNK_SIZE; i += num_threads) {
+			dst3[offset + i] = local_buf2[i] + 3;
+		}
+		__syncthreads();
+	}
+}
+
+int main() {
+	kernel_arg_t* arg = (kernel_arg_t*)csr_read(VX_CSR_MSCRATCH);
+	// all warps in one block to share local memory
+	uint32_t block_size = vx_num_warps() * vx_num_threads();
+	uint32_t grid_size = 1;
+	return vx_spawn_threads(1, &grid_size, &block_size, (vx_kernel_func_cb)kernel_body, arg);
+}
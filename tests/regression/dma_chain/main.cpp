@@ -0,0 +1,187 @@
+#include <iostream>
+#include <unistd.h>
+#include <string.h>
+#include <vector>
+#include <vortex.h>
+#include "common.h"
+
+#define RT_CHECK(_expr)                                         \
+   do {                                                         \
+     int _ret = _expr;                                          \
+     if (0 == _ret)                                             \
+       break;                                                   \
+     printf("Error: '%s' returned %d!\n", #_expr, (int)_ret);   \
+	 cleanup();			                                              \
+     exit(-1);                                                  \
+   } while (false)
+
+const char* kernel_file = "kernel.vxbin";
+uint32_t size = 256;
+
+vx_device_h device = nullptr;
+vx_buffer_h src_buffer = nullptr;
+vx_buffer_h dst_buffer = nullptr;
+vx_buffer_h dst2_buffer = nullptr;
+vx_buffer_h dst3_buffer = nullptr;
+vx_buffer_h krnl_buffer = nullptr;
+vx_buffer_h args_buffer = nullptr;
+kernel_arg_t kernel_arg = {};
+
+static void show_usage() {
+   std::cout << "Vortex DMA Chain, Group and Barrier Test." << std::endl;
+   std::cout << "Usage: [-k: kernel] [-n words] [-h: help]" << std::endl;
+}
+
+static void parse_args(int argc, char **argv) {
+  int c;
+  while ((c = getopt(argc, argv, "n:k:h")) != -1) {
+    switch (c) {
+    case 'n':
+      size = atoi(optarg);
+      break;
+    case 'k':
+      kernel_file = optarg;
+      break;
+    case 'h':
+      show_usage();
+      exit(0);
+      break;
+    default:
+      show_usage();
+      exit(-1);
+    }
+  }
+}
+
+void cleanup() {
+  if (device) {
+    vx_mem_free(src_buffer);
+    vx_mem_free(dst_buffer);
+    vx_mem_free(dst2_buffer);
+    vx_mem_free(dst3_buffer);
+    vx_mem_free(krnl_buffer);
+    vx_mem_free(args_buffer);
+    vx_dev_close(device);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  parse_args(argc, argv);
+
+  std::srand(50);
+
+  std::cout << "open device connection" << std::endl;
+  RT_CHECK(vx_dev_open(&device));
+
+  uint64_t num_warps;
+  RT_CHECK(vx_dev_caps(device, VX_CAPS_NUM_WARPS, &num_warps));
+  if (num_warps < 4) {
+    // the kernel needs a local barrier besides the one of its work group
+    std::cout << "Error: this test requires at least 4 warps per core!" << std::endl;
+    cleanup();
+    return -1;
+  }
+
+  uint32_t num_points = ((size + CHUNK_SIZE - 1) / CHUNK_SIZE) * CHUNK_SIZE;
+  uint32_t buf_size = num_points * sizeof(TYPE);
+
+  std::cout << "number of points: " << num_points << std::endl;
+  std::cout << "buffer size: " << buf_size << " bytes" << std::endl;
+
+  kernel_arg.num_points = num_points;
+  kernel_arg.bar_id = 1;
+
+  // allocate device memory
+  std::cout << "allocate device memory" << std::endl;
+  RT_CHECK(vx_mem_alloc(device, buf_size, VX_MEM_READ, &src_buffer));
+  RT_CHECK(vx_mem_address(src_buffer, &kernel_arg.src_addr));
+  RT_CHECK(vx_mem_alloc(device, buf_size, VX_MEM_WRITE, &dst_buffer));
+  RT_CHECK(vx_mem_address(dst_buffer, &kernel_arg.dst_addr));
+  RT_CHECK(vx_mem_alloc(device, buf_size, VX_MEM_WRITE, &dst2_buffer));
+  RT_CHECK(vx_mem_address(dst2_buffer, &kernel_arg.dst2_addr));
+  RT_CHECK(vx_mem_alloc(device, buf_size, VX_MEM_WRITE, &dst3_buffer));
+  RT_CHECK(vx_mem_address(dst3_buffer, &kernel_arg.dst3_addr));
+
+  std::cout << "dev_src=0x" << std::hex << kernel_arg.src_addr << std::endl;
+  std::cout << "dev_dst=0x" << std::hex << kernel_arg.dst_addr << std::endl;
+  std::cout << "dev_dst2=0x" << std::hex << kernel_arg.dst2_addr << std::endl;
+  std::cout << "dev_dst3=0x" << std::hex << kernel_arg.dst3_addr << std::dec << std::endl;
+
+  // allocate host buffers
+  std::cout << "allocate host buffers" << std::endl;
+  std::vector<TYPE> h_src(num_points);
+  std::vector<TYPE> h_dst(num_points);
+  std::vector<TYPE> h_dst2(num_points);
+  std::vector<TYPE> h_dst3(num_points);
+
+  for (uint32_t i = 0; i < num_points; ++i) {
+    h_src[i] = std::rand() % 1000;
+  }
+
+  // upload source buffer
+  std::cout << "upload source buffer" << std::endl;
+  RT_CHECK(vx_copy_to_dev(src_buffer, h_src.data(), 0, buf_size));
+
+  // Upload kernel binary
+  std::cout << "upload kernel binary" << std::endl;
+  RT_CHECK(vx_upload_kernel_file(device, kernel_file, &krnl_buffer));
+
+  // upload kernel argument
+  std::cout << "upload kernel argument" << std::endl;
+  RT_CHECK(vx_upload_bytes(device, &kernel_arg, sizeof(kernel_arg_t), &args_buffer));
+
+  // start device
+  std::cout << "start device" << std::endl;
+  RT_CHECK(vx_start(device, krnl_buffer, args_buffer));
+
+  // wait for completion
+  std::cout << "wait for completion" << std::endl;
+  RT_CHECK(vx_ready_wait(device, VX_MAX_TIMEOUT));
+
+  // download destination buffers
+  std::cout << "download destination buffers" << std::endl;
+  RT_CHECK(vx_copy_from_dev(h_dst.data(), dst_buffer, 0, buf_size));
+  RT_CHECK(vx_copy_from_dev(h_dst2.data(), dst2_buffer, 0, buf_size));
+  RT_CHECK(vx_copy_from_dev(h_dst3.data(), dst3_buffer, 0, buf_size));
+
+  // verify result
+  std::cout << "verify result" << std::endl;
+  int errors = 0;
+  for (uint32_t i = 0; i < num_points; ++i) {
+    auto ref = h_src[i] * 2;
+    if (h_dst[i] != ref) {
+      if (errors < 10) {
+        printf("*** error: dst[%d] expected=%d, actual=%d\n", i, ref, h_dst[i]);
+      }
+      ++errors;
+    }
+    auto ref2 = h_src[i] + 1;
+    if (h_dst2[i] != ref2) {
+      if (errors < 10) {
+        printf("*** error: dst2[%d] expected=%d, actual=%d\n", i, ref2, h_dst2[i]);
+      }
+      ++errors;
+    }
+    auto ref3 = h_src[i] + 3;
+    if (h_dst3[i] != ref3) {
+      if (errors < 10) {
+        printf("*** error: dst3[%d] expected=%d, actual=%d\n", i, ref3, h_dst3[i]);
+      }
+      ++errors;
+    }
+  }
+
+  // cleanup
+  std::cout << "cleanup" << std::endl;
+  cleanup();
+
+  if (errors != 0) {
+    std::cout << "Found " << std::dec << errors << " errors!" << std::endl;
+    std::cout << "FAILED!" << std::endl;
+    return 1;
+  }
+
+  std::cout << "PASSED!" << std::endl;
+
+  return 0;
+}
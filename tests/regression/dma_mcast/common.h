@@ -0,0 +1,17 @@
+#ifndef _COMMON_H_
+#define _COMMON_H_
+
+#ifndef TYPE
+#define TYPE int
+#endif
+
+#define MCAST_BAR_ID 0  // local barrier signaled in each receiving core
+
+typedef struct {
+  uint32_t num_points;   // tile elements
+  uint32_t socket_size;  // cores per socket
+  uint64_t src_addr;     // one tile per socket
+  uint64_t dst_addr;     // one tile per core
+} kernel_arg_t;
+
+#endif
@@ -0,0 +1,49 @@
+#include <vx_spawn.h>
+#include <vx_intrinsics.h>
+#include "common.h"
+
+void kernel_body(kernel_arg_t* __UNIFORM__ arg) {
+	auto num_cores = vx_num_cores();
+	auto num_warps = vx_num_warps();
+	auto num_threads = vx_num_threads();
+
+	auto cid = vx_core_id();
+	auto wid = vx_warp_id();
+	auto tid = vx_thread_id();
+
+	uint32_t socket_id = cid / arg->socket_size;
+	uint32_t socket_core = cid % arg->socket_size;
+
+	auto src = reinterpret_cast<TYPE*>(arg->src_addr) + socket_id * arg->num_points;
+	auto dst = reinterpret_cast<TYPE*>(arg->dst_addr) + cid * arg->num_points;
+	auto local_buf = reinterpret_cast<TYPE*>(csr_read(VX_CSR_LOCAL_MEM_BASE));
+
+	// the first core of each socket reads the tile once into all cores of the socket
+	if (socket_core == 0 && wid == 0 && tid == 0) {
+		uint32_t socket_cores = num_cores - socket_id * arg->socket_size;
+		if (socket_cores > arg->socket_size) {
+			socket_cores = arg->socket_size;
+		}
+		uint32_t core_mask = (1u << socket_cores) - 1;
+		dma_id_t id;
+		do {
+			vx_dma_set_barrier(MCAST_BAR_ID);
+			id = vx_dma_g2l_mcast(local_buf, src, arg->num_points * sizeof(TYPE), core_mask);
+		} while (id < 0);
+	}
+
+	// every core sleeps until the tile lands in its own local memory
+	vx_barrier(MCAST_BAR_ID, num_warps + 1);
+
+	// copy the received tile out
+	for (uint32_t i = wid * num_threads + tid; i < arg->num_points; i += num_warps * num_threads) {
+		dst[i] = local_buf[i];
+	}
+}
+
+int main() {
+	kernel_arg_t* arg = (kernel_arg_t*)csr_read(VX_CSR_MSCRATCH);
+	// one task per hardware thread, so all warps of every core take part
+	uint32_t num_tasks = vx_num_cores() * vx_num_warps() * vx_num_threads();
+	return vx_spawn_threads(1, &num_tasks, nullptr, (vx_kernel_func_cb)kernel_body, arg);
+}
@@ -0,0 +1,181 @@
+#include <iostream>
+#include <unistd.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include <vortex.h>
+#include "common.h"
+
+#define RT_CHECK(_expr)                                         \
+   do {                                                         \
+     int _ret = _expr;                                          \
+     if (0 == _ret)                                             \
+       break;                                                   \
+     printf("Error: '%s' returned %d!\n", #_expr, (int)_ret);   \
+	 cleanup();			                                              \
+     exit(-1);                                                  \
+   } while (false)
+
+const char* kernel_file = "kernel.vxbin";
+uint32_t size = 256;
+uint32_t socket_size = 0;
+
+vx_device_h device = nullptr;
+vx_buffer_h src_buffer = nullptr;
+vx_buffer_h dst_buffer = nullptr;
+vx_buffer_h krnl_buffer = nullptr;
+vx_buffer_h args_buffer = nullptr;
+kernel_arg_t kernel_arg = {};
+
+static void show_usage() {
+   std::cout << "Vortex DMA Multicast Test." << std::endl;
+   std::cout << "Usage: [-k: kernel] [-n words] [-s socket size] [-h: help]" << std::endl;
+}
+
+static void parse_args(int argc, char **argv) {
+  int c;
+  while ((c = getopt(argc, argv, "n:s:k:h")) != -1) {
+    switch (c) {
+    case 'n':
+      size = atoi(optarg);
+      break;
+    case 's':
+      socket_size = atoi(optarg);
+      break;
+    case 'k':
+      kernel_file = optarg;
+      break;
+    case 'h':
+      show_usage();
+      exit(0);
+      break;
+    default:
+      show_usage();
+      exit(-1);
+    }
+  }
+}
+
+void cleanup() {
+  if (device) {
+    vx_mem_free(src_buffer);
+    vx_mem_free(dst_buffer);
+    vx_mem_free(krnl_buffer);
+    vx_mem_free(args_buffer);
+    vx_dev_close(device);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  parse_args(argc, argv);
+
+  std::srand(50);
+
+  std::cout << "open device connection" << std::endl;
+  RT_CHECK(vx_dev_open(&device));
+
+  uint64_t num_cores, local_mem_size;
+  RT_CHECK(vx_dev_caps(device, VX_CAPS_NUM_CORES, &num_cores));
+  RT_CHECK(vx_dev_caps(device, VX_CAPS_LOCAL_MEM_SIZE, &local_mem_size));
+  if (socket_size == 0) {
+    // default socket size of the hardware configuration
+    socket_size = std::min<uint32_t>(4, num_cores);
+  }
+  if (socket_size < 2) {
+    std::cout << "Error: this test requires at least 2 cores per socket!" << std::endl;
+    cleanup();
+    return -1;
+  }
+
+  uint32_t num_points = size;
+  uint32_t tile_size = num_points * sizeof(TYPE);
+  uint32_t num_sockets = (num_cores + socket_size - 1) / socket_size;
+  if (tile_size > local_mem_size) {
+    std::cout << "Error: tile size exceeds the local memory size!" << std::endl;
+    cleanup();
+    return -1;
+  }
+
+  std::cout << "number of points: " << num_points << std::endl;
+  std::cout << "number of cores: " << num_cores << ", socket size: " << socket_size << std::endl;
+
+  kernel_arg.num_points = num_points;
+  kernel_arg.socket_size = socket_size;
+
+  // allocate device memory
+  std::cout << "allocate device memory" << std::endl;
+  RT_CHECK(vx_mem_alloc(device, num_sockets * tile_size, VX_MEM_READ, &src_buffer));
+  RT_CHECK(vx_mem_address(src_buffer, &kernel_arg.src_addr));
+  RT_CHECK(vx_mem_alloc(device, num_cores * tile_size, VX_MEM_WRITE, &dst_buffer));
+  RT_CHECK(vx_mem_address(dst_buffer, &kernel_arg.dst_addr));
+
+  std::cout << "dev_src=0x" << std::hex << kernel_arg.src_addr << std::endl;
+  std::cout << "dev_dst=0x" << std::hex << kernel_arg.dst_addr << std::dec << std::endl;
+
+  // allocate host buffers
+  std::cout << "allocate host buffers" << std::endl;
+  std::vector<TYPE> h_src(num_sockets * num_points);
+  std::vector<TYPE> h_dst(num_cores * num_points);
+
+  for (auto& value : h_src) {
+    value = std::rand();
+  }
+
+  // upload source buffer
+  std::cout << "upload source buffer" << std::endl;
+  RT_CHECK(vx_copy_to_dev(src_buffer, h_src.data(), 0, h_src.size() * sizeof(TYPE)));
+
+  // Upload kernel binary
+  std::cout << "upload kernel binary" << std::endl;
+  RT_CHECK(vx_upload_kernel_file(device, kernel_file, &krnl_buffer));
+
+  // upload kernel argument
+  std::cout << "upload kernel argument" << std::endl;
+  RT_CHECK(vx_upload_bytes(device, &kernel_arg, sizeof(kernel_arg_t), &args_buffer));
+
+  // start device
+  std::cout << "start device" << std::endl;
+  RT_CHECK(vx_start(device, krnl_buffer, args_buffer));
+
+  // wait for completion
+  std::cout << "wait for completion" << std::endl;
+  RT_CHECK(vx_ready_wait(device, VX_MAX_TIMEOUT));
+
+  // download destination buffer
+  std::cout << "download destination buffer" << std::endl;
+  RT_CHECK(vx_copy_from_dev(h_dst.data(), dst_buffer, 0, h_dst.size() * sizeof(TYPE)));
+
+  // verify result: every core holds its socket's tile
+  std::cout << "verify result" << std::endl;
+  int errors = 0;
+  for (uint32_t c = 0; c < num_cores; ++c) {
+    uint32_t s = c / socket_size;
+    for (uint32_t i = 0; i < num_points; ++i) {
+      auto ref = h_src[s * num_points + i];
+      auto cur = h_dst[c * num_points + i];
+      if (cur != ref) {
+        if (errors < 10) {
+          printf("*** error: core%d [%d] expected=%d, actual=%d\n", c, i, ref, cur);
+        }
+        ++errors;
+      }
+    }
+  }
+
+  // each tile is read once and written to the other cores of its socket
+  std::cout << "expected multicast bytes: " << (num_cores - num_sockets) * tile_size << std::endl;
+
+  // cleanup
+  std::cout << "cleanup" << std::endl;
+  cleanup();
+
+  if (errors != 0) {
+    std::cout << "Found " << std::dec << errors << " errors!" << std::endl;
+    std::cout << "FAILED!" << std::endl;
+    return 1;
+  }
+
+  std::cout << "PASSED!" << std::endl;
+
+  return 0;
+}
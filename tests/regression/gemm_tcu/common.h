@@ -0,0 +1,52 @@
+#ifndef _COMMON_H_
+#define _COMMON_H_
+
+#include <stdint.h>
+
+#ifndef NUM_THREADS
+#define NUM_THREADS 4
+#endif
+
+#ifndef ITYPE
+#define ITYPE fp16
+#endif
+
+#ifndef OTYPE
+#define OTYPE fp32
+#endif
+
+// work group tiling (see ci/tcu_autotune.py)
+#ifndef WARPS_M
+#define WARPS_M 2
+#endif
+
+#ifndef WARPS_N
+#define WARPS_N 2
+#endif
+
+#ifndef TILES_K
+#define TILES_K 1
+#endif
+
+enum {
+  OP_GEMM = 0,
+  OP_GEMM_BATCHED,
+  OP_CONV2D
+};
+
+typedef struct {
+  uint32_t grid_dim[3];
+  uint32_t block_dim[3];
+  uint32_t op;
+  uint32_t M, N, K;
+  uint32_t batch;
+  // convolution shape (OP_CONV2D)
+  uint32_t in_h, in_w, channels;
+  uint32_t kernel_size, stride, pad;
+  uint32_t out_h, out_w;
+  uint64_t A_addr;
+  uint64_t B_addr;
+  uint64_t C_addr;
+} kernel_arg_t;
+
+#endif
@@ -0,0 +1,47 @@
+#include "common.h"
+#include <vx_spawn.h>
+#include <vx_tensor_gemm.h>
+
+namespace vt = vortex::tensor;
+using gemm = vt::gemm_context<NUM_THREADS, vt::ITYPE, vt::OTYPE, WARPS_M, WARPS_N, TILES_K>;
+
+void kernel_body(kernel_arg_t *__UNIFORM__ arg) {
+  auto pA = reinterpret_cast<const gemm::input_t *>(arg->A_addr);
+  auto pB = reinterpret_cast<const gemm::input_t *>(arg->B_addr);
+  auto pC = reinterpret_cast<gemm::output_t *>(arg->C_addr);
+
+  uint32_t M = arg->M;
+  uint32_t N = arg->N;
+  uint32_t K = arg->K;
+
+  switch (arg->op) {
+  case OP_GEMM:
+    gemm::gemm(pA, K, pB, N, pC, N, K);
+    break;
+  case OP_GEMM_BATCHED:
+    gemm::gemm_batched(pA, K, M * K, pB, N, K * N, pC, N, M * N, K);
+    break;
+  case OP_CONV2D: {
+    vt::conv2d_desc_t desc;
+    desc.batch    = arg->batch;
+    desc.in_h     = arg->in_h;
+    desc.in_w     = arg->in_w;
+    desc.channels = arg->channels;
+    desc.filters  = N;
+    desc.kernel_h = arg->kernel_size;
+    desc.kernel_w = arg->kernel_size;
+    desc.out_h    = arg->out_h;
+    desc.out_w    = arg->out_w;
+    desc.stride   = arg->stride;
+    desc.pad      = arg->pad;
+    gemm::conv2d(pA, pB, pC, desc);
+  } break;
+  default:
+    break;
+  }
+}
+
+int main() {
+  auto arg = (kernel_arg_t *)csr_read(VX_CSR_MSCRATCH);
+  return vx_spawn_threads(3, arg->grid_dim, arg->block_dim, (vx_kernel_func_cb)kernel_body, arg);
+}
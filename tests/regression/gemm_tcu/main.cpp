@@ -0,0 +1,489 @@
+#include "common.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <rvfloats.h>
+#include <string.h>
+#include <tensor_cfg.h>
+#include <unistd.h>
+#include <util.h>
+#include <vector>
+#include <vortex.h>
+
+#define FLOAT_ULP 6
+#define MAX_ERRORS 100
+
+#define RT_CHECK(_expr)                                      \
+  do {                                                       \
+    int _ret = _expr;                                        \
+    if (0 == _ret)                                           \
+      break;                                                 \
+    printf("Error: '%s' returned %d!\n", #_expr, (int)_ret); \
+    cleanup();                                               \
+    exit(-1);                                                \
+  } while (false)
+
+using namespace vortex;
+namespace vt = tensor;
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename Type>
+class Comparator {};
+
+template <typename T>
+class IntComparator {
+public:
+  static T generate() {
+    return (T)rand();
+  }
+  static bool compare(T a, T b, int index, int errors) {
+    if (a != b) {
+      if (errors < MAX_ERRORS) {
+        printf("*** error: [%d] expected=0x%x, actual=0x%x\n", index, b, a);
+      }
+      return false;
+    }
+    return true;
+  }
+};
+
+template <> class Comparator<vt::int8>  : public IntComparator<int8_t> {};
+template <> class Comparator<vt::uint8> : public IntComparator<uint8_t> {};
+template <> class Comparator<vt::int32> : public IntComparator<int32_t> {};
+
+template <>
+class Comparator<vt::fp16> : public IntComparator<uint16_t> {
+public:
+  static uint16_t generate() {
+    auto fvalue = float(rand()) / RAND_MAX;
+    return rv_ftoh_s(bit_cast<uint32_t>(fvalue), 0, nullptr);
+  }
+};
+
+template <>
+class Comparator<vt::bf16> : public IntComparator<uint16_t> {
+public:
+  static uint16_t generate() {
+    auto fvalue = float(rand()) / RAND_MAX;
+    return rv_ftob_s(bit_cast<uint32_t>(fvalue), 0, nullptr);
+  }
+};
+
+// fp8 values are generated in [0, 1) directly from their encoding
+template <>
+class Comparator<vt::fp8> : public IntComparator<uint8_t> {
+public:
+  static uint8_t generate() {
+    return ((rand() % 7) << 3) | (rand() & 0x7); // E4M3: exponent < bias
+  }
+};
+
+template <>
+class Comparator<vt::bf8> : public IntComparator<uint8_t> {
+public:
+  static uint8_t generate() {
+    return ((rand() % 15) << 2) | (rand() & 0x3); // E5M2: exponent < bias
+  }
+};
+
+template <>
+class Comparator<vt::fp32> {
+public:
+  static bool compare(float a, float b, int index, int errors) {
+    union fi_t {
+      float f;
+      int32_t i;
+    };
+    fi_t fa, fb;
+    fa.f = a;
+    fb.f = b;
+    auto d = std::abs(fa.i - fb.i);
+    if (d > FLOAT_ULP) {
+      if (errors < MAX_ERRORS) {
+        printf("*** error: [%d] expected=%f, actual=%f\n", index, fb.f, fa.f);
+      }
+      return false;
+    }
+    return true;
+  }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+// input element as a float
+template <typename T>
+struct to_float_t {};
+
+template <>
+struct to_float_t<vt::fp16> {
+  static float eval(uint16_t x) { return bit_cast<float>(rv_htof_s(x, 0, nullptr)); }
+};
+
+template <>
+struct to_float_t<vt::bf16> {
+  static float eval(uint16_t x) { return bit_cast<float>(rv_btof_s(x, 0, nullptr)); }
+};
+
+template <>
+struct to_float_t<vt::fp8> {
+  static float eval(uint8_t x) {
+    uint32_t exp = (x >> 3) & 0xf;
+    uint32_t man = x & 0x7;
+    float value;
+    if (exp == 0xf && man == 0x7) {
+      value = NAN;
+    } else if (exp == 0) {
+      value = std::ldexp(float(man), -9);
+    } else {
+      value = std::ldexp(float(8 + man), int(exp) - 10);
+    }
+    return (x & 0x80) ? -value : value;
+  }
+};
+
+template <>
+struct to_float_t<vt::bf8> {
+  static float eval(uint8_t x) { return bit_cast<float>(rv_htof_s(uint16_t(x) << 8, 0, nullptr)); }
+};
+
+template <typename S, typename D>
+struct muladd_t {
+  using stype = typename S::dtype;
+  using dtype = typename D::dtype;
+  static dtype eval(stype a, stype b, dtype c) {
+    return static_cast<dtype>(a) * static_cast<dtype>(b) + c;
+  }
+};
+
+template <typename S>
+struct muladd_t<S, vt::fp32> {
+  using stype = typename S::dtype;
+  static float eval(stype a, stype b, float c) {
+    return to_float_t<S>::eval(a) * to_float_t<S>::eval(b) + c;
+  }
+};
+
+template <>
+struct muladd_t<vt::fp16, vt::fp16> {
+  static uint16_t eval(uint16_t a, uint16_t b, uint16_t c) {
+    auto fd = to_float_t<vt::fp16>::eval(a) * to_float_t<vt::fp16>::eval(b) + to_float_t<vt::fp16>::eval(c);
+    return rv_ftoh_s(bit_cast<uint32_t>(fd), 0, nullptr);
+  }
+};
+
+template <>
+struct muladd_t<vt::bf16, vt::bf16> {
+  static uint16_t eval(uint16_t a, uint16_t b, uint16_t c) {
+    auto fd = to_float_t<vt::bf16>::eval(a) * to_float_t<vt::bf16>::eval(b) + to_float_t<vt::bf16>::eval(c);
+    return rv_ftob_s(bit_cast<uint32_t>(fd), 0, nullptr);
+  }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+using cfg = vt::gemm_config_t<NUM_THREADS, vt::ITYPE, vt::OTYPE, WARPS_M, WARPS_N, TILES_K>;
+
+using itype_t = typename vt::ITYPE::dtype;
+using otype_t = typename vt::OTYPE::dtype;
+
+static void matmul_cpu(otype_t *C, const itype_t *A, const itype_t *B, uint32_t M, uint32_t N, uint32_t K) {
+  for (uint32_t m = 0; m < M; ++m) {
+    for (uint32_t n = 0; n < N; ++n) {
+      otype_t sum(0);
+      for (uint32_t k = 0; k < K; ++k) {
+        sum = muladd_t<vt::ITYPE, vt::OTYPE>::eval(A[m * K + k], B[k * N + n], sum);
+      }
+      C[m * N + n] = sum;
+    }
+  }
+}
+
+// NHWC input to (N*P*Q) x (R*S*C) rows, in the kernel's K order
+static void im2col_cpu(itype_t *A, const itype_t *I, const kernel_arg_t &arg) {
+  uint32_t R = arg.kernel_size, S = arg.kernel_size, C = arg.channels;
+  uint32_t row = 0;
+  for (uint32_t n = 0; n < arg.batch; ++n) {
+    for (uint32_t p = 0; p < arg.out_h; ++p) {
+      for (uint32_t q = 0; q < arg.out_w; ++q, ++row) {
+        for (uint32_t r = 0; r < R; ++r) {
+          for (uint32_t s = 0; s < S; ++s) {
+            int32_t y = int32_t(p * arg.stride + r) - int32_t(arg.pad);
+            int32_t x = int32_t(q * arg.stride + s) - int32_t(arg.pad);
+            bool inside = (y >= 0 && y < int32_t(arg.in_h) && x >= 0 && x < int32_t(arg.in_w));
+            for (uint32_t c = 0; c < C; ++c) {
+              auto& dst = A[row * (R * S * C) + (r * S + s) * C + c];
+              dst = inside ? I[((n * arg.in_h + y) * arg.in_w + x) * C + c] : itype_t(0);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const char *kernel_file = "kernel.vxbin";
+
+uint32_t op = OP_GEMM;
+uint32_t xm = 64;
+uint32_t xn = 64;
+uint32_t xk = 64;
+uint32_t xbatch = 2;
+uint32_t xin_size = 8;
+uint32_t xchannels = 16;
+uint32_t xkernel_size = 3;
+uint32_t xstride = 1;
+uint32_t xpad = 1;
+
+vx_device_h device = nullptr;
+vx_buffer_h A_buffer = nullptr;
+vx_buffer_h B_buffer = nullptr;
+vx_buffer_h C_buffer = nullptr;
+vx_buffer_h krnl_buffer = nullptr;
+vx_buffer_h args_buffer = nullptr;
+kernel_arg_t kernel_arg = {};
+
+static void show_usage() {
+  std::cout << "Vortex Tensor GEMM Library Test." << std::endl;
+  std::cout << "Usage: [-t gemm|batched|conv] [-m M] [-n N] [-k K] [-b batch] [-h: help]" << std::endl;
+  std::cout << "  conv: [-x input size] [-c channels] [-r kernel size] [-s stride] [-p pad], -n filters" << std::endl;
+}
+
+static void parse_args(int argc, char **argv) {
+  int c;
+  while ((c = getopt(argc, argv, "t:m:n:k:b:x:c:r:s:p:h")) != -1) {
+    switch (c) {
+    case 't':
+      if (strcmp(optarg, "gemm") == 0) {
+        op = OP_GEMM;
+      } else if (strcmp(optarg, "batched") == 0) {
+        op = OP_GEMM_BATCHED;
+      } else if (strcmp(optarg, "conv") == 0) {
+        op = OP_CONV2D;
+      } else {
+        show_usage();
+        exit(-1);
+      }
+      break;
+    case 'm':
+      xm = atoi(optarg);
+      break;
+    case 'n':
+      xn = atoi(optarg);
+      break;
+    case 'k':
+      xk = atoi(optarg);
+      break;
+    case 'b':
+      xbatch = atoi(optarg);
+      break;
+    case 'x':
+      xin_size = atoi(optarg);
+      break;
+    case 'c':
+      xchannels = atoi(optarg);
+      break;
+    case 'r':
+      xkernel_size = atoi(optarg);
+      break;
+    case 's':
+      xstride = atoi(optarg);
+      break;
+    case 'p':
+      xpad = atoi(optarg);
+      break;
+    case 'h':
+      show_usage();
+      exit(0);
+      break;
+    default:
+      show_usage();
+      exit(-1);
+    }
+  }
+}
+
+void cleanup() {
+  if (device) {
+    vx_mem_free(A_buffer);
+    vx_mem_free(B_buffer);
+    vx_mem_free(C_buffer);
+    vx_mem_free(krnl_buffer);
+    vx_mem_free(args_buffer);
+    vx_dev_close(device);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  // parse command arguments
+  parse_args(argc, argv);
+
+  std::srand(50);
+
+  // problem shape as a GEMM
+  uint32_t M = xm, N = xn, K = xk, batch = 1;
+  kernel_arg.op = op;
+  if (op == OP_GEMM_BATCHED) {
+    batch = xbatch;
+  } else if (op == OP_CONV2D) {
+    kernel_arg.batch       = xbatch;
+    kernel_arg.in_h        = xin_size;
+    kernel_arg.in_w        = xin_size;
+    kernel_arg.channels    = xchannels;
+    kernel_arg.kernel_size = xkernel_size;
+    kernel_arg.stride      = xstride;
+    kernel_arg.pad         = xpad;
+    kernel_arg.out_h       = (xin_size + 2 * xpad - xkernel_size) / xstride + 1;
+    kernel_arg.out_w       = kernel_arg.out_h;
+    M = xbatch * kernel_arg.out_h * kernel_arg.out_w;
+    K = xkernel_size * xkernel_size * xchannels;
+    if ((xchannels * sizeof(itype_t)) % 4 != 0) {
+      std::cout << "Error: channels must fill whole 32-bit words!" << std::endl;
+      return -1;
+    }
+  }
+
+  if ((M % cfg::blockM) != 0 || (N % cfg::blockN) != 0 || (K % cfg::blockK) != 0) {
+    std::cout << "Error: problem " << M << "x" << N << "x" << K << " must be a multiple of the block "
+              << cfg::blockM << "x" << cfg::blockN << "x" << cfg::blockK << "!" << std::endl;
+    return -1;
+  }
+
+  // open device connection
+  std::cout << "open device connection" << std::endl;
+  RT_CHECK(vx_dev_open(&device));
+
+  uint64_t isa_flags;
+  RT_CHECK(vx_dev_caps(device, VX_CAPS_ISA_FLAGS, &isa_flags));
+  if ((isa_flags & VX_ISA_EXT_TCU) == 0) {
+    std::cout << "TCU extension not supported!" << std::endl;
+    cleanup();
+    return -1;
+  }
+
+  uint64_t NT;
+  RT_CHECK(vx_dev_caps(device, VX_CAPS_NUM_THREADS, &NT));
+  if (NT != NUM_THREADS) {
+    std::cout << "Error: device warp size (" << NT << ") must match NUM_THREADS=" << NUM_THREADS << "!" << std::endl;
+    cleanup();
+    return -1;
+  }
+
+  const char* op_names[] = {"gemm", "batched gemm", "conv2d"};
+  std::cout << "operation: " << op_names[op] << std::endl;
+  std::cout << "input data type: " << vt::ITYPE::name << std::endl;
+  std::cout << "output data type: " << vt::OTYPE::name << std::endl;
+  std::cout << "GEMM shape: M=" << M << ", N=" << N << ", K=" << K << ", batch=" << batch << std::endl;
+  std::cout << "block tile: M=" << cfg::blockM << ", N=" << cfg::blockN << ", K=" << cfg::blockK
+            << " (" << WARPS_M << "x" << WARPS_N << " warps)" << std::endl;
+  std::cout << "local memory: " << cfg::local_mem_size << " bytes" << std::endl;
+
+  kernel_arg.grid_dim[0]  = N / cfg::blockN;
+  kernel_arg.grid_dim[1]  = M / cfg::blockM;
+  kernel_arg.grid_dim[2]  = batch;
+  kernel_arg.block_dim[0] = cfg::group_size;
+  kernel_arg.block_dim[1] = 1;
+  kernel_arg.block_dim[2] = 1;
+  kernel_arg.M = M;
+  kernel_arg.N = N;
+  kernel_arg.K = K;
+
+  // check work group occupancy
+  uint32_t max_localmem;
+  RT_CHECK(vx_check_occupancy(device, cfg::group_size, &max_localmem));
+  std::cout << "occupancy: max_localmem=" << max_localmem << " bytes" << std::endl;
+  RT_CHECK(max_localmem < cfg::local_mem_size);
+
+  // generate source data
+  size_t sizeA, sizeB = size_t(K) * N * batch, sizeC = size_t(M) * N * batch;
+  std::vector<itype_t> h_A, h_B(sizeB), h_Aref;
+  if (op == OP_CONV2D) {
+    sizeA = size_t(xbatch) * xin_size * xin_size * xchannels;
+    h_A.resize(sizeA);
+    for (auto& v : h_A) v = Comparator<vt::ITYPE>::generate();
+    h_Aref.resize(size_t(M) * K);
+    im2col_cpu(h_Aref.data(), h_A.data(), kernel_arg);
+  } else {
+    sizeA = size_t(M) * K * batch;
+    h_A.resize(sizeA);
+    for (auto& v : h_A) v = Comparator<vt::ITYPE>::generate();
+  }
+  for (auto& v : h_B) v = Comparator<vt::ITYPE>::generate();
+
+  // allocate device memory
+  std::cout << "allocate device memory" << std::endl;
+  RT_CHECK(vx_mem_alloc(device, sizeA * sizeof(itype_t), VX_MEM_READ, &A_buffer));
+  RT_CHECK(vx_mem_address(A_buffer, &kernel_arg.A_addr));
+  RT_CHECK(vx_mem_alloc(device, sizeB * sizeof(itype_t), VX_MEM_READ, &B_buffer));
+  RT_CHECK(vx_mem_address(B_buffer, &kernel_arg.B_addr));
+  RT_CHECK(vx_mem_alloc(device, sizeC * sizeof(otype_t), VX_MEM_WRITE, &C_buffer));
+  RT_CHECK(vx_mem_address(C_buffer, &kernel_arg.C_addr));
+
+  std::cout << "A_addr=0x" << std::hex << kernel_arg.A_addr << std::endl;
+  std::cout << "B_addr=0x" << std::hex << kernel_arg.B_addr << std::endl;
+  std::cout << "C_addr=0x" << std::hex << kernel_arg.C_addr << std::dec << std::endl;
+
+  // upload source buffers
+  std::cout << "upload source buffers" << std::endl;
+  RT_CHECK(vx_copy_to_dev(A_buffer, h_A.data(), 0, sizeA * sizeof(itype_t)));
+  RT_CHECK(vx_copy_to_dev(B_buffer, h_B.data(), 0, sizeB * sizeof(itype_t)));
+
+  // upload program
+  std::cout << "upload program" << std::endl;
+  RT_CHECK(vx_upload_kernel_file(device, kernel_file, &krnl_buffer));
+
+  // upload kernel argument
+  std::cout << "upload kernel argument" << std::endl;
+  RT_CHECK(vx_upload_bytes(device, &kernel_arg, sizeof(kernel_arg_t), &args_buffer));
+
+  auto time_start = std::chrono::high_resolution_clock::now();
+
+  // start device
+  std::cout << "start device" << std::endl;
+  RT_CHECK(vx_start(device, krnl_buffer, args_buffer));
+
+  // wait for completion
+  std::cout << "wait for completion" << std::endl;
+  RT_CHECK(vx_ready_wait(device, VX_MAX_TIMEOUT));
+
+  auto time_end = std::chrono::high_resolution_clock::now();
+  double elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(time_end - time_start).count();
+  printf("Elapsed time: %lg ms\n", elapsed);
+
+  // download destination buffer
+  std::vector<otype_t> h_C(sizeC);
+  std::cout << "download destination buffer" << std::endl;
+  RT_CHECK(vx_copy_from_dev(h_C.data(), C_buffer, 0, sizeC * sizeof(otype_t)));
+
+  // verify result
+  std::cout << "verify result" << std::endl;
+  int errors = 0;
+  {
+    std::vector<otype_t> h_ref(sizeC);
+    auto A_ref = (op == OP_CONV2D) ? h_Aref.data() : h_A.data();
+    for (uint32_t b = 0; b < batch; ++b) {
+      matmul_cpu(h_ref.data() + b * M * N, A_ref + b * M * K, h_B.data() + b * K * N, M, N, K);
+    }
+    for (uint32_t i = 0; i < h_ref.size(); ++i) {
+      if (!Comparator<vt::OTYPE>::compare(h_C[i], h_ref[i], i, errors)) {
+        ++errors;
+      }
+    }
+  }
+
+  // cleanup
+  std::cout << "cleanup" << std::endl;
+  cleanup();
+
+  if (errors != 0) {
+    std::cout << "Found " << std::dec << errors << " / " << sizeC << " errors!" << std::endl;
+    std::cout << "FAILED!" << std::endl;
+    return errors;
+  }
+
+  std::cout << "PASSED!" << std::endl;
+
+  return 0;
+}
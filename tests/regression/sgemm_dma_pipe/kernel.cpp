@@ -0,0 +1,72 @@
+/**
+ * SGEMM with a pipelined DMA tile loader
+ *
+ * The A and B tiles of step k+1 are transferred by the DMA engine while the
+ * tiles of step k are multiplied. Running with -s1 serializes loads and
+ * compute, which gives the baseline to compare cycle counts against.
+ */
+
+#include <vx_spawn.h>
+#include <vx_dma_pipeline.h>
+#include "common.h"
+
+template <uint32_t Stages>
+static void sgemm_pipelined(kernel_arg_t *arg) {
+  using pipeline_t = vortex::dma::pipeline<TYPE, Stages>;
+
+  auto A_ptr = reinterpret_cast<const TYPE*>(arg->A_addr);
+  auto B_ptr = reinterpret_cast<const TYPE*>(arg->B_addr);
+  auto C_ptr = reinterpret_cast<TYPE*>(arg->C_addr);
+
+  auto size = arg->size;
+  auto tile_size = arg->tile_size;
+  auto tile_elems = tile_size * tile_size;
+
+  // each stage holds a tile of A followed by a tile of B
+  auto local_ptr = (TYPE*)__local_mem(Stages * 2 * tile_elems * sizeof(TYPE));
+
+  // work groups sharing a core use separate completion groups when they fit
+  constexpr uint32_t group_slots = vortex::dma::num_groups / Stages;
+  bool leader = (threadIdx.x == 0 && threadIdx.y == 0);
+  pipeline_t pipe(local_ptr, 2 * tile_elems, leader, (__local_group_id % group_slots) * Stages);
+
+  // Determine global row and column indices
+  auto g_row = blockIdx.x * tile_size + threadIdx.x;
+  auto g_col = blockIdx.y * tile_size + threadIdx.y;
+
+  // Determine local row and column indices
+  auto l_row = threadIdx.x;
+  auto l_col = threadIdx.y;
+
+  TYPE sum(0);
+
+  vortex::dma::for_each_tile(pipe, size / tile_size,
+    [&](uint32_t step) {
+      uint32_t k = step * tile_size;
+      pipe.load_2d(step, 0, A_ptr + blockIdx.x * tile_size * size + k, size, tile_size, tile_size);
+      pipe.load_2d(step, tile_elems, B_ptr + k * size + blockIdx.y * tile_size, size, tile_size, tile_size);
+    },
+    [&](uint32_t step) {
+      auto local_A = pipe.stage(step);
+      auto local_B = local_A + tile_elems;
+      for (uint32_t j = 0; j < tile_size; ++j) {
+        sum += local_A[l_row * tile_size + j] * local_B[j * tile_size + l_col];
+      }
+    });
+
+  // Store the computed sum into the result matrix C
+  C_ptr[g_row * size + g_col] = sum;
+}
+
+void kernel_body(kernel_arg_t *arg) {
+  switch (arg->stages) {
+  case 1: sgemm_pipelined<1>(arg); break;
+  case 2: sgemm_pipelined<2>(arg); break;
+  default: sgemm_pipelined<3>(arg); break;
+  }
+}
+
+int main() {
+  auto arg = (kernel_arg_t*)csr_read(VX_CSR_MSCRATCH);
+  return vx_spawn_threads(2, arg->grid_dim, arg->block_dim, (vx_kernel_func_cb)kernel_body, arg);
+}
@@ -22,6 +22,8 @@ typedef struct {
   uint64_t A_addr;
   uint64_t B_addr;
   uint64_t C_addr;
+  uint64_t meta_addr; // 2:4 sparse A metadata (A_addr holds the kept values)
+  uint32_t sparse;
 } kernel_arg_t;
 
 #endif
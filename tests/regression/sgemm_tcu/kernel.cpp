@@ -5,16 +5,18 @@
 namespace vt = vortex::tensor;
 using ctx = vt::wmma_context<NUM_THREADS, vt::ITYPE, vt::OTYPE>;
 
-void kernel_body(kernel_arg_t *__UNIFORM__ arg) {
+template <bool Sparse>
+void gemm_tile(kernel_arg_t *__UNIFORM__ arg) {
   auto pA = reinterpret_cast<ctx::input_t *>(arg->A_addr);
   auto pB = reinterpret_cast<ctx::input_t *>(arg->B_addr);
   auto pC = reinterpret_cast<ctx::output_t *>(arg->C_addr);
+  auto pMeta = reinterpret_cast<const uint8_t *>(arg->meta_addr);
 
   uint32_t M = arg->M;
   uint32_t N = arg->N;
   uint32_t K = arg->K;
 
-  ctx::fragment_a   fragA;
+  std::conditional_t<Sparse, ctx::fragment_a_sp, ctx::fragment_a> fragA;
   ctx::fragment_b   fragB;
   ctx::fragment_acc fragC;
 
@@ -26,10 +28,16 @@ void kernel_body(kernel_arg_t *__UNIFORM__ arg) {
   ctx::fill_fragment(fragC, 0);
 
   for (int i = 0; i < K; i += ctx::tileK) {
-    auto pTileA = pA + tile_row * K + i;
-
     // Load A tile
-    ctx::load_matrix_sync(fragA, pTileA, K);
+    if constexpr (Sparse) {
+      // compressed rows hold K/2 values and K/8 metadata bytes
+      auto pTileA = pA + tile_row * (K / 2) + i / 2;
+      auto pTileMeta = pMeta + tile_row * (K / 8) + i / 8;
+      ctx::load_matrix_sync(fragA, pTileA, pTileMeta, K);
+    } else {
+      auto pTileA = pA + tile_row * K + i;
+      ctx::load_matrix_sync(fragA, pTileA, K);
+    }
 
     // Load B tile
     if constexpr (vt::ITYPE::bits < 8) {
@@ -50,6 +58,16 @@ void kernel_body(kernel_arg_t *__UNIFORM__ arg) {
   ctx::store_matrix_sync(pTileC, fragC, N);
 }
 
+void kernel_body(kernel_arg_t *__UNIFORM__ arg) {
+  if constexpr (ctx::sparse_support) {
+    if (arg->sparse) {
+      gemm_tile<true>(arg);
+      return;
+    }
+  }
+  gemm_tile<false>(arg);
+}
+
 int main() {
   auto arg = (kernel_arg_t *)csr_read(VX_CSR_MSCRATCH);
   return vx_spawn_threads(2, arg->grid_dim, arg->block_dim, (vx_kernel_func_cb)kernel_body, arg);
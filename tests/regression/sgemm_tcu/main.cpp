@@ -235,14 +235,31 @@ public:
   }
 };
 
+// fp8 values are generated in [0, 1) directly from their encoding
 template <>
-class Comparator<vt::tf32> {
+class Comparator<vt::fp8> {
 public:
-  static uint32_t generate() {
-    auto fvalue = float(rand()) / RAND_MAX;
-    return rv_ftox_s(bit_cast<uint32_t>(fvalue), 8, 10, 0, nullptr);
+  static uint8_t generate() {
+    return ((rand() % 7) << 3) | (rand() & 0x7); // E4M3: exponent < bias
   }
-  static bool compare(uint32_t a, uint32_t b, int index, int errors) {
+  static bool compare(uint8_t a, uint8_t b, int index, int errors) {
+    if (a != b) {
+      if (errors < MAX_ERRORS) {
+        printf("*** error: [%d] expected=0x%x, actual=0x%x\n", index, b, a);
+      }
+      return false;
+    }
+    return true;
+  }
+};
+
+template <>
+class Comparator<vt::bf8> {
+public:
+  static uint8_t generate() {
+    return ((rand() % 15) << 2) | (rand() & 0x3); // E5M2: exponent < bias
+  }
+  static bool compare(uint8_t a, uint8_t b, int index, int errors) {
     if (a != b) {
       if (errors < MAX_ERRORS) {
         printf("*** error: [%d] expected=0x%x, actual=0x%x\n", index, b, a);
@@ -329,11 +346,32 @@ struct muladd_t<vt::bf16, vt::bf16> {
   }
 };
 
+static float e4m3_to_float(uint8_t x) {
+  uint32_t exp = (x >> 3) & 0xf;
+  uint32_t man = x & 0x7;
+  float value;
+  if (exp == 0xf && man == 0x7) {
+    value = NAN;
+  } else if (exp == 0) {
+    value = std::ldexp(float(man), -9);
+  } else {
+    value = std::ldexp(float(8 + man), int(exp) - 10);
+  }
+  return (x & 0x80) ? -value : value;
+}
+
+template <>
+struct muladd_t<vt::fp8, vt::fp32> {
+  static float eval(uint8_t a, uint8_t b, float c) {
+    return e4m3_to_float(a) * e4m3_to_float(b) + c;
+  }
+};
+
 template <>
-struct muladd_t<vt::tf32, vt::fp32> {
-  static float eval(uint32_t a, uint32_t b, float c) {
-    auto fa = bit_cast<float>(rv_xtof_s(a, 8, 10, 0, nullptr));
-    auto fb = bit_cast<float>(rv_xtof_s(b, 8, 10, 0, nullptr));
+struct muladd_t<vt::bf8, vt::fp32> {
+  static float eval(uint8_t a, uint8_t b, float c) {
+    auto fa = bit_cast<float>(rv_htof_s(uint16_t(a) << 8, 0, nullptr));
+    auto fb = bit_cast<float>(rv_htof_s(uint16_t(b) << 8, 0, nullptr));
     return fa * fb + c;
   }
 };
@@ -362,6 +400,42 @@ struct muladd_t<vt::uint4, vt::int32> {
   }
 };
 
+// element magnitude, used to select the elements kept by 2:4 pruning
+template <typename T>
+struct magnitude_t {
+  static float eval(typename T::dtype value) {
+    return std::abs(float(value));
+  }
+};
+
+template <>
+struct magnitude_t<vt::fp16> {
+  static float eval(uint16_t value) {
+    return std::abs(bit_cast<float>(rv_htof_s(value, 0, nullptr)));
+  }
+};
+
+template <>
+struct magnitude_t<vt::bf16> {
+  static float eval(uint16_t value) {
+    return std::abs(bit_cast<float>(rv_btof_s(value, 0, nullptr)));
+  }
+};
+
+template <>
+struct magnitude_t<vt::fp8> {
+  static float eval(uint8_t value) {
+    return std::abs(e4m3_to_float(value));
+  }
+};
+
+template <>
+struct magnitude_t<vt::bf8> {
+  static float eval(uint8_t value) {
+    return std::abs(bit_cast<float>(rv_htof_s(uint16_t(value) << 8, 0, nullptr)));
+  }
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 using cfg = vt::wmma_config_t<NUM_THREADS, vt::ITYPE, vt::OTYPE>;
@@ -369,12 +443,14 @@ using cfg = vt::wmma_config_t<NUM_THREADS, vt::ITYPE, vt::OTYPE>;
 using itype_t = typename vt::ITYPE::dtype;
 using otype_t = typename vt::OTYPE::dtype;
 
-struct SparseMat {
-  std::vector<itype_t> values;   // non-zeros
-  std::vector<uint8_t> meta;     // Array of row-masks: 1 byte marks the columns
-                                  // of the 4 elements in the block that are non-zero.
-                                  // e.g. 0b0101 means 2nd and 4th elements are non-zero.
+// 2:4 sparse A supports byte-or-wider inputs and K steps in pairs (see vx_tensor.h)
+static constexpr bool sparse_support = (vt::ITYPE::bits >= 8) && (cfg::k_steps % 2) == 0
+                                    && ((2 * cfg::tcK * cfg::i_ratio) % 4) == 0;
 
+struct SparseMat {
+  std::vector<itype_t> values;   // 2 kept elements per group of 4, in index order (cols / 2 per row)
+  std::vector<uint8_t> meta;     // one nibble per group: idx0 in bits [1:0], idx1 in bits [3:2],
+                                 // even groups in the low nibble (cols / 8 bytes per row)
   uint32_t rows, cols;           // original A dims (M × K)
 };
 
@@ -406,6 +482,7 @@ vx_device_h device = nullptr;
 vx_buffer_h A_buffer = nullptr;
 vx_buffer_h B_buffer = nullptr;
 vx_buffer_h C_buffer = nullptr;
+vx_buffer_h meta_buffer = nullptr;
 vx_buffer_h krnl_buffer = nullptr;
 vx_buffer_h args_buffer = nullptr;
 kernel_arg_t kernel_arg = {};
@@ -415,7 +492,7 @@ std::string last_build_options;
 static void show_usage() {
   std::cout << "Vortex Sgemm TCU Test." << std::endl;
   std::cout << "Usage: [-m: m] [-n N] [-k: K] [-s] [-h: help]" << std::endl;
-  std::cout << "  -s  Enable 2:4 structured sparsity " << std::endl;
+  std::cout << "  -s  Enable 2:4 structured sparsity of matrix A" << std::endl;
 }
 
 static void parse_args(int argc, char **argv) {
@@ -451,6 +528,7 @@ void cleanup() {
     vx_mem_free(A_buffer);
     vx_mem_free(B_buffer);
     vx_mem_free(C_buffer);
+    vx_mem_free(meta_buffer);
     vx_mem_free(krnl_buffer);
     vx_mem_free(args_buffer);
     vx_dev_close(device);
@@ -458,61 +536,70 @@ void cleanup() {
 }
 
 
+// keep the 2 largest-magnitude elements of every group of 4
+template <typename T>
 static SparseMat pruneAndCompressMatrixA(const std::vector<itype_t>& denseA,
                                          uint32_t M, uint32_t K) {
   SparseMat out;
   out.rows = M;
   out.cols = K;
-  out.values.reserve(M * K / 2); // Select 2 values every 4 values
-  out.meta.reserve(M * K / 4); // 1 byte for every 4 values
+  out.values.reserve(M * K / 2);
+  out.meta.assign(M * K / 8, 0);
 
   const itype_t* src = denseA.data();
 
   for (uint32_t r = 0; r < M; ++r) {
     for (uint32_t c = 0; c < K; c += 4) {
-      itype_t blk[4] = {src[r * K + c],
-                        src[r * K + c + 1],
-                        src[r * K + c + 2],
-                        src[r * K + c + 3]};
+      const itype_t* blk = src + r * K + c;
 
       uint32_t idx[4] = {0, 1, 2, 3};
-      std::sort(idx, idx + 4,
+      std::stable_sort(idx, idx + 4,
         [&](uint32_t a, uint32_t b) {
-          return std::abs((int)blk[a]) < std::abs((int)blk[b]);
-        }); //Sort the 4 elements by absolute value, ascending order
+          return magnitude_t<T>::eval(blk[a]) > magnitude_t<T>::eval(blk[b]);
+        }); // sort the 4 elements by magnitude, descending order
 
-      uint8_t keep0 = idx[3];
-      uint8_t keep1 = idx[2]; //idx of largest 2 elements
+      uint32_t keep0 = std::min(idx[0], idx[1]);
+      uint32_t keep1 = std::max(idx[0], idx[1]);
 
       out.values.push_back(blk[keep0]);
       out.values.push_back(blk[keep1]);
 
-      uint8_t m = (1u << keep0) | (1u << keep1);  // e.g. 0b0101
-      out.meta.push_back(m);
+      uint32_t g = (r * K + c) / 4;
+      out.meta.at(g / 2) |= (keep0 | (keep1 << 2)) << ((g % 2) * 4);
     }
   }
   return out;
 }
 
-void test_pruneA() {
+// dense matrix with the pruned elements set to zero
+static std::vector<itype_t> decompressMatrixA(const SparseMat& spA) {
+  std::vector<itype_t> denseA(spA.rows * spA.cols, itype_t(0));
+  for (uint32_t g = 0; g < spA.rows * spA.cols / 4; ++g) {
+    uint32_t nibble = (spA.meta.at(g / 2) >> ((g % 2) * 4)) & 0xf;
+    denseA.at(4 * g + (nibble & 0x3)) = spA.values.at(2 * g);
+    denseA.at(4 * g + (nibble >> 2)) = spA.values.at(2 * g + 1);
+  }
+  return denseA;
+}
+
+template <typename T>
+static void test_pruneA() {
   const uint32_t M = 4, K = 8;
   std::vector<itype_t> denseA(M * K);
-  for (auto& v : denseA) v = Comparator<vt::ITYPE>::generate();
+  for (auto& v : denseA) v = Comparator<T>::generate();
 
-  auto spA = pruneAndCompressMatrixA(denseA, M, K);
+  auto spA = pruneAndCompressMatrixA<T>(denseA, M, K);
+  auto recovered = decompressMatrixA(spA);
 
-  std::vector<itype_t> recovered(M * K, 0);
-  size_t v_idx = 0, m_idx = 0;
-  for (uint32_t r = 0; r < M; ++r)
-    for (uint32_t c = 0; c < K; c += 4) {
-      uint8_t m = spA.meta[m_idx++];
-      for (uint32_t i = 0; i < 4; ++i)
-        if (m & (1u << i))
-          recovered[r * K + c + i] = spA.values[v_idx++];
+  for (uint32_t g = 0; g < M * K / 4; ++g) {
+    uint32_t kept = 0;
+    for (uint32_t i = 4 * g; i < 4 * g + 4; ++i) {
+      assert(recovered[i] == denseA[i] || recovered[i] == itype_t(0)); // either the value is preserved or pruned
+      kept += (recovered[i] == denseA[i]);
     }
-
-  for (uint32_t i = 0; i < M * K; ++i)
-    assert(recovered[i] == denseA[i] || recovered[i] == 0); //Either the value is preserved or pruned
+    assert(kept >= 2);
+    (void)kept;
+  }
   std::cout << "pruneAndCompressMatrixA passed\n";
 }
 
@@ -521,8 +608,14 @@ int main(int argc, char *argv[]) {
   // parse command arguments
   parse_args(argc, argv);
 
-  if(g_enable_sparse) {
-    test_pruneA(); // Test the pruning function
+  if (g_enable_sparse) {
+    if constexpr (sparse_support) {
+      test_pruneA<vt::ITYPE>(); // Test the pruning function
+    } else {
+      std::cout << "Error: 2:4 sparsity is not supported for " << vt::ITYPE::name
+                << " with NUM_THREADS=" << NUM_THREADS << "!" << std::endl;
+      return -1;
+    }
   }
 
   std::srand(50);
@@ -588,11 +681,20 @@ int main(int argc, char *argv[]) {
   kernel_arg.M = M;
   kernel_arg.N = N;
   kernel_arg.K = K;
+  kernel_arg.sparse = g_enable_sparse;
+
+  // sparse A only stores the kept half of its elements
+  size_t sizeA_dev = g_enable_sparse ? (sizeA / 2) : sizeA;
+  size_t sizeMeta = sizeA / 8;
 
   // allocate device memory
   std::cout << "allocate device memory" << std::endl;
-  RT_CHECK(vx_mem_alloc(device, sizeA * sizeof(itype_t), VX_MEM_READ, &A_buffer));
+  RT_CHECK(vx_mem_alloc(device, sizeA_dev * sizeof(itype_t), VX_MEM_READ, &A_buffer));
   RT_CHECK(vx_mem_address(A_buffer, &kernel_arg.A_addr));
+  if (g_enable_sparse) {
+    RT_CHECK(vx_mem_alloc(device, sizeMeta, VX_MEM_READ, &meta_buffer));
+    RT_CHECK(vx_mem_address(meta_buffer, &kernel_arg.meta_addr));
+  }
   RT_CHECK(vx_mem_alloc(device, sizeB * sizeof(itype_t), VX_MEM_READ, &B_buffer));
   RT_CHECK(vx_mem_address(B_buffer, &kernel_arg.B_addr));
   RT_CHECK(vx_mem_alloc(device, sizeC * sizeof(otype_t), VX_MEM_WRITE, &C_buffer));
@@ -613,7 +715,17 @@ int main(int argc, char *argv[]) {
   }
 
   // upload matrix A buffer
-  {
+  if constexpr (sparse_support) {
+    if (g_enable_sparse) {
+      // the reference uses the pruned matrix
+      auto spA = pruneAndCompressMatrixA<vt::ITYPE>(h_A, M, K);
+      h_A = decompressMatrixA(spA);
+      std::cout << "upload sparse matrix A buffers" << std::endl;
+      RT_CHECK(vx_copy_to_dev(A_buffer, spA.values.data(), 0, sizeA_dev * sizeof(itype_t)));
+      RT_CHECK(vx_copy_to_dev(meta_buffer, spA.meta.data(), 0, sizeMeta));
+    }
+  }
+  if (!g_enable_sparse) {
     std::cout << "upload matrix A buffer" << std::endl;
     RT_CHECK(vx_copy_to_dev(A_buffer, h_A.data(), 0, sizeA * sizeof(itype_t)));
   }
@@ -0,0 +1,134 @@
+#include <cache_sim.h>
+#include <stdio.h>
+#include <deque>
+
+// Snoop invalidation of a line with a fill in flight: the fill carries data
+// older than the snooped write and must not be installed.
+
+#define CHECK(_cond)                                            \
+   do {                                                         \
+     if (_cond)                                                 \
+       break;                                                   \
+     printf("Error: '%s' failed!\n", #_cond);                   \
+     return -1;                                                 \
+   } while (false)
+
+using namespace vortex;
+
+static const uint32_t MEM_LATENCY = 20;
+static const uint64_t LINE_ADDR   = 0x1000;
+
+// fixed latency memory
+class Memory : public SimObject<Memory> {
+public:
+  SimPort<MemReq> ReqPort;
+  SimPort<MemRsp> RspPort;
+
+  Memory(const SimContext& ctx) : SimObject<Memory>(ctx, "memory"), ReqPort(this), RspPort(this) {}
+
+  void reset() {
+    pending_.clear();
+    fills = 0;
+  }
+
+  void tick() {
+    auto cycle = SimPlatform::instance().cycles();
+    if (!ReqPort.empty()) {
+      auto& mem_req = ReqPort.front();
+      if (!mem_req.write) {
+        pending_.push_back({cycle + MEM_LATENCY, mem_req.tag});
+        ++fills;
+      }
+      ReqPort.pop();
+    }
+    if (!pending_.empty() && pending_.front().first <= cycle) {
+      RspPort.push(MemRsp{pending_.front().second, 0, 0}, 1);
+      pending_.pop_front();
+    }
+  }
+
+  uint32_t fills;
+
+private:
+  std::deque<std::pair<uint64_t, uint32_t>> pending_;
+};
+
+// counts core responses
+class Requester : public SimObject<Requester> {
+public:
+  SimPort<MemRsp> RspPort;
+
+  Requester(const SimContext& ctx) : SimObject<Requester>(ctx, "requester"), RspPort(this) {}
+
+  void reset() {
+    responses = 0;
+  }
+
+  void tick() {
+    if (!RspPort.empty()) {
+      ++responses;
+      RspPort.pop();
+    }
+  }
+
+  uint32_t responses;
+};
+
+static void run(uint32_t cycles) {
+  for (uint32_t i = 0; i < cycles; ++i) {
+    SimPlatform::instance().tick();
+  }
+}
+
+int main() {
+  CacheSim::Config config{};
+  config.C = 12;
+  config.L = 6;
+  config.S = 6;
+  config.W = 2;
+  config.A = 2;
+  config.addr_width = 32;
+  config.num_inputs = 1;
+  config.mem_ports = 1;
+  config.write_back = true;
+  config.mshr_size = 4;
+  config.latency = 2;
+
+  auto cache = CacheSim::Create("cache", config);
+  auto memory = Memory::Create();
+  auto requester = Requester::Create();
+  cache->MemReqPorts.at(0).bind(&memory->ReqPort);
+  memory->RspPort.bind(&cache->MemRspPorts.at(0));
+  cache->CoreRspPorts.at(0).bind(&requester->RspPort);
+
+  SimPlatform::instance().reset();
+
+  MemReq core_req(LINE_ADDR, false, AddrType::Global, 1);
+  core_req.size = 4;
+
+  // read miss, then snoop the line while its fill is in flight
+  cache->CoreReqPorts.at(0).push(core_req, 1);
+  run(MEM_LATENCY + 5);
+  CHECK(memory->fills == 1);
+  MemReq snoop_req(LINE_ADDR, true);
+  snoop_req.size = 1 << config.L;
+  cache->SnoopPort.push(snoop_req, 1);
+
+  // the stale fill is dropped and the read is served by a new fill
+  run(3 * MEM_LATENCY);
+  CHECK(requester->responses == 1);
+  CHECK(memory->fills == 2);
+  CHECK(cache->perf_stats().snoop_invals == 1);
+
+  // the refetched line is installed
+  core_req.tag = 2;
+  cache->CoreReqPorts.at(0).push(core_req, 1);
+  run(2 * MEM_LATENCY);
+  CHECK(requester->responses == 2);
+  CHECK(memory->fills == 2);
+  CHECK(cache->mshr_size() == 0);
+
+  printf("PASSED!\n");
+
+  return 0;
+}